@@ -0,0 +1,155 @@
+/*
+ *  Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/util.h"
+#include "test/video_source.h"
+#include "vpx/vp8cx.h"
+#include "vpx/vp8dx.h"
+
+namespace {
+
+// Decoding modes: a single thread, 4 threads, and 4 threads with VP9 row-MT.
+enum { kSingleThread, kMultiThread, kRowMT };
+
+// Copies the rows of each frame as the put_slice callback reports them and
+// checks that they match the frame that is output once it is decoded.
+class DecodeSliceTest : public ::libvpx_test::EncoderTest,
+                        public ::libvpx_test::CodecTestWithParam<int> {
+ protected:
+  DecodeSliceTest()
+      : EncoderTest(GET_PARAM(0)), mode_(GET_PARAM(1)), rows_(0),
+        num_frames_(0), num_slices_(0) {
+    vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+    cfg.threads = (mode_ == kSingleThread) ? 1 : 4;
+    decoder_ = codec_->CreateDecoder(cfg, 0);
+    is_vp8_ = decoder_->IsVP8();
+    if (mode_ == kRowMT) decoder_->Control(VP9D_SET_ROW_MT, 1);
+    EXPECT_EQ(VPX_CODEC_OK,
+              decoder_->RegisterPutSliceCallback(PutSlice, this));
+  }
+
+  ~DecodeSliceTest() override { delete decoder_; }
+
+  void SetUp() override {
+    InitializeConfig();
+    SetMode(::libvpx_test::kRealTime);
+  }
+
+  void PreEncodeFrameHook(::libvpx_test::VideoSource *video,
+                          ::libvpx_test::Encoder *encoder) override {
+    if (video->frame() == 0) {
+      encoder->Control(VP8E_SET_CPUUSED, 7);
+      // Allow the threads to decode several rows or tiles at once.
+      if (is_vp8_) {
+        encoder->Control(VP8E_SET_TOKEN_PARTITIONS, 2);
+      } else {
+        encoder->Control(VP9E_SET_TILE_COLUMNS, 2);
+      }
+    }
+  }
+
+  // The decoder is run from FramePktHook().
+  bool DoDecode() const override { return false; }
+
+  static void PutSlice(void *user_priv, const vpx_image_t *img,
+                       const vpx_image_rect_t *valid,
+                       const vpx_image_rect_t *update) {
+    static_cast<DecodeSliceTest *>(user_priv)->CopySlice(img, valid, update);
+  }
+
+  void CopySlice(const vpx_image_t *img, const vpx_image_rect_t *valid,
+                 const vpx_image_rect_t *update) {
+    ++num_slices_;
+    EXPECT_EQ(0u, valid->x);
+    EXPECT_EQ(0u, valid->y);
+    EXPECT_EQ(img->d_w, valid->w);
+    EXPECT_EQ(valid->w, update->w);
+    // Slices follow each other down the frame.
+    EXPECT_EQ(rows_, update->y);
+    EXPECT_GT(update->h, 0u);
+    EXPECT_EQ(valid->h, update->y + update->h);
+    EXPECT_LE(valid->h, img->d_h);
+    rows_ = valid->h;
+
+    for (int plane = 0; plane < 3; ++plane) {
+      const int x_shift = plane ? img->x_chroma_shift : 0;
+      const int y_shift = plane ? img->y_chroma_shift : 0;
+      const int w = (img->d_w + x_shift) >> x_shift;
+      const int h = (img->d_h + y_shift) >> y_shift;
+      const int start = update->y >> y_shift;
+      const int end = (valid->h + y_shift) >> y_shift;
+      slices_[plane].resize(w * h);
+      for (int r = start; r < end; ++r) {
+        memcpy(&slices_[plane][r * w],
+               img->planes[plane] + r * img->stride[plane], w);
+      }
+    }
+  }
+
+  void FramePktHook(const vpx_codec_cx_pkt_t *pkt) override {
+    rows_ = 0;
+    const vpx_codec_err_t res = decoder_->DecodeFrame(
+        static_cast<const uint8_t *>(pkt->data.frame.buf), pkt->data.frame.sz);
+    ASSERT_EQ(VPX_CODEC_OK, res) << decoder_->DecodeError();
+    const vpx_image_t *const img = decoder_->GetDxData().Next();
+    ASSERT_NE(img, nullptr);
+    ++num_frames_;
+    ASSERT_EQ(img->d_h, rows_) << "Frame " << pkt->data.frame.pts
+                               << " was not reported in full.";
+
+    for (int plane = 0; plane < 3; ++plane) {
+      const int x_shift = plane ? img->x_chroma_shift : 0;
+      const int y_shift = plane ? img->y_chroma_shift : 0;
+      const int w = (img->d_w + x_shift) >> x_shift;
+      const int h = (img->d_h + y_shift) >> y_shift;
+      for (int r = 0; r < h; ++r) {
+        ASSERT_EQ(0, memcmp(&slices_[plane][r * w],
+                            img->planes[plane] + r * img->stride[plane], w))
+            << "Frame " << pkt->data.frame.pts << " plane " << plane
+            << " row " << r << " changed after it was reported.";
+      }
+    }
+  }
+
+  int mode_;
+  bool is_vp8_;
+  unsigned int rows_;
+  int num_frames_;
+  int num_slices_;
+  std::vector<uint8_t> slices_[3];
+  ::libvpx_test::Decoder *decoder_;
+};
+
+TEST_P(DecodeSliceTest, ReportsFinalRows) {
+  cfg_.g_lag_in_frames = 0;
+  cfg_.rc_target_bitrate = 800;
+  cfg_.rc_end_usage = VPX_CBR;
+
+  ::libvpx_test::RandomVideoSource video;
+  video.SetSize(704, 288);
+  video.set_limit(10);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  EXPECT_EQ(10, num_frames_);
+  // The frames are reported in more than one slice.
+  EXPECT_GT(num_slices_, 2 * num_frames_);
+}
+
+VP8_INSTANTIATE_TEST_SUITE(DecodeSliceTest,
+                           ::testing::Values(kSingleThread, kMultiThread));
+VP9_INSTANTIATE_TEST_SUITE(DecodeSliceTest,
+                           ::testing::Values(kSingleThread, kMultiThread,
+                                             kRowMT));
+}  // namespace
@@ -88,6 +88,13 @@ class Decoder {
                                                 user_priv);
   }
 
+  // Registers a callback for the rows of frames that are final.
+  vpx_codec_err_t RegisterPutSliceCallback(vpx_codec_put_slice_cb_fn_t cb,
+                                           void *user_priv) {
+    InitOnce();
+    return vpx_codec_register_put_slice_cb(&decoder_, cb, user_priv);
+  }
+
   const char *GetDecoderName() const {
     return vpx_codec_iface_name(CodecInterface());
   }
@@ -51,6 +51,17 @@ const EncodePerfTestVideo kVP9EncodePerfTestVectors[] = {
 const int kEncodePerfTestSpeeds[] = { 5, 6, 7, 8, 9 };
 const int kEncodePerfTestThreads[] = { 1, 2, 4 };
 
+// Row based multi-threading is measured on the largest clips, up to the
+// maximum number of encoder threads.
+const EncodePerfTestVideo kVP9RowMTPerfTestVectors[] = {
+  EncodePerfTestVideo("niklas_1280_720_30.yuv", 1280, 720, 600, 470),
+  EncodePerfTestVideo("slides_code_term_web_plot.1920_1080.yuv", 1920, 1080,
+                      1000, 100),
+};
+
+const int kRowMTPerfTestSpeeds[] = { 5, 7, 9 };
+const int kRowMTPerfTestThreads[] = { 1, 2, 4, 8, 16, 32, 64 };
+
 #define NELEMENTS(x) (sizeof((x)) / sizeof((x)[0]))
 
 class VP9EncodePerfTest
@@ -59,7 +70,7 @@ class VP9EncodePerfTest
  protected:
   VP9EncodePerfTest()
       : EncoderTest(GET_PARAM(0)), min_psnr_(kMaxPsnr), nframes_(0),
-        encoding_mode_(GET_PARAM(1)), speed_(0), threads_(1) {}
+        encoding_mode_(GET_PARAM(1)), speed_(0), threads_(1), row_mt_(0) {}
 
   ~VP9EncodePerfTest() override = default;
 
@@ -90,6 +101,7 @@ class VP9EncodePerfTest
       encoder->Control(VP9E_SET_TILE_COLUMNS, log2_tile_columns);
       encoder->Control(VP9E_SET_FRAME_PARALLEL_DECODING, 1);
       encoder->Control(VP8E_SET_ENABLEAUTOALTREF, 0);
+      encoder->Control(VP9E_SET_ROW_MT, row_mt_);
     }
   }
 
@@ -113,12 +125,15 @@ class VP9EncodePerfTest
 
   void set_threads(unsigned int threads) { threads_ = threads; }
 
+  void set_row_mt(unsigned int row_mt) { row_mt_ = row_mt; }
+
  private:
   double min_psnr_;
   unsigned int nframes_;
   libvpx_test::TestMode encoding_mode_;
   unsigned speed_;
   unsigned int threads_;
+  unsigned int row_mt_;
 };
 
 TEST_P(VP9EncodePerfTest, PerfTest) {
@@ -183,6 +198,60 @@ TEST_P(VP9EncodePerfTest, PerfTest) {
   }
 }
 
+TEST_P(VP9EncodePerfTest, RowMTPerfTest) {
+  set_row_mt(1);
+  for (size_t i = 0; i < NELEMENTS(kVP9RowMTPerfTestVectors); ++i) {
+    for (size_t j = 0; j < NELEMENTS(kRowMTPerfTestSpeeds); ++j) {
+      for (size_t k = 0; k < NELEMENTS(kRowMTPerfTestThreads); ++k) {
+        set_threads(kRowMTPerfTestThreads[k]);
+        SetUp();
+
+        const vpx_rational timebase = { 33333333, 1000000000 };
+        cfg_.g_timebase = timebase;
+        cfg_.rc_target_bitrate = kVP9RowMTPerfTestVectors[i].bitrate;
+
+        init_flags_ = VPX_CODEC_USE_PSNR;
+
+        const unsigned frames = kVP9RowMTPerfTestVectors[i].frames;
+        const char *video_name = kVP9RowMTPerfTestVectors[i].name;
+        libvpx_test::I420VideoSource video(
+            video_name, kVP9RowMTPerfTestVectors[i].width,
+            kVP9RowMTPerfTestVectors[i].height, timebase.den, timebase.num, 0,
+            kVP9RowMTPerfTestVectors[i].frames);
+        set_speed(kRowMTPerfTestSpeeds[j]);
+
+        vpx_usec_timer t;
+        vpx_usec_timer_start(&t);
+
+        ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+
+        vpx_usec_timer_mark(&t);
+        const double elapsed_secs = vpx_usec_timer_elapsed(&t) / kUsecsInSec;
+        const double fps = frames / elapsed_secs;
+        const double minimum_psnr = min_psnr();
+        std::string display_name(video_name);
+        char thread_count[32];
+        snprintf(thread_count, sizeof(thread_count), "_row-mt_t-%d",
+                 kRowMTPerfTestThreads[k]);
+        display_name += thread_count;
+
+        printf("{\n");
+        printf("\t\"type\" : \"encode_perf_test\",\n");
+        printf("\t\"version\" : \"%s\",\n", vpx_codec_version_str());
+        printf("\t\"videoName\" : \"%s\",\n", display_name.c_str());
+        printf("\t\"encodeTimeSecs\" : %f,\n", elapsed_secs);
+        printf("\t\"totalFrames\" : %u,\n", frames);
+        printf("\t\"framesPerSecond\" : %f,\n", fps);
+        printf("\t\"minPsnr\" : %f,\n", minimum_psnr);
+        printf("\t\"speed\" : %d,\n", kRowMTPerfTestSpeeds[j]);
+        printf("\t\"threads\" : %d,\n", kRowMTPerfTestThreads[k]);
+        printf("\t\"rowMt\" : 1\n");
+        printf("}\n");
+      }
+    }
+  }
+}
+
 VP9_INSTANTIATE_TEST_SUITE(VP9EncodePerfTest,
                            ::testing::Values(::libvpx_test::kRealTime));
 }  // namespace
@@ -0,0 +1,114 @@
+/*
+ *  Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/md5_helper.h"
+#include "test/util.h"
+#include "test/video_source.h"
+#include "vpx/vp8cx.h"
+#include "vpx/vp8dx.h"
+
+namespace {
+
+const int kKeyframeInterval = 10;
+// The keyframe-only decoder joins the stream in the middle of the first group
+// of pictures.
+const int kFirstFrameToKeyframeOnly = 5;
+
+class KeyframeOnlyDecodeTest
+    : public ::libvpx_test::EncoderTest,
+      public ::libvpx_test::CodecTestWithParam<int> {
+ protected:
+  KeyframeOnlyDecodeTest()
+      : EncoderTest(GET_PARAM(0)), keyframe_only_(GET_PARAM(1)),
+        num_keyframes_(0) {
+    vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+    full_dec_ = codec_->CreateDecoder(cfg, 0);
+    kf_dec_ = codec_->CreateDecoder(cfg, 0);
+    kf_dec_->Control(VPXD_SET_KEYFRAME_ONLY, keyframe_only_);
+  }
+
+  ~KeyframeOnlyDecodeTest() override {
+    delete full_dec_;
+    delete kf_dec_;
+  }
+
+  void SetUp() override {
+    InitializeConfig();
+    SetMode(::libvpx_test::kRealTime);
+  }
+
+  void PreEncodeFrameHook(::libvpx_test::VideoSource *video,
+                          ::libvpx_test::Encoder *encoder) override {
+    if (video->frame() == 0) encoder->Control(VP8E_SET_CPUUSED, 8);
+    frame_flags_ =
+        (video->frame() % kKeyframeInterval) ? 0 : VPX_EFLAG_FORCE_KF;
+  }
+
+  // Both decoders are run from FramePktHook().
+  bool DoDecode() const override { return false; }
+
+  const vpx_image_t *Decode(::libvpx_test::Decoder *dec,
+                            const vpx_codec_cx_pkt_t *pkt) {
+    const vpx_codec_err_t res = dec->DecodeFrame(
+        static_cast<const uint8_t *>(pkt->data.frame.buf), pkt->data.frame.sz);
+    EXPECT_EQ(VPX_CODEC_OK, res) << dec->DecodeError();
+    return res == VPX_CODEC_OK ? dec->GetDxData().Next() : nullptr;
+  }
+
+  void FramePktHook(const vpx_codec_cx_pkt_t *pkt) override {
+    const bool is_key = (pkt->data.frame.flags & VPX_FRAME_IS_KEY) != 0;
+    const vpx_image_t *const full = Decode(full_dec_, pkt);
+    ASSERT_NE(full, nullptr);
+    if (pkt->data.frame.pts < kFirstFrameToKeyframeOnly) return;
+
+    const vpx_image_t *const kf = Decode(kf_dec_, pkt);
+    if (!is_key) {
+      EXPECT_EQ(kf, nullptr) << "Frame " << pkt->data.frame.pts
+                             << " is not a key frame but was output.";
+      return;
+    }
+    ASSERT_NE(kf, nullptr) << "Key frame " << pkt->data.frame.pts
+                           << " was not output.";
+    ++num_keyframes_;
+    if (keyframe_only_ == 1) {
+      ::libvpx_test::MD5 full_md5, kf_md5;
+      full_md5.Add(full);
+      kf_md5.Add(kf);
+      EXPECT_STREQ(full_md5.Get(), kf_md5.Get())
+          << "Key frame " << pkt->data.frame.pts << " differs.";
+    }
+  }
+
+  int keyframe_only_;
+  int num_keyframes_;
+  ::libvpx_test::Decoder *full_dec_;
+  ::libvpx_test::Decoder *kf_dec_;
+};
+
+TEST_P(KeyframeOnlyDecodeTest, OutputsOnlyKeyframes) {
+  cfg_.g_lag_in_frames = 0;
+  cfg_.rc_end_usage = VPX_CBR;
+  cfg_.kf_mode = VPX_KF_DISABLED;
+
+  ::libvpx_test::RandomVideoSource video;
+  video.SetSize(176, 144);
+  video.set_limit(3 * kKeyframeInterval);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  EXPECT_EQ(2, num_keyframes_);
+}
+
+VP8_INSTANTIATE_TEST_SUITE(KeyframeOnlyDecodeTest, ::testing::Values(1, 2));
+VP9_INSTANTIATE_TEST_SUITE(KeyframeOnlyDecodeTest, ::testing::Values(1, 2));
+}  // namespace
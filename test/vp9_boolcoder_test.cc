@@ -111,3 +111,36 @@ TEST(VP9, TestBitIOBufferSize2) {
   vpx_start_encode(&bw, bw_buffer, sizeof(bw_buffer));
   GTEST_ASSERT_EQ(vpx_stop_encode(&bw), 0);
 }
+
+// Refilling before 'count' drops below 0, as vp9's coefficient decoder does,
+// must not change the decoded bits, including at the end of the buffer.
+TEST(VP9, TestBitIOEarlyFill) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  const int kBitsToTest = 2000;
+  const int kBufferSize = 10000;
+  uint8_t probas[kBitsToTest];
+  int bits[kBitsToTest];
+  vpx_writer bw;
+  uint8_t bw_buffer[kBufferSize];
+
+  for (int i = 0; i < kBitsToTest; ++i) {
+    probas[i] = (i & 1) ? rnd(256) : 255 - rnd(32);
+    bits[i] = rnd(2);
+  }
+  vpx_start_encode(&bw, bw_buffer, sizeof(bw_buffer));
+  for (int i = 0; i < kBitsToTest; ++i) {
+    vpx_write(&bw, bits[i], static_cast<int>(probas[i]));
+  }
+  GTEST_ASSERT_EQ(vpx_stop_encode(&bw), 0);
+
+  for (int fill_bits = 0; fill_bits <= BD_VALUE_SIZE - 16; fill_bits += 8) {
+    vpx_reader br;
+    vpx_reader_init(&br, bw_buffer, bw.pos, nullptr, nullptr);
+    for (int i = 0; i < kBitsToTest; ++i) {
+      if (br.count < fill_bits) vpx_reader_fill_fast(&br);
+      GTEST_ASSERT_EQ(vpx_read(&br, probas[i]), bits[i])
+          << "pos: " << i << " fill_bits: " << fill_bits;
+    }
+    EXPECT_EQ(vpx_reader_has_error(&br), 0);
+  }
+}
@@ -0,0 +1,173 @@
+/*
+ *  Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <cstring>
+#include <tuple>
+
+#include "gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/util.h"
+#include "test/video_source.h"
+#include "vpx/vp8cx.h"
+#include "vpx/vp8dx.h"
+
+namespace {
+
+const int kWidth = 704;
+const int kHeight = 144;
+
+// Texture that moves by a pixel per frame, so that blocks are coded with
+// motion vectors and residuals.
+class MovingTextureVideoSource : public ::libvpx_test::DummyVideoSource {
+ protected:
+  void FillFrame() override {
+    if (img_ == nullptr) return;
+    for (int plane = 0; plane < 3; ++plane) {
+      const int w = plane ? (kWidth + 1) / 2 : kWidth;
+      const int h = plane ? (kHeight + 1) / 2 : kHeight;
+      for (int y = 0; y < h; ++y) {
+        uint8_t *const row = img_->planes[plane] + y * img_->stride[plane];
+        for (int x = 0; x < w; ++x) {
+          const int u = x + frame_;
+          const int v = y + frame_ / 2;
+          row[x] = static_cast<uint8_t>((u * u / 7 + v * 3 + (u ^ v)) & 0xff);
+        }
+      }
+    }
+  }
+};
+
+// Decodes the same stream fully and with VP9D_SET_DECODE_REGION. Frames that
+// update a reference must be identical, and without the loop filter the
+// region of the other frames must be too.
+class DecodeRegionTest
+    : public ::libvpx_test::EncoderTest,
+      public ::libvpx_test::CodecTestWith2Params<int, int> {
+ protected:
+  DecodeRegionTest()
+      : EncoderTest(GET_PARAM(0)), skip_loop_filter_(GET_PARAM(1)),
+        num_region_frames_(0) {
+    vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+    cfg.w = kWidth;
+    cfg.h = kHeight;
+    cfg.threads = GET_PARAM(2);
+    full_dec_ = codec_->CreateDecoder(cfg, 0);
+    region_dec_ = codec_->CreateDecoder(cfg, 0);
+    full_dec_->Control(VP9_SET_SKIP_LOOP_FILTER, skip_loop_filter_);
+    region_dec_->Control(VP9_SET_SKIP_LOOP_FILTER, skip_loop_filter_);
+    rect_.x = 400;
+    rect_.y = 8;
+    rect_.w = 120;
+    rect_.h = 40;
+    region_dec_->Control(VP9D_SET_DECODE_REGION, &rect_);
+  }
+
+  ~DecodeRegionTest() override {
+    delete full_dec_;
+    delete region_dec_;
+  }
+
+  void SetUp() override {
+    InitializeConfig();
+    SetMode(::libvpx_test::kRealTime);
+  }
+
+  void PreEncodeFrameHook(::libvpx_test::VideoSource *video,
+                          ::libvpx_test::Encoder *encoder) override {
+    if (video->frame() == 0) {
+      encoder->Control(VP8E_SET_CPUUSED, 7);
+      encoder->Control(VP9E_SET_TILE_COLUMNS, 1);
+    }
+    // Every other frame is not used as a reference.
+    frame_flags_ = (video->frame() & 1) ? VP8_EFLAG_NO_UPD_LAST |
+                                              VP8_EFLAG_NO_UPD_GF |
+                                              VP8_EFLAG_NO_UPD_ARF
+                                        : 0;
+  }
+
+  // Both decoders are run from FramePktHook().
+  bool DoDecode() const override { return false; }
+
+  const vpx_image_t *Decode(::libvpx_test::Decoder *dec,
+                            const vpx_codec_cx_pkt_t *pkt) {
+    const vpx_codec_err_t res = dec->DecodeFrame(
+        static_cast<const uint8_t *>(pkt->data.frame.buf), pkt->data.frame.sz);
+    EXPECT_EQ(VPX_CODEC_OK, res) << dec->DecodeError();
+    return res == VPX_CODEC_OK ? dec->GetDxData().Next() : nullptr;
+  }
+
+  // Returns true if the planes match within the luma rectangle x, y, w, h.
+  static bool CompareRect(const vpx_image_t *a, const vpx_image_t *b, int x,
+                          int y, int w, int h) {
+    for (int plane = 0; plane < 3; ++plane) {
+      const int ss_x = plane ? a->x_chroma_shift : 0;
+      const int ss_y = plane ? a->y_chroma_shift : 0;
+      const int px = x >> ss_x;
+      const int py = y >> ss_y;
+      const int pw = ((x + w + ss_x) >> ss_x) - px;
+      const int ph = ((y + h + ss_y) >> ss_y) - py;
+      for (int r = py; r < py + ph; ++r) {
+        if (memcmp(a->planes[plane] + r * a->stride[plane] + px,
+                   b->planes[plane] + r * b->stride[plane] + px, pw)) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  void FramePktHook(const vpx_codec_cx_pkt_t *pkt) override {
+    const vpx_image_t *const full = Decode(full_dec_, pkt);
+    const vpx_image_t *const region = Decode(region_dec_, pkt);
+    if (full == nullptr || region == nullptr) {
+      abort_ = true;
+      return;
+    }
+    int ref_updates = 0;
+    ASSERT_EQ(VPX_CODEC_OK,
+              vpx_codec_control(full_dec_->GetDecoder(),
+                                VP8D_GET_LAST_REF_UPDATES, &ref_updates));
+    if (ref_updates) {
+      EXPECT_TRUE(CompareRect(full, region, 0, 0, static_cast<int>(full->d_w),
+                              static_cast<int>(full->d_h)))
+          << "Reference frame " << pkt->data.frame.pts << " differs.";
+    } else {
+      ++num_region_frames_;
+      if (skip_loop_filter_) {
+        EXPECT_TRUE(
+            CompareRect(full, region, rect_.x, rect_.y, rect_.w, rect_.h))
+            << "Region of frame " << pkt->data.frame.pts << " differs.";
+      }
+    }
+  }
+
+  int skip_loop_filter_;
+  int num_region_frames_;
+  vpx_image_rect_t rect_;
+  ::libvpx_test::Decoder *full_dec_;
+  ::libvpx_test::Decoder *region_dec_;
+};
+
+TEST_P(DecodeRegionTest, MatchesFullDecode) {
+  cfg_.g_lag_in_frames = 0;
+  cfg_.rc_target_bitrate = 1500;
+  cfg_.rc_end_usage = VPX_CBR;
+
+  MovingTextureVideoSource video;
+  video.SetSize(kWidth, kHeight);
+  video.set_limit(20);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  EXPECT_GT(num_region_frames_, 0);
+}
+
+VP9_INSTANTIATE_TEST_SUITE(DecodeRegionTest, ::testing::Values(0, 1),
+                           ::testing::Values(1, 2));
+}  // namespace
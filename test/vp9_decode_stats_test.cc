@@ -0,0 +1,132 @@
+/*
+ *  Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <tuple>
+
+#include "gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/util.h"
+#include "test/video_source.h"
+#include "vpx/vp8cx.h"
+#include "vpx/vp8dx.h"
+
+namespace {
+
+// Decodes a stream with and without VP9D_SET_COLLECT_STATS and checks the
+// times reported by VP9D_GET_DECODE_STATS.
+class DecodeStatsTest
+    : public ::libvpx_test::EncoderTest,
+      public ::libvpx_test::CodecTestWith2Params<int, int> {
+ protected:
+  DecodeStatsTest()
+      : EncoderTest(GET_PARAM(0)), threads_(GET_PARAM(1)),
+        row_mt_(GET_PARAM(2)), num_frames_(0), total_parse_us_(0),
+        total_recon_us_(0) {
+    vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+    cfg.threads = threads_;
+    decoder_ = codec_->CreateDecoder(cfg, 0);
+    decoder_->Control(VP9D_SET_ROW_MT, row_mt_);
+    decoder_->Control(VP9D_SET_COLLECT_STATS, 1);
+    plain_decoder_ = codec_->CreateDecoder(cfg, 0);
+    plain_decoder_->Control(VP9D_SET_ROW_MT, row_mt_);
+  }
+
+  ~DecodeStatsTest() override {
+    delete decoder_;
+    delete plain_decoder_;
+  }
+
+  void SetUp() override {
+    InitializeConfig();
+    SetMode(::libvpx_test::kRealTime);
+  }
+
+  void PreEncodeFrameHook(::libvpx_test::VideoSource *video,
+                          ::libvpx_test::Encoder *encoder) override {
+    if (video->frame() == 0) {
+      encoder->Control(VP8E_SET_CPUUSED, 7);
+      encoder->Control(VP9E_SET_TILE_COLUMNS, 2);
+    }
+  }
+
+  // Both decoders are run from FramePktHook().
+  bool DoDecode() const override { return false; }
+
+  static void Decode(::libvpx_test::Decoder *dec, const vpx_codec_cx_pkt_t *pkt,
+                     vpx_decode_stats_t *stats) {
+    const vpx_codec_err_t res = dec->DecodeFrame(
+        static_cast<const uint8_t *>(pkt->data.frame.buf), pkt->data.frame.sz);
+    ASSERT_EQ(VPX_CODEC_OK, res) << dec->DecodeError();
+    ASSERT_NE(dec->GetDxData().Next(), nullptr);
+    ASSERT_EQ(VPX_CODEC_OK, vpx_codec_control(dec->GetDecoder(),
+                                              VP9D_GET_DECODE_STATS, stats));
+  }
+
+  void FramePktHook(const vpx_codec_cx_pkt_t *pkt) override {
+    vpx_decode_stats_t stats;
+    ASSERT_NO_FATAL_FAILURE(Decode(plain_decoder_, pkt, &stats));
+    EXPECT_EQ(0, stats.frame_us);
+    EXPECT_EQ(0, stats.parse_us);
+
+    ASSERT_NO_FATAL_FAILURE(Decode(decoder_, pkt, &stats));
+    ++num_frames_;
+    EXPECT_GT(stats.frame_us, 0);
+    EXPECT_GE(stats.header_us, 0);
+    EXPECT_GE(stats.parse_us, 0);
+    EXPECT_GE(stats.loop_filter_us, 0);
+    EXPECT_EQ(0, stats.frame_wait_us);
+    total_parse_us_ += stats.parse_us;
+    if (threads_ == 1) {
+      // The stages of a single thread do not overlap.
+      EXPECT_LE(stats.header_us + stats.parse_us + stats.loop_filter_us,
+                stats.frame_us);
+      EXPECT_EQ(0, stats.recon_us);
+    }
+    if (threads_ > 1 && row_mt_) {
+      ASSERT_EQ(threads_, stats.num_workers);
+      for (int i = 0; i < stats.num_workers; ++i) {
+        EXPECT_GE(stats.worker_busy_us[i], 0);
+        EXPECT_GE(stats.worker_idle_us[i], 0);
+      }
+      total_recon_us_ += stats.recon_us;
+    } else {
+      EXPECT_EQ(0, stats.num_workers);
+    }
+  }
+
+  int threads_;
+  int row_mt_;
+  int num_frames_;
+  int64_t total_parse_us_;
+  int64_t total_recon_us_;
+  ::libvpx_test::Decoder *decoder_;
+  ::libvpx_test::Decoder *plain_decoder_;
+};
+
+TEST_P(DecodeStatsTest, ReportsStageTimes) {
+  cfg_.g_lag_in_frames = 0;
+  cfg_.rc_target_bitrate = 800;
+  cfg_.rc_end_usage = VPX_CBR;
+
+  ::libvpx_test::RandomVideoSource video;
+  video.SetSize(704, 288);
+  video.set_limit(10);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  EXPECT_EQ(10, num_frames_);
+  EXPECT_GT(total_parse_us_, 0);
+  if (threads_ > 1 && row_mt_) {
+    EXPECT_GT(total_recon_us_, 0);
+  }
+}
+
+VP9_INSTANTIATE_TEST_SUITE(DecodeStatsTest, ::testing::Values(1, 4),
+                           ::testing::Values(0, 1));
+}  // namespace
@@ -237,6 +237,8 @@ class VPxEncoderThreadTest
     init_flags_ = VPX_CODEC_USE_PSNR;
     md5_.clear();
     row_mt_mode_ = 1;
+    pipelined_packing_ = 0;
+    aq_mode_ = 3;
     psnr_ = 0.0;
     nframes_ = 0;
   }
@@ -279,9 +281,10 @@ class VPxEncoderThreadTest
         encoder->Control(VP9E_SET_FRAME_PARALLEL_DECODING, 0);
       } else {
         encoder->Control(VP8E_SET_ENABLEAUTOALTREF, 0);
-        encoder->Control(VP9E_SET_AQ_MODE, 3);
+        encoder->Control(VP9E_SET_AQ_MODE, aq_mode_);
       }
       encoder->Control(VP9E_SET_ROW_MT, row_mt_mode_);
+      encoder->Control(VP9E_SET_PIPELINED_PACKING, pipelined_packing_);
 
       encoder_initialized_ = true;
     }
@@ -318,6 +321,8 @@ class VPxEncoderThreadTest
   ::libvpx_test::TestMode encoding_mode_;
   int set_cpu_used_;
   int row_mt_mode_;
+  int pipelined_packing_;
+  int aq_mode_;
   double psnr_;
   unsigned int nframes_;
   std::vector<std::string> md5_;
@@ -398,6 +403,33 @@ TEST_P(VPxEncoderThreadTest, EncoderResultTest) {
   EXPECT_NEAR(single_thr_psnr, multi_thr_psnr, 0.2);
 }
 
+TEST_P(VPxEncoderThreadTest, PipelinedPackingTest) {
+  ::libvpx_test::Y4mVideoSource video("niklas_1280_720_30.y4m", 15, 20);
+  cfg_.rc_target_bitrate = 1000;
+  pipelined_packing_ = 1;
+  // The tiles are only packed while the frame is encoded without
+  // segmentation.
+  aq_mode_ = 0;
+
+  // The tiles are packed as they are encoded when there are several threads,
+  // which must not change the result. As in EncoderResultTest, row-mt is only
+  // bit exact from 2 threads on.
+  for (row_mt_mode_ = 0; row_mt_mode_ <= 1; ++row_mt_mode_) {
+    cfg_.g_threads = row_mt_mode_ ? 2 : 1;
+    init_flags_ = VPX_CODEC_USE_PSNR;
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+    const std::vector<std::string> ref_md5 = md5_;
+    md5_.clear();
+
+    cfg_.g_threads = threads_;
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+    const std::vector<std::string> multi_thr_md5 = md5_;
+    md5_.clear();
+
+    ASSERT_EQ(ref_md5, multi_thr_md5) << "row_mt " << row_mt_mode_;
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(
     VP9, VPxFirstPassEncoderThreadTest,
     ::testing::Combine(
@@ -0,0 +1,145 @@
+/*
+ *  Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test/yuv_video_source.h"
+
+#include "./vpx_config.h"
+#include "vpx/vp8cx.h"
+#include "vpx/vpx_encoder.h"
+
+namespace {
+
+const char kClip[] = "hantro_collage_w352h288.yuv";
+const int kWidth = 352;
+const int kHeight = 288;
+const int kNumFrames = 20;
+// One 32-bit motion vector per 16x16 macroblock.
+const size_t kFrameMbStatsSize =
+    ((kWidth + 15) / 16) * ((kHeight + 15) / 16) * sizeof(uint32_t);
+
+struct EncodeOutput {
+  std::vector<uint8_t> stats;
+  std::vector<uint8_t> mb_stats;
+  size_t num_frames = 0;
+  size_t size = 0;
+  double sse = 0.0;
+  double samples = 0.0;
+};
+
+vpx_codec_enc_cfg_t GetConfig() {
+  vpx_codec_enc_cfg_t cfg;
+  EXPECT_EQ(vpx_codec_enc_config_default(vpx_codec_vp9_cx(), &cfg, 0),
+            VPX_CODEC_OK);
+  cfg.g_w = kWidth;
+  cfg.g_h = kHeight;
+  cfg.g_timebase.num = 1;
+  cfg.g_timebase.den = 30;
+  cfg.rc_end_usage = VPX_VBR;
+  cfg.rc_target_bitrate = 1000;
+  return cfg;
+}
+
+void Encode(const vpx_codec_enc_cfg_t &cfg, EncodeOutput *output) {
+  vpx_codec_ctx_t enc;
+  ASSERT_EQ(vpx_codec_enc_init(&enc, vpx_codec_vp9_cx(), &cfg,
+                               VPX_CODEC_USE_PSNR),
+            VPX_CODEC_OK);
+  ASSERT_EQ(vpx_codec_control(&enc, VP8E_SET_CPUUSED, 2), VPX_CODEC_OK);
+
+  libvpx_test::YUVVideoSource video(kClip, VPX_IMG_FMT_I420, kWidth, kHeight,
+                                    30, 1, 0, kNumFrames);
+  video.Begin();
+  bool flushing = false;
+  bool got_data;
+  do {
+    flushing = video.img() == nullptr;
+    ASSERT_EQ(vpx_codec_encode(&enc, video.img(), video.pts(), 1, 0,
+                               VPX_DL_GOOD_QUALITY),
+              VPX_CODEC_OK)
+        << vpx_codec_error_detail(&enc);
+    vpx_codec_iter_t iter = nullptr;
+    const vpx_codec_cx_pkt_t *pkt;
+    got_data = false;
+    while ((pkt = vpx_codec_get_cx_data(&enc, &iter)) != nullptr) {
+      got_data = true;
+      if (pkt->kind == VPX_CODEC_STATS_PKT) {
+        const uint8_t *const buf =
+            static_cast<const uint8_t *>(pkt->data.twopass_stats.buf);
+        output->stats.insert(output->stats.end(), buf,
+                             buf + pkt->data.twopass_stats.sz);
+      } else if (pkt->kind == VPX_CODEC_FPMB_STATS_PKT) {
+        const uint8_t *const buf =
+            static_cast<const uint8_t *>(pkt->data.firstpass_mb_stats.buf);
+        EXPECT_EQ(kFrameMbStatsSize, pkt->data.firstpass_mb_stats.sz);
+        output->mb_stats.insert(output->mb_stats.end(), buf,
+                                buf + pkt->data.firstpass_mb_stats.sz);
+      } else if (pkt->kind == VPX_CODEC_CX_FRAME_PKT) {
+        ++output->num_frames;
+        output->size += pkt->data.frame.sz;
+      } else if (pkt->kind == VPX_CODEC_PSNR_PKT) {
+        output->sse += pkt->data.psnr.sse[0];
+        output->samples += pkt->data.psnr.samples[0];
+      }
+    }
+    if (!flushing) video.Next();
+  } while (!flushing || got_data);
+  ASSERT_EQ(vpx_codec_destroy(&enc), VPX_CODEC_OK);
+}
+
+TEST(VP9FirstPassMvTest, SecondPassSearchesFromFirstPassMotion) {
+  vpx_codec_enc_cfg_t cfg = GetConfig();
+  EncodeOutput first_pass;
+  cfg.g_pass = VPX_RC_FIRST_PASS;
+  ASSERT_NO_FATAL_FAILURE(Encode(cfg, &first_pass));
+  ASSERT_EQ(kNumFrames * kFrameMbStatsSize, first_pass.mb_stats.size());
+
+  cfg.g_pass = VPX_RC_LAST_PASS;
+  cfg.rc_twopass_stats_in.buf = first_pass.stats.data();
+  cfg.rc_twopass_stats_in.sz = first_pass.stats.size();
+  EncodeOutput reference;
+  ASSERT_NO_FATAL_FAILURE(Encode(cfg, &reference));
+
+  cfg.rc_firstpass_mb_stats_in.buf = first_pass.mb_stats.data();
+  cfg.rc_firstpass_mb_stats_in.sz = first_pass.mb_stats.size();
+  EncodeOutput seeded;
+  ASSERT_NO_FATAL_FAILURE(Encode(cfg, &seeded));
+
+  ASSERT_EQ(static_cast<size_t>(kNumFrames), seeded.num_frames);
+  // The first pass motion only changes where the searches start, so the
+  // encode should cost about as many bits for about the same error.
+  EXPECT_NEAR(static_cast<double>(reference.size), seeded.size,
+              0.05 * reference.size);
+  EXPECT_NEAR(reference.sse / reference.samples, seeded.sse / seeded.samples,
+              0.1 * reference.sse / reference.samples);
+}
+
+TEST(VP9FirstPassMvTest, RejectsMismatchedMotion) {
+  vpx_codec_enc_cfg_t cfg = GetConfig();
+  EncodeOutput first_pass;
+  cfg.g_pass = VPX_RC_FIRST_PASS;
+  ASSERT_NO_FATAL_FAILURE(Encode(cfg, &first_pass));
+
+  cfg.g_pass = VPX_RC_LAST_PASS;
+  cfg.rc_twopass_stats_in.buf = first_pass.stats.data();
+  cfg.rc_twopass_stats_in.sz = first_pass.stats.size();
+  // The motion of one frame is missing.
+  cfg.rc_firstpass_mb_stats_in.buf = first_pass.mb_stats.data();
+  cfg.rc_firstpass_mb_stats_in.sz =
+      first_pass.mb_stats.size() - kFrameMbStatsSize;
+  vpx_codec_ctx_t enc;
+  EXPECT_EQ(vpx_codec_enc_init(&enc, vpx_codec_vp9_cx(), &cfg, 0),
+            VPX_CODEC_INVALID_PARAM);
+}
+
+}  // namespace
@@ -0,0 +1,198 @@
+/*
+ *  Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <tuple>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "./vpx_dsp_rtcd.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/md5_helper.h"
+#include "test/util.h"
+#include "test/video_source.h"
+#include "vp9/common/vp9_filter.h"
+#include "vpx/vp8cx.h"
+#include "vpx/vp8dx.h"
+
+namespace {
+
+const int kWidth = 704;
+const int kHeight = 288;
+
+// Decoding modes: a single thread, 4 threads, and 4 threads with row-MT.
+enum { kSingleThread, kMultiThread, kRowMT };
+
+// Scales a plane like the decoder does, in blocks of 16 luma rows and columns,
+// reading past its edges from a copy with clamped edges.
+void ScalePlane(const uint8_t *src, int src_stride, int plane_w, int plane_h,
+                int src_w, int src_h, int dst_w, int dst_h, int bs,
+                std::vector<uint8_t> *dst, int *dst_stride) {
+  const int kPad = 80;
+  const int padded_stride = plane_w + 2 * kPad;
+  std::vector<uint8_t> padded(padded_stride * (plane_h + 2 * kPad));
+  for (int r = 0; r < plane_h + 2 * kPad; ++r) {
+    const int sr = std::min(std::max(r - kPad, 0), plane_h - 1);
+    for (int c = 0; c < padded_stride; ++c) {
+      const int sc = std::min(std::max(c - kPad, 0), plane_w - 1);
+      padded[r * padded_stride + c] = src[sr * src_stride + sc];
+    }
+  }
+
+  const int x_step_q4 = 16 * src_w / dst_w;
+  const int y_step_q4 = 16 * src_h / dst_h;
+  *dst_stride = (dst_w + 15) / 16 * bs;
+  dst->assign(*dst_stride * ((dst_h + 15) / 16 * bs), 0);
+  for (int y = 0; y < dst_h; y += 16) {
+    const int y_q4 = y * bs * src_h / dst_h;
+    for (int x = 0; x < dst_w; x += 16) {
+      const int x_q4 = x * bs * src_w / dst_w;
+      vpx_scaled_2d_c(
+          &padded[((y_q4 >> 4) + kPad) * padded_stride + (x_q4 >> 4) + kPad],
+          padded_stride, &(*dst)[y * bs / 16 * *dst_stride + x * bs / 16],
+          *dst_stride, vp9_filter_kernels[EIGHTTAP], x_q4 & 15, x_step_q4,
+          y_q4 & 15, y_step_q4, bs, bs);
+    }
+  }
+}
+
+// Checks that frames scaled while they are decoded match the decoded frames
+// scaled afterwards.
+class ScaledOutputTest
+    : public ::libvpx_test::EncoderTest,
+      public ::libvpx_test::CodecTestWith3Params<int, int, int> {
+ protected:
+  ScaledOutputTest()
+      : EncoderTest(GET_PARAM(0)), mode_(GET_PARAM(1)),
+        output_width_(GET_PARAM(2)), output_height_(GET_PARAM(3)), rows_(0),
+        num_frames_(0) {
+    vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+    reference_decoder_ = codec_->CreateDecoder(cfg, 0);
+    cfg.threads = (mode_ == kSingleThread) ? 1 : 4;
+    scaled_decoder_ = codec_->CreateDecoder(cfg, 0);
+    if (mode_ == kRowMT) scaled_decoder_->Control(VP9D_SET_ROW_MT, 1);
+    int size[2] = { output_width_, output_height_ };
+    scaled_decoder_->Control(VP9D_SET_OUTPUT_SIZE, size);
+    EXPECT_EQ(VPX_CODEC_OK,
+              scaled_decoder_->RegisterPutSliceCallback(PutSlice, this));
+  }
+
+  ~ScaledOutputTest() override {
+    delete reference_decoder_;
+    delete scaled_decoder_;
+  }
+
+  void SetUp() override {
+    InitializeConfig();
+    SetMode(::libvpx_test::kRealTime);
+  }
+
+  void PreEncodeFrameHook(::libvpx_test::VideoSource *video,
+                          ::libvpx_test::Encoder *encoder) override {
+    if (video->frame() == 0) {
+      encoder->Control(VP8E_SET_CPUUSED, 7);
+      encoder->Control(VP9E_SET_TILE_COLUMNS, 2);
+    }
+  }
+
+  // The decoders are run from FramePktHook().
+  bool DoDecode() const override { return false; }
+
+  static void PutSlice(void *user_priv, const vpx_image_t *img,
+                       const vpx_image_rect_t *valid,
+                       const vpx_image_rect_t *update) {
+    ScaledOutputTest *const test = static_cast<ScaledOutputTest *>(user_priv);
+    EXPECT_EQ(test->rows_, update->y);
+    EXPECT_EQ(valid->h, update->y + update->h);
+    EXPECT_LE(valid->h, img->d_h);
+    test->rows_ = valid->h;
+  }
+
+  bool IsScaled() const {
+    return output_width_ <= kWidth && output_height_ <= kHeight &&
+           4 * output_width_ >= kWidth && 4 * output_height_ >= kHeight;
+  }
+
+  void FramePktHook(const vpx_codec_cx_pkt_t *pkt) override {
+    const uint8_t *const data =
+        static_cast<const uint8_t *>(pkt->data.frame.buf);
+    rows_ = 0;
+    ASSERT_EQ(VPX_CODEC_OK,
+              reference_decoder_->DecodeFrame(data, pkt->data.frame.sz));
+    ASSERT_EQ(VPX_CODEC_OK,
+              scaled_decoder_->DecodeFrame(data, pkt->data.frame.sz))
+        << scaled_decoder_->DecodeError();
+    const vpx_image_t *const ref = reference_decoder_->GetDxData().Next();
+    const vpx_image_t *const img = scaled_decoder_->GetDxData().Next();
+    ASSERT_NE(ref, nullptr);
+    ASSERT_NE(img, nullptr);
+    ++num_frames_;
+    ASSERT_EQ(img->d_h, rows_);
+
+    if (!IsScaled()) {
+      ASSERT_EQ(ref->d_w, img->d_w);
+      ASSERT_EQ(ref->d_h, img->d_h);
+      ::libvpx_test::MD5 ref_md5, img_md5;
+      ref_md5.Add(ref);
+      img_md5.Add(img);
+      ASSERT_STREQ(ref_md5.Get(), img_md5.Get());
+      return;
+    }
+    ASSERT_EQ(static_cast<unsigned int>(output_width_), img->d_w);
+    ASSERT_EQ(static_cast<unsigned int>(output_height_), img->d_h);
+    for (int plane = 0; plane < 3; ++plane) {
+      const int shift = plane ? 1 : 0;
+      std::vector<uint8_t> expected;
+      int expected_stride;
+      ScalePlane(ref->planes[plane], ref->stride[plane],
+                 (ref->d_w + shift) >> shift, (ref->d_h + shift) >> shift,
+                 ref->d_w, ref->d_h, output_width_, output_height_,
+                 16 >> shift, &expected, &expected_stride);
+      const int w = (img->d_w + shift) >> shift;
+      const int h = (img->d_h + shift) >> shift;
+      for (int r = 0; r < h; ++r) {
+        ASSERT_EQ(0, memcmp(&expected[r * expected_stride],
+                            img->planes[plane] + r * img->stride[plane], w))
+            << "Frame " << pkt->data.frame.pts << " plane " << plane
+            << " row " << r;
+      }
+    }
+  }
+
+  int mode_;
+  int output_width_;
+  int output_height_;
+  unsigned int rows_;
+  int num_frames_;
+  ::libvpx_test::Decoder *reference_decoder_;
+  ::libvpx_test::Decoder *scaled_decoder_;
+};
+
+TEST_P(ScaledOutputTest, MatchesScaledFrames) {
+  cfg_.g_lag_in_frames = 0;
+  cfg_.rc_target_bitrate = 800;
+  cfg_.rc_end_usage = VPX_CBR;
+
+  ::libvpx_test::RandomVideoSource video;
+  video.SetSize(kWidth, kHeight);
+  video.set_limit(10);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  EXPECT_EQ(10, num_frames_);
+}
+
+// Widths halved, scaled by 3/4, at the 4x limit, and too large or too small to
+// be scaled, with heights halved or scaled by 2/3.
+VP9_INSTANTIATE_TEST_SUITE(
+    ScaledOutputTest, ::testing::Values(kSingleThread, kMultiThread, kRowMT),
+    ::testing::Values(352, 528, 176, 800, 170),
+    ::testing::Values(144, 192));
+}  // namespace
@@ -0,0 +1,143 @@
+/*
+ *  Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "vp9/encoder/vp9_task_pool.h"
+
+namespace {
+
+const int kNumTasks = 100;
+
+struct Counter {
+  std::atomic<int> done{ 0 };
+  std::atomic<int> seen{ 0 };
+};
+
+int CountTask(void *arg1, void *arg2) {
+  static_cast<Counter *>(arg1)->done.fetch_add(1);
+  static_cast<std::atomic<int> *>(arg2)->fetch_add(1);
+  return 1;
+}
+
+// Records how many tasks of the group it depends on were done when it ran.
+int ObserveTask(void *arg1, void * /*arg2*/) {
+  Counter *const counter = static_cast<Counter *>(arg1);
+  counter->seen.store(counter->done.load());
+  return 1;
+}
+
+// Waits for the task queued before it.
+int ChainTask(void *arg1, void *arg2) {
+  std::atomic<int> *const done = static_cast<std::atomic<int> *>(arg1);
+  const int index = static_cast<int>(reinterpret_cast<intptr_t>(arg2));
+  if (index > 0) {
+    while (!done[index - 1].load()) std::this_thread::yield();
+  }
+  done[index].store(1);
+  return 1;
+}
+
+int FailTask(void * /*arg1*/, void * /*arg2*/) { return 0; }
+
+// Holds its thread until the flag is set.
+int GateTask(void *arg1, void * /*arg2*/) {
+  std::atomic<int> *const open = static_cast<std::atomic<int> *>(arg1);
+  while (!open->load()) std::this_thread::yield();
+  return 1;
+}
+
+class TaskPoolTest : public ::testing::TestWithParam<int> {
+ protected:
+  void SetUp() override {
+    memset(&error_, 0, sizeof(error_));
+    memset(&pool_, 0, sizeof(pool_));
+    memset(&group_, 0, sizeof(group_));
+    vp9_task_pool_init(&pool_, &error_, GetParam());
+  }
+
+  void TearDown() override { vp9_task_pool_free(&pool_); }
+
+  vpx_internal_error_info error_;
+  VP9TaskPool pool_;
+  VP9TaskGroup group_;
+};
+
+TEST_P(TaskPoolTest, RunsAllTasks) {
+  Counter counter;
+  std::vector<std::atomic<int>> runs(kNumTasks);
+  vp9_task_group_init(&group_, nullptr);
+  for (int i = 0; i < kNumTasks; ++i) {
+    vp9_task_pool_add(&pool_, &group_, CountTask, &counter, &runs[i]);
+  }
+  EXPECT_EQ(1, vp9_task_pool_wait(&pool_, &group_));
+  EXPECT_EQ(kNumTasks, counter.done.load());
+  for (int i = 0; i < kNumTasks; ++i) EXPECT_EQ(1, runs[i].load()) << i;
+  EXPECT_EQ(0, group_.num_pending);
+}
+
+TEST_P(TaskPoolTest, DependentGroupStartsLast) {
+  VP9TaskGroup dependent = VP9TaskGroup();
+  Counter counter;
+  std::vector<std::atomic<int>> runs(kNumTasks);
+  std::atomic<int> open{ 0 };
+  vp9_task_group_init(&group_, nullptr);
+  vp9_task_group_init(&dependent, &group_);
+  // The dependency must have a pending task when the dependent one is queued.
+  // The other tasks are queued after it, so it can only be delayed by the
+  // dependency.
+  vp9_task_pool_add(&pool_, &group_, GateTask, &open, nullptr);
+  vp9_task_pool_add(&pool_, &dependent, ObserveTask, &counter, nullptr);
+  for (int i = 0; i < kNumTasks; ++i) {
+    vp9_task_pool_add(&pool_, &group_, CountTask, &counter, &runs[i]);
+  }
+  open.store(1);
+  EXPECT_EQ(1, vp9_task_pool_wait(&pool_, &dependent));
+  EXPECT_EQ(0, group_.num_pending);
+  EXPECT_EQ(kNumTasks, counter.seen.load());
+}
+
+TEST_P(TaskPoolTest, TasksCanWaitForEarlierTasks) {
+  std::vector<std::atomic<int>> done(kNumTasks);
+  vp9_task_group_init(&group_, nullptr);
+  for (int i = 0; i < kNumTasks; ++i) {
+    vp9_task_pool_add(&pool_, &group_, ChainTask, done.data(),
+                      reinterpret_cast<void *>(static_cast<intptr_t>(i)));
+  }
+  EXPECT_EQ(1, vp9_task_pool_wait(&pool_, &group_));
+  EXPECT_EQ(1, done[kNumTasks - 1].load());
+}
+
+TEST_P(TaskPoolTest, ReportsErrors) {
+  Counter counter;
+  std::atomic<int> runs{ 0 };
+  vp9_task_group_init(&group_, nullptr);
+  vp9_task_pool_add(&pool_, &group_, CountTask, &counter, &runs);
+  vp9_task_pool_add(&pool_, &group_, FailTask, nullptr, nullptr);
+  EXPECT_EQ(0, vp9_task_pool_wait(&pool_, &group_));
+  EXPECT_EQ(1, runs.load());
+
+  // The error is cleared for the next use of the group.
+  vp9_task_group_init(&group_, nullptr);
+  vp9_task_pool_add(&pool_, &group_, CountTask, &counter, &runs);
+  EXPECT_EQ(1, vp9_task_pool_wait(&pool_, &group_));
+  EXPECT_EQ(2, runs.load());
+}
+
+// No threads, in which case the tasks run in vp9_task_pool_wait(), and more
+// or fewer threads than there are tasks running at once.
+INSTANTIATE_TEST_SUITE_P(VP9, TaskPoolTest, ::testing::Values(0, 1, 4));
+
+}  // namespace
@@ -0,0 +1,192 @@
+/*
+ *  Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "./vpx_config.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/md5_helper.h"
+#include "test/util.h"
+#include "test/video_source.h"
+#include "vpx/vp8cx.h"
+#include "vpx/vp8dx.h"
+
+namespace {
+
+typedef std::pair<vpx_thread_pool_task_fn_t, void *> Task;
+
+// Runs submitted tasks on 'num_threads' threads. With no threads, tasks only
+// run from RunQueued().
+class TestThreadPool {
+ public:
+  explicit TestThreadPool(int num_threads) : done_(false), num_submitted_(0) {
+    pool_.submit = Submit;
+    pool_.pool_priv = this;
+    for (int i = 0; i < num_threads; ++i) {
+      threads_.emplace_back(&TestThreadPool::ThreadLoop, this);
+    }
+  }
+
+  ~TestThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      done_ = true;
+    }
+    cond_.notify_all();
+    for (std::thread &thread : threads_) thread.join();
+    RunQueued();
+  }
+
+  void RunQueued() {
+    for (;;) {
+      Task task;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (tasks_.empty()) return;
+        task = tasks_.front();
+        tasks_.pop_front();
+      }
+      task.first(task.second);
+    }
+  }
+
+  vpx_thread_pool_t *pool() { return &pool_; }
+  int num_submitted() const { return num_submitted_; }
+
+ private:
+  static int Submit(void *pool_priv, vpx_thread_pool_task_fn_t task,
+                    void *task_arg) {
+    TestThreadPool *const pool = static_cast<TestThreadPool *>(pool_priv);
+    {
+      std::lock_guard<std::mutex> lock(pool->mutex_);
+      pool->tasks_.push_back(Task(task, task_arg));
+      ++pool->num_submitted_;
+    }
+    pool->cond_.notify_one();
+    return 0;
+  }
+
+  void ThreadLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+      cond_.wait(lock, [this] { return done_ || !tasks_.empty(); });
+      if (tasks_.empty()) return;
+      const Task task = tasks_.front();
+      tasks_.pop_front();
+      lock.unlock();
+      task.first(task.second);
+      lock.lock();
+    }
+  }
+
+  vpx_thread_pool_t pool_;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::deque<Task> tasks_;
+  std::vector<std::thread> threads_;
+  bool done_;
+  int num_submitted_;
+};
+
+// Decodes with decoders that share a pool of 'GET_PARAM(1)' threads and
+// compares the output with a decoder that starts its own threads.
+class ThreadPoolTest : public ::libvpx_test::EncoderTest,
+                       public ::libvpx_test::CodecTestWithParam<int> {
+ protected:
+  static const int kNumPoolDecoders = 2;
+
+  ThreadPoolTest() : EncoderTest(GET_PARAM(0)), pool_(GET_PARAM(1)) {
+    vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+    cfg.threads = 4;
+    ref_dec_ = codec_->CreateDecoder(cfg, 0);
+    for (int i = 0; i < kNumPoolDecoders; ++i) {
+      pool_dec_[i] = codec_->CreateDecoder(cfg, 0);
+      pool_dec_[i]->Control(VP9D_SET_THREAD_POOL, pool_.pool());
+    }
+  }
+
+  ~ThreadPoolTest() override {
+    delete ref_dec_;
+    for (int i = 0; i < kNumPoolDecoders; ++i) delete pool_dec_[i];
+  }
+
+  void SetUp() override {
+    InitializeConfig();
+    SetMode(::libvpx_test::kRealTime);
+  }
+
+  void PreEncodeFrameHook(::libvpx_test::VideoSource *video,
+                          ::libvpx_test::Encoder *encoder) override {
+    if (video->frame() == 0) {
+      encoder->Control(VP8E_SET_CPUUSED, 7);
+      encoder->Control(VP9E_SET_TILE_COLUMNS, 2);
+    }
+  }
+
+  // All decoders are run from FramePktHook().
+  bool DoDecode() const override { return false; }
+
+  static std::string Decode(::libvpx_test::Decoder *dec,
+                            const vpx_codec_cx_pkt_t *pkt) {
+    const vpx_codec_err_t res = dec->DecodeFrame(
+        static_cast<const uint8_t *>(pkt->data.frame.buf), pkt->data.frame.sz);
+    EXPECT_EQ(VPX_CODEC_OK, res) << dec->DecodeError();
+    const vpx_image_t *const img = dec->GetDxData().Next();
+    if (res != VPX_CODEC_OK || img == nullptr) return "";
+    ::libvpx_test::MD5 md5;
+    md5.Add(img);
+    return md5.Get();
+  }
+
+  void FramePktHook(const vpx_codec_cx_pkt_t *pkt) override {
+    const std::string ref_md5 = Decode(ref_dec_, pkt);
+    ASSERT_FALSE(ref_md5.empty());
+    for (int i = 0; i < kNumPoolDecoders; ++i) {
+      EXPECT_EQ(ref_md5, Decode(pool_dec_[i], pkt))
+          << "Decoder " << i << " differs at frame " << pkt->data.frame.pts;
+    }
+    // Tasks left over by the decoders find nothing to do.
+    pool_.RunQueued();
+  }
+
+  TestThreadPool pool_;
+  ::libvpx_test::Decoder *ref_dec_;
+  ::libvpx_test::Decoder *pool_dec_[kNumPoolDecoders];
+};
+
+TEST_P(ThreadPoolTest, MatchesOwnThreads) {
+  cfg_.g_lag_in_frames = 0;
+  cfg_.rc_target_bitrate = 800;
+  cfg_.rc_end_usage = VPX_CBR;
+
+  ::libvpx_test::RandomVideoSource video;
+  video.SetSize(704, 288);
+  video.set_limit(10);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+#if CONFIG_MULTITHREAD
+  EXPECT_GT(pool_.num_submitted(), 0);
+#endif
+}
+
+#if CONFIG_MULTITHREAD
+// With no threads the decoders run all tasks themselves.
+VP9_INSTANTIATE_TEST_SUITE(ThreadPoolTest, ::testing::Values(0, 1, 3));
+#else
+VP9_INSTANTIATE_TEST_SUITE(ThreadPoolTest, ::testing::Values(0));
+#endif
+}  // namespace
@@ -148,14 +148,17 @@ TEST(VPxWorkerThreadTest, TestInterfaceAPI) {
 // -----------------------------------------------------------------------------
 // Multi-threaded decode tests
 #if CONFIG_WEBM_IO
-// Decodes |filename| with |num_threads|. Returns the md5 of the decoded frames.
-string DecodeFile(const string &filename, int num_threads) {
+// Decodes |filename| with |num_threads|, using frame-based multi-threading if
+// |frame_parallel| is set. Returns the md5 of the decoded frames.
+string DecodeFile(const string &filename, int num_threads,
+                  bool frame_parallel = false) {
   libvpx_test::WebMVideoSource video(filename);
   video.Init();
 
   vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
   cfg.threads = num_threads;
   libvpx_test::VP9Decoder decoder(cfg, 0);
+  if (frame_parallel) decoder.Control(VP9D_SET_FRAME_MT, 1);
 
   libvpx_test::MD5 md5;
   for (video.Begin(); video.cxdata(); video.Next()) {
@@ -174,6 +177,15 @@ string DecodeFile(const string &filename, int num_threads) {
       md5.Add(img);
     }
   }
+
+  // Frame-based multi-threading delays the output; flush the remaining frames.
+  const vpx_codec_err_t res = decoder.DecodeFrame(nullptr, 0);
+  EXPECT_EQ(VPX_CODEC_OK, res) << decoder.DecodeError();
+  libvpx_test::DxDataIterator dec_iter = decoder.GetDxData();
+  const vpx_image_t *img = nullptr;
+  while ((img = dec_iter.Next())) {
+    md5.Add(img);
+  }
   return string(md5.Get());
 }
 
@@ -232,6 +244,13 @@ TEST_P(VP9DecodeMultiThreadedTest, Decode) {
   }
 }
 
+TEST_P(VP9DecodeMultiThreadedTest, FrameParallelDecode) {
+  for (int t = 1; t <= 8; ++t) {
+    EXPECT_EQ(GetParam().expected_md5, DecodeFile(GetParam().name, t, true))
+        << "threads = " << t;
+  }
+}
+
 const FileParam kNoTilesNonFrameParallelFiles[] = {
   { "vp90-2-03-size-226x226.webm", "b35a1b707b28e82be025d960aba039bc" }
 };
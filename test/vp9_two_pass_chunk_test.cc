@@ -0,0 +1,211 @@
+/*
+ *  Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test/yuv_video_source.h"
+
+#include "./vpx_config.h"
+#include "vpx/vp8cx.h"
+#include "vpx/vpx_encoder.h"
+#if CONFIG_VP9_DECODER
+#include "vpx/vp8dx.h"
+#include "vpx/vpx_decoder.h"
+#endif
+
+namespace {
+
+const char kClip[] = "hantro_collage_w352h288.yuv";
+const int kWidth = 352;
+const int kHeight = 288;
+const int kNumFrames = 30;
+const int kNumChunks = 3;
+const int kChunkFrames = kNumFrames / kNumChunks;
+
+struct EncodeOutput {
+  std::vector<uint8_t> stats;
+  std::vector<std::vector<uint8_t>> frames;
+  std::vector<bool> key_frames;
+};
+
+vpx_codec_enc_cfg_t GetConfig() {
+  vpx_codec_enc_cfg_t cfg;
+  EXPECT_EQ(vpx_codec_enc_config_default(vpx_codec_vp9_cx(), &cfg, 0),
+            VPX_CODEC_OK);
+  cfg.g_w = kWidth;
+  cfg.g_h = kHeight;
+  cfg.g_timebase.num = 1;
+  cfg.g_timebase.den = 30;
+  cfg.rc_end_usage = VPX_VBR;
+  cfg.rc_target_bitrate = 1000;
+  cfg.kf_max_dist = kNumFrames;
+  return cfg;
+}
+
+// Encodes the frames [first_frame, first_frame + num_frames) of the clip. If
+// 'chunk' is set, they are encoded as a chunk of the whole clip.
+void Encode(const vpx_codec_enc_cfg_t &cfg, int first_frame, int num_frames,
+            bool chunk, EncodeOutput *output) {
+  vpx_codec_ctx_t enc;
+  ASSERT_EQ(vpx_codec_enc_init(&enc, vpx_codec_vp9_cx(), &cfg, 0),
+            VPX_CODEC_OK);
+  ASSERT_EQ(vpx_codec_control(&enc, VP8E_SET_CPUUSED, 4), VPX_CODEC_OK);
+  if (chunk) {
+    vpx_twopass_chunk_t twopass_chunk;
+    twopass_chunk.first_frame = first_frame;
+    twopass_chunk.num_frames = num_frames;
+    ASSERT_EQ(vpx_codec_control(&enc, VP9E_SET_TWO_PASS_CHUNK, &twopass_chunk),
+              VPX_CODEC_OK);
+  }
+
+  libvpx_test::YUVVideoSource video(kClip, VPX_IMG_FMT_I420, kWidth, kHeight,
+                                    30, 1, first_frame,
+                                    first_frame + num_frames);
+  video.Begin();
+  bool flushing = false;
+  bool got_data;
+  do {
+    flushing = video.img() == nullptr;
+    ASSERT_EQ(vpx_codec_encode(&enc, video.img(), video.pts(), 1, 0,
+                               VPX_DL_GOOD_QUALITY),
+              VPX_CODEC_OK)
+        << vpx_codec_error_detail(&enc);
+    vpx_codec_iter_t iter = nullptr;
+    const vpx_codec_cx_pkt_t *pkt;
+    got_data = false;
+    while ((pkt = vpx_codec_get_cx_data(&enc, &iter)) != nullptr) {
+      got_data = true;
+      if (pkt->kind == VPX_CODEC_STATS_PKT) {
+        const uint8_t *const buf =
+            static_cast<const uint8_t *>(pkt->data.twopass_stats.buf);
+        output->stats.insert(output->stats.end(), buf,
+                             buf + pkt->data.twopass_stats.sz);
+      } else if (pkt->kind == VPX_CODEC_CX_FRAME_PKT) {
+        const uint8_t *const buf =
+            static_cast<const uint8_t *>(pkt->data.frame.buf);
+        output->frames.emplace_back(buf, buf + pkt->data.frame.sz);
+        output->key_frames.push_back((pkt->data.frame.flags & VPX_FRAME_IS_KEY) !=
+                                     0);
+      }
+    }
+    if (!flushing) video.Next();
+  } while (!flushing || got_data);
+  ASSERT_EQ(vpx_codec_destroy(&enc), VPX_CODEC_OK);
+}
+
+size_t TotalSize(const EncodeOutput &output) {
+  size_t size = 0;
+  for (const std::vector<uint8_t> &frame : output.frames) size += frame.size();
+  return size;
+}
+
+TEST(VP9TwoPassChunkTest, ChunksEncodedAtOnceHitTheTarget) {
+  vpx_codec_enc_cfg_t cfg = GetConfig();
+  EncodeOutput first_pass;
+  cfg.g_pass = VPX_RC_FIRST_PASS;
+  ASSERT_NO_FATAL_FAILURE(Encode(cfg, 0, kNumFrames, false, &first_pass));
+  ASSERT_FALSE(first_pass.stats.empty());
+
+  cfg.g_pass = VPX_RC_LAST_PASS;
+  cfg.rc_twopass_stats_in.buf = first_pass.stats.data();
+  cfg.rc_twopass_stats_in.sz = first_pass.stats.size();
+
+  EncodeOutput sequence;
+  ASSERT_NO_FATAL_FAILURE(Encode(cfg, 0, kNumFrames, false, &sequence));
+  ASSERT_EQ(static_cast<size_t>(kNumFrames), sequence.frames.size());
+
+  // Each chunk has its own encoder and thread. The stats are shared.
+  EncodeOutput chunks[kNumChunks];
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumChunks; ++i) {
+    threads.emplace_back(Encode, cfg, i * kChunkFrames, kChunkFrames, true,
+                         &chunks[i]);
+  }
+  for (std::thread &thread : threads) thread.join();
+  if (HasFailure()) return;
+
+  EncodeOutput concatenated;
+  for (const EncodeOutput &chunk : chunks) {
+    ASSERT_EQ(static_cast<size_t>(kChunkFrames), chunk.frames.size());
+    EXPECT_TRUE(chunk.key_frames[0]);
+    concatenated.frames.insert(concatenated.frames.end(), chunk.frames.begin(),
+                               chunk.frames.end());
+  }
+
+  // The chunks share the budget of the whole clip as a single encode would.
+  // Each has its own key frame and little time to correct its rate, hence
+  // the tolerance.
+  const double sequence_size = static_cast<double>(TotalSize(sequence));
+  const double concatenated_size = static_cast<double>(TotalSize(concatenated));
+  EXPECT_NEAR(concatenated_size, sequence_size, 0.25 * sequence_size);
+
+#if CONFIG_VP9_DECODER
+  // The chunks decode as one stream.
+  vpx_codec_ctx_t dec;
+  ASSERT_EQ(vpx_codec_dec_init(&dec, vpx_codec_vp9_dx(), nullptr, 0),
+            VPX_CODEC_OK);
+  int num_decoded = 0;
+  for (const std::vector<uint8_t> &frame : concatenated.frames) {
+    ASSERT_EQ(vpx_codec_decode(&dec, frame.data(),
+                               static_cast<unsigned int>(frame.size()),
+                               nullptr, 0),
+              VPX_CODEC_OK);
+    vpx_codec_iter_t iter = nullptr;
+    while (vpx_codec_get_frame(&dec, &iter) != nullptr) ++num_decoded;
+  }
+  EXPECT_EQ(kNumFrames, num_decoded);
+  ASSERT_EQ(vpx_codec_destroy(&dec), VPX_CODEC_OK);
+#endif
+}
+
+TEST(VP9TwoPassChunkTest, RejectsInvalidChunks) {
+  vpx_codec_enc_cfg_t cfg = GetConfig();
+  EncodeOutput first_pass;
+  cfg.g_pass = VPX_RC_FIRST_PASS;
+  ASSERT_NO_FATAL_FAILURE(Encode(cfg, 0, kChunkFrames, false, &first_pass));
+
+  vpx_codec_ctx_t enc;
+  vpx_twopass_chunk_t chunk = { 0, kChunkFrames };
+  ASSERT_EQ(vpx_codec_enc_init(&enc, vpx_codec_vp9_cx(), &cfg, 0),
+            VPX_CODEC_OK);
+  // Not in the second pass.
+  EXPECT_EQ(vpx_codec_control(&enc, VP9E_SET_TWO_PASS_CHUNK, &chunk),
+            VPX_CODEC_INVALID_PARAM);
+  ASSERT_EQ(vpx_codec_destroy(&enc), VPX_CODEC_OK);
+
+  cfg.g_pass = VPX_RC_LAST_PASS;
+  cfg.rc_twopass_stats_in.buf = first_pass.stats.data();
+  cfg.rc_twopass_stats_in.sz = first_pass.stats.size();
+  ASSERT_EQ(vpx_codec_enc_init(&enc, vpx_codec_vp9_cx(), &cfg, 0),
+            VPX_CODEC_OK);
+  EXPECT_EQ(vpx_codec_control(&enc, VP9E_SET_TWO_PASS_CHUNK, nullptr),
+            VPX_CODEC_INVALID_PARAM);
+  // Past the end of the stats.
+  chunk.first_frame = 1;
+  EXPECT_EQ(vpx_codec_control(&enc, VP9E_SET_TWO_PASS_CHUNK, &chunk),
+            VPX_CODEC_INVALID_PARAM);
+  chunk.first_frame = 0;
+  chunk.num_frames = 0;
+  EXPECT_EQ(vpx_codec_control(&enc, VP9E_SET_TWO_PASS_CHUNK, &chunk),
+            VPX_CODEC_INVALID_PARAM);
+  chunk.num_frames = kChunkFrames / 2;
+  EXPECT_EQ(vpx_codec_control(&enc, VP9E_SET_TWO_PASS_CHUNK, &chunk),
+            VPX_CODEC_OK);
+  // Only once.
+  EXPECT_EQ(vpx_codec_control(&enc, VP9E_SET_TWO_PASS_CHUNK, &chunk),
+            VPX_CODEC_INVALID_PARAM);
+  ASSERT_EQ(vpx_codec_destroy(&enc), VPX_CODEC_OK);
+}
+
+}  // namespace
@@ -433,6 +433,31 @@ static void yv12_extend_frame_left_right_c(YV12_BUFFER_CONFIG *ybf,
   }
 }
 
+void vp8_report_rows_ready(VP8D_COMP *pbi, int mb_row) {
+  VP8_COMMON *const pc = &pbi->common;
+  int end = pc->Height;
+
+  if (pbi->rows_ready_cb == NULL || !pc->show_frame) return;
+
+  if (mb_row < pc->mb_rows) {
+    end = mb_row * 16;
+    /* Filtering the next row modifies up to 3 rows above it in each plane,
+     * i.e. up to 6 luma rows with vertically subsampled chroma. */
+    if (pc->filter_level) end -= 8;
+    end = VPXMIN(end, pc->Height);
+  }
+
+  if (end > pbi->rows_ready) {
+    /* Crop the frame as vp8dx_get_raw_frame() does. */
+    YV12_BUFFER_CONFIG buf = *pbi->dec_fb_ref[INTRA_FRAME];
+    buf.y_width = pc->Width;
+    buf.y_height = pc->Height;
+    buf.uv_height = pc->Height / 2;
+    pbi->rows_ready_cb(pbi->rows_ready_priv, &buf, pbi->rows_ready, end);
+    pbi->rows_ready = end;
+  }
+}
+
 static void decode_mb_rows(VP8D_COMP *pbi) {
   VP8_COMMON *const pc = &pbi->common;
   MACROBLOCKD *const xd = &pbi->mb;
@@ -626,6 +651,7 @@ static void decode_mb_rows(VP8D_COMP *pbi) {
         lf_dst[2] += recon_uv_stride * 8;
         lf_mic += pc->mb_cols;
         lf_mic++; /* Skip border mb */
+        vp8_report_rows_ready(pbi, mb_row);
       }
     } else {
       if (mb_row > 0) {
@@ -636,6 +662,7 @@ static void decode_mb_rows(VP8D_COMP *pbi) {
         eb_dst[1] += recon_uv_stride * 8;
         eb_dst[2] += recon_uv_stride * 8;
       }
+      vp8_report_rows_ready(pbi, mb_row + 1);
     }
   }
 
@@ -1038,6 +1065,7 @@ int vp8_decode_frame(VP8D_COMP *pbi) {
   /* Read the loop filter level and type */
   pc->filter_type = (LOOPFILTERTYPE)vp8_read_bit(bc);
   pc->filter_level = vp8_read_literal(bc, 6);
+  if (pbi->skip_loop_filter) pc->filter_level = 0;
   pc->sharpness_level = vp8_read_literal(bc, 3);
 
   /* Read in loop filter deltas applied at the MB level based on mode or ref
@@ -1205,6 +1233,7 @@ int vp8_decode_frame(VP8D_COMP *pbi) {
 
   memset(pc->above_context, 0, sizeof(ENTROPY_CONTEXT_PLANES) * pc->mb_cols);
   pbi->frame_corrupt_residual = 0;
+  pbi->rows_ready = 0;
 
 #if CONFIG_MULTITHREAD
   if (vpx_atomic_load_acquire(&pbi->b_multithreaded_rd) &&
@@ -1225,6 +1254,7 @@ int vp8_decode_frame(VP8D_COMP *pbi) {
     decode_mb_rows(pbi);
     corrupt_tokens |= xd->corrupted;
   }
+  vp8_report_rows_ready(pbi, pc->mb_rows);
 
   /* Collect information about decoder corruption. */
   /* 1. Check first boolean decoder for errors. */
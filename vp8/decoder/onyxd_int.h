@@ -117,6 +117,8 @@ typedef struct VP8D_COMP {
   int decoded_key_frame;
   int independent_partitions;
   int frame_corrupt_residual;
+  /* Decode frames without applying the loop filter. */
+  int skip_loop_filter;
 
   vpx_decrypt_cb decrypt_cb;
   void *decrypt_state;
@@ -126,11 +128,22 @@ typedef struct VP8D_COMP {
   // are shut down.
   int restart_threads;
 #endif
+
+  /* If set, called from top to bottom with the luma rows [start, end) of each
+   * shown frame that no longer change while it is decoded. 'rows_ready' rows
+   * of the current frame have been reported. */
+  void (*rows_ready_cb)(void *priv, const YV12_BUFFER_CONFIG *buf, int start,
+                        int end);
+  void *rows_ready_priv;
+  int rows_ready;
 } VP8D_COMP;
 
 void vp8cx_init_de_quantizer(VP8D_COMP *pbi);
 void vp8_mb_init_dequantizer(VP8D_COMP *pbi, MACROBLOCKD *xd);
 int vp8_decode_frame(VP8D_COMP *pbi);
+/* Reports the rows of the frame above macroblock row 'mb_row' once all of
+ * them are reconstructed and filtered. */
+void vp8_report_rows_ready(VP8D_COMP *pbi, int mb_row);
 
 int vp8_create_decoder_instances(struct frame_buffers *fb, VP8D_CONFIG *oxcf);
 int vp8_remove_decoder_instances(struct frame_buffers *fb);
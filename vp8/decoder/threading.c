@@ -260,6 +260,8 @@ static void mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd,
       VPX_ATOMIC_INIT(pc->mb_cols + nsync);
   int num_part = 1 << pbi->common.multi_token_partition;
   int last_mb_row = start_mb_row;
+  /* Rows from the top of the frame all threads have finished. */
+  int mb_rows_done = 0;
 
   YV12_BUFFER_CONFIG *yv12_fb_new = pbi->dec_fb_ref[INTRA_FRAME];
   YV12_BUFFER_CONFIG *yv12_fb_lst = pbi->dec_fb_ref[LAST_FRAME];
@@ -569,6 +571,16 @@ static void mt_decode_mb_rows(VP8D_COMP *pbi, MACROBLOCKD *xd,
     /* last MB of row is ready just after extension is done */
     vpx_atomic_store_release(current_mb_col, mb_col + nsync);
 
+    /* The main thread reports the rows finished by all threads. */
+    if (start_mb_row == 0 && pbi->rows_ready_cb != NULL) {
+      while (mb_rows_done < pc->mb_rows &&
+             vpx_atomic_load_acquire(&pbi->mt_current_mb_col[mb_rows_done]) >=
+                 pc->mb_cols + nsync) {
+        ++mb_rows_done;
+      }
+      vp8_report_rows_ready(pbi, mb_rows_done);
+    }
+
     ++xd->mode_info_context; /* skip prediction column */
     xd->up_available = 1;
 
@@ -54,6 +54,8 @@ struct vpx_codec_alg_priv {
 #endif
   int postproc_cfg_set;
   vp8_postproc_cfg_t postproc_cfg;
+  /* 2 also skips the loop filter and postproc. */
+  int keyframe_only;
   vpx_decrypt_cb decrypt_cb;
   void *decrypt_state;
   vpx_image_t img;
@@ -236,6 +238,25 @@ static void yuvconfig2image(vpx_image_t *img, const YV12_BUFFER_CONFIG *yv12,
   img->self_allocd = 0;
 }
 
+/* Passes the rows of the frame being decoded that are final to the put_slice
+ * callback. */
+static void put_slice_rows(void *priv, const YV12_BUFFER_CONFIG *buf,
+                           int start, int end) {
+  vpx_codec_alg_priv_t *const ctx = (vpx_codec_alg_priv_t *)priv;
+  const vpx_codec_priv_cb_pair_t *const cb = &ctx->base.dec.put_slice_cb;
+  vpx_image_t img;
+  vpx_image_rect_t valid, update;
+  yuvconfig2image(&img, buf, ctx->user_priv);
+  valid.x = 0;
+  valid.y = 0;
+  valid.w = img.d_w;
+  valid.h = end;
+  update = valid;
+  update.y = start;
+  update.h = end - start;
+  cb->u.put_slice(cb->user_priv, &img, &valid, &update);
+}
+
 static int update_fragments(vpx_codec_alg_priv_t *ctx, const uint8_t *data,
                             unsigned int data_sz,
                             volatile vpx_codec_err_t *res) {
@@ -304,6 +325,12 @@ static vpx_codec_err_t vp8_decode(vpx_codec_alg_priv_t *ctx,
     res = VPX_CODEC_OK;
   }
 
+  if (ctx->keyframe_only && !ctx->si.is_kf) {
+    /* Drop the frame without decoding it. */
+    ctx->fragments.count = 0;
+    return res;
+  }
+
   if (!ctx->decoder_init && !ctx->si.is_kf) res = VPX_CODEC_UNSUP_BITSTREAM;
   if (!res && ctx->decoder_init && w == 0 && h == 0 && ctx->si.h == 0 &&
       ctx->si.w == 0) {
@@ -378,6 +405,7 @@ static vpx_codec_err_t vp8_decode(vpx_codec_alg_priv_t *ctx,
   if (ctx->decoder_init) {
     ctx->yv12_frame_buffers.pbi[0]->decrypt_cb = ctx->decrypt_cb;
     ctx->yv12_frame_buffers.pbi[0]->decrypt_state = ctx->decrypt_state;
+    ctx->yv12_frame_buffers.pbi[0]->skip_loop_filter = ctx->keyframe_only > 1;
   }
 
   if (!res) {
@@ -508,6 +536,12 @@ static vpx_codec_err_t vp8_decode(vpx_codec_alg_priv_t *ctx,
     pbi->restart_threads = 0;
 #endif
     ctx->user_priv = user_priv;
+    /* Slices are reported unless the frame is postprocessed after decoding. */
+    pbi->rows_ready_cb = (ctx->base.dec.put_slice_cb.u.put_slice != NULL &&
+                          !(ctx->base.init_flags & VPX_CODEC_USE_POSTPROC))
+                             ? put_slice_rows
+                             : NULL;
+    pbi->rows_ready_priv = ctx;
     if (vp8dx_receive_compressed_data(pbi)) {
       res = update_error_state(ctx, &pbi->common.error);
     }
@@ -532,7 +566,8 @@ static vpx_image_t *vp8_get_frame(vpx_codec_alg_priv_t *ctx,
     vp8_ppflags_t flags;
     vp8_zero(flags);
 
-    if (ctx->base.init_flags & VPX_CODEC_USE_POSTPROC) {
+    if ((ctx->base.init_flags & VPX_CODEC_USE_POSTPROC) &&
+        ctx->keyframe_only < 2) {
       flags.post_proc_flag = ctx->postproc_cfg.post_proc_flag;
       flags.deblocking_level = ctx->postproc_cfg.deblocking_level;
       flags.noise_level = ctx->postproc_cfg.noise_level;
@@ -708,6 +743,15 @@ static vpx_codec_err_t vp8_set_decryptor(vpx_codec_alg_priv_t *ctx,
   return VPX_CODEC_OK;
 }
 
+static vpx_codec_err_t vp8_set_keyframe_only(vpx_codec_alg_priv_t *ctx,
+                                             va_list args) {
+  const int keyframe_only = va_arg(args, int);
+
+  if (keyframe_only < 0 || keyframe_only > 2) return VPX_CODEC_INVALID_PARAM;
+  ctx->keyframe_only = keyframe_only;
+  return VPX_CODEC_OK;
+}
+
 static vpx_codec_ctrl_fn_map_t vp8_ctf_maps[] = {
   { VP8_SET_REFERENCE, vp8_set_reference },
   { VP8_COPY_REFERENCE, vp8_get_reference },
@@ -717,6 +761,7 @@ static vpx_codec_ctrl_fn_map_t vp8_ctf_maps[] = {
   { VP8D_GET_LAST_REF_USED, vp8_get_last_ref_frame },
   { VPXD_GET_LAST_QUANTIZER, vp8_get_quantizer },
   { VPXD_SET_DECRYPTOR, vp8_set_decryptor },
+  { VPXD_SET_KEYFRAME_ONLY, vp8_set_keyframe_only },
   { -1, NULL },
 };
 
@@ -727,7 +772,7 @@ CODEC_INTERFACE(vpx_codec_vp8_dx) = {
   "WebM Project VP8 Decoder" VERSION_STRING,
   VPX_CODEC_INTERNAL_ABI_VERSION,
   VPX_CODEC_CAP_DECODER | VP8_CAP_POSTPROC | VP8_CAP_ERROR_CONCEALMENT |
-      VPX_CODEC_CAP_INPUT_FRAGMENTS,
+      VPX_CODEC_CAP_INPUT_FRAGMENTS | VPX_CODEC_CAP_PUT_SLICE,
   /* vpx_codec_caps_t          caps; */
   vp8_init,     /* vpx_codec_init_fn_t       init; */
   vp8_destroy,  /* vpx_codec_destroy_fn_t    destroy; */
@@ -112,17 +112,22 @@ void vp9_free_context_buffers(VP9_COMMON *cm) {
   cm->above_context_alloc_cols = 0;
   vpx_free(cm->lf.lfm);
   cm->lf.lfm = NULL;
+  vpx_free(cm->lf.lfm_key);
+  cm->lf.lfm_key = NULL;
 }
 
 int vp9_alloc_loop_filter(VP9_COMMON *cm) {
+  const int lfm_rows = (cm->mi_rows + (MI_BLOCK_SIZE - 1)) >> 3;
   vpx_free(cm->lf.lfm);
+  vpx_free(cm->lf.lfm_key);
   // Each lfm holds bit masks for all the 8x8 blocks in a 64x64 region.  The
   // stride and rows are rounded up / truncated to a multiple of 8.
   cm->lf.lfm_stride = (cm->mi_cols + (MI_BLOCK_SIZE - 1)) >> 3;
-  cm->lf.lfm = (LOOP_FILTER_MASK *)vpx_calloc(
-      ((cm->mi_rows + (MI_BLOCK_SIZE - 1)) >> 3) * cm->lf.lfm_stride,
-      sizeof(*cm->lf.lfm));
-  if (!cm->lf.lfm) return 1;
+  cm->lf.lfm = (LOOP_FILTER_MASK *)vpx_calloc(lfm_rows * cm->lf.lfm_stride,
+                                              sizeof(*cm->lf.lfm));
+  cm->lf.lfm_key = (LOOP_FILTER_MASK_KEY *)vpx_calloc(
+      lfm_rows * cm->lf.lfm_stride, sizeof(*cm->lf.lfm_key));
+  if (!cm->lf.lfm || !cm->lf.lfm_key) return 1;
   return 0;
 }
 
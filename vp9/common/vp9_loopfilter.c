@@ -649,13 +649,12 @@ static void highbd_filter_selectively_horiz(
 // whether there were any coefficients encoded, and the loop filter strength
 // block we are currently looking at. Shift is used to position the
 // 1's we produce.
-static void build_masks(const loop_filter_info_n *const lfi_n,
-                        const MODE_INFO *mi, const int shift_y,
-                        const int shift_uv, LOOP_FILTER_MASK *lfm) {
+static void build_masks(const MODE_INFO *mi, const int filter_level,
+                        const int shift_y, const int shift_uv,
+                        LOOP_FILTER_MASK *lfm) {
   const BLOCK_SIZE block_size = mi->sb_type;
   const TX_SIZE tx_size_y = mi->tx_size;
   const TX_SIZE tx_size_uv = uv_txsize_lookup[block_size][tx_size_y][1][1];
-  const int filter_level = get_filter_level(lfi_n, mi);
   uint64_t *const left_y = &lfm->left_y[tx_size_y];
   uint64_t *const above_y = &lfm->above_y[tx_size_y];
   uint64_t *const int_4x4_y = &lfm->int_4x4_y;
@@ -726,12 +725,10 @@ static void build_masks(const loop_filter_info_n *const lfi_n,
 // This function does the same thing as the one above with the exception that
 // it only affects the y masks. It exists because for blocks < 16x16 in size,
 // we only update u and v masks on the first block.
-static void build_y_mask(const loop_filter_info_n *const lfi_n,
-                         const MODE_INFO *mi, const int shift_y,
-                         LOOP_FILTER_MASK *lfm) {
+static void build_y_mask(const MODE_INFO *mi, const int filter_level,
+                         const int shift_y, LOOP_FILTER_MASK *lfm) {
   const BLOCK_SIZE block_size = mi->sb_type;
   const TX_SIZE tx_size_y = mi->tx_size;
-  const int filter_level = get_filter_level(lfi_n, mi);
   uint64_t *const left_y = &lfm->left_y[tx_size_y];
   uint64_t *const above_y = &lfm->above_y[tx_size_y];
   uint64_t *const int_4x4_y = &lfm->int_4x4_y;
@@ -851,11 +848,13 @@ void vp9_adjust_mask(VP9_COMMON *const cm, const int mi_row, const int mi_col,
   }
   // We don't apply a loop filter on the first column in the image, mask that
   // out.
-  if (mi_col == 0) {
+  if (mi_col == cm->lf.mi_col_start) {
     for (i = 0; i < TX_32X32; i++) {
       lfm->left_y[i] &= 0xfefefefefefefefeULL;
       lfm->left_uv[i] &= 0xeeee;
     }
+    // The mask no longer matches the mode info it was built from.
+    if (mi_col != 0) get_lfm_key(&cm->lf, mi_row, mi_col)->num_blocks = 0;
   }
 
   // Assert if we try to apply 2 different loop filters at the same position.
@@ -877,13 +876,32 @@ void vp9_adjust_mask(VP9_COMMON *const cm, const int mi_row, const int mi_col,
   assert(!(lfm->int_4x4_uv & lfm->above_uv[TX_16X16]));
 }
 
-// This function sets up the bit masks for the entire 64x64 region represented
-// by mi_row, mi_col.
-void vp9_setup_mask(VP9_COMMON *const cm, const int mi_row, const int mi_col,
-                    MODE_INFO **mi8x8, const int mode_info_stride,
-                    LOOP_FILTER_MASK *lfm) {
+typedef struct {
+  const MODE_INFO *mi;
+  uint8_t shift_y;
+  uint8_t shift_uv;
+  // Set for the blocks after the first one in a 16x16 area, which only
+  // contribute to the y masks.
+  uint8_t y_only;
+} MASK_BLOCK;
+
+static INLINE void add_mask_block(MASK_BLOCK *blocks, int *num_blocks,
+                                  const MODE_INFO *mi, int shift_y,
+                                  int shift_uv, int y_only) {
+  MASK_BLOCK *const block = &blocks[(*num_blocks)++];
+  block->mi = mi;
+  block->shift_y = shift_y;
+  block->shift_uv = shift_uv;
+  block->y_only = y_only;
+}
+
+// Lists the blocks of the 64x64 region at mi_row, mi_col that make up its
+// loop filter mask, and returns their number.
+static int get_mask_blocks(MODE_INFO **mi8x8, const int mode_info_stride,
+                           const int max_rows, const int max_cols,
+                           MASK_BLOCK blocks[MI_BLOCK_SIZE * MI_BLOCK_SIZE]) {
   int idx_32, idx_16, idx_8;
-  const loop_filter_info_n *const lfi_n = &cm->lf_info;
+  int n = 0;
   MODE_INFO **mip = mi8x8;
   MODE_INFO **mip2 = mi8x8;
 
@@ -906,29 +924,21 @@ void vp9_setup_mask(VP9_COMMON *const cm, const int mi_row, const int mi_col,
   const int shift_8_y[] = { 0, 1, 8, 9 };
   const int shift_32_uv[] = { 0, 2, 8, 10 };
   const int shift_16_uv[] = { 0, 1, 4, 5 };
-  const int max_rows =
-      (mi_row + MI_BLOCK_SIZE > cm->mi_rows ? cm->mi_rows - mi_row
-                                            : MI_BLOCK_SIZE);
-  const int max_cols =
-      (mi_col + MI_BLOCK_SIZE > cm->mi_cols ? cm->mi_cols - mi_col
-                                            : MI_BLOCK_SIZE);
-
-  vp9_zero(*lfm);
   assert(mip[0] != NULL);
 
   switch (mip[0]->sb_type) {
-    case BLOCK_64X64: build_masks(lfi_n, mip[0], 0, 0, lfm); break;
+    case BLOCK_64X64: add_mask_block(blocks, &n, mip[0], 0, 0, 0); break;
     case BLOCK_64X32:
-      build_masks(lfi_n, mip[0], 0, 0, lfm);
+      add_mask_block(blocks, &n, mip[0], 0, 0, 0);
       mip2 = mip + mode_info_stride * 4;
       if (4 >= max_rows) break;
-      build_masks(lfi_n, mip2[0], 32, 8, lfm);
+      add_mask_block(blocks, &n, mip2[0], 32, 8, 0);
       break;
     case BLOCK_32X64:
-      build_masks(lfi_n, mip[0], 0, 0, lfm);
+      add_mask_block(blocks, &n, mip[0], 0, 0, 0);
       mip2 = mip + 4;
       if (4 >= max_cols) break;
-      build_masks(lfi_n, mip2[0], 4, 2, lfm);
+      add_mask_block(blocks, &n, mip2[0], 4, 2, 0);
       break;
     default:
       for (idx_32 = 0; idx_32 < 4; mip += offset_32[idx_32], ++idx_32) {
@@ -940,19 +950,21 @@ void vp9_setup_mask(VP9_COMMON *const cm, const int mi_row, const int mi_col,
           continue;
         switch (mip[0]->sb_type) {
           case BLOCK_32X32:
-            build_masks(lfi_n, mip[0], shift_y_32, shift_uv_32, lfm);
+            add_mask_block(blocks, &n, mip[0], shift_y_32, shift_uv_32, 0);
             break;
           case BLOCK_32X16:
-            build_masks(lfi_n, mip[0], shift_y_32, shift_uv_32, lfm);
+            add_mask_block(blocks, &n, mip[0], shift_y_32, shift_uv_32, 0);
             if (mi_32_row_offset + 2 >= max_rows) continue;
             mip2 = mip + mode_info_stride * 2;
-            build_masks(lfi_n, mip2[0], shift_y_32 + 16, shift_uv_32 + 4, lfm);
+            add_mask_block(blocks, &n, mip2[0], shift_y_32 + 16,
+                           shift_uv_32 + 4, 0);
             break;
           case BLOCK_16X32:
-            build_masks(lfi_n, mip[0], shift_y_32, shift_uv_32, lfm);
+            add_mask_block(blocks, &n, mip[0], shift_y_32, shift_uv_32, 0);
             if (mi_32_col_offset + 2 >= max_cols) continue;
             mip2 = mip + 2;
-            build_masks(lfi_n, mip2[0], shift_y_32 + 2, shift_uv_32 + 1, lfm);
+            add_mask_block(blocks, &n, mip2[0], shift_y_32 + 2,
+                           shift_uv_32 + 1, 0);
             break;
           default:
             for (idx_16 = 0; idx_16 < 4; mip += offset_16[idx_16], ++idx_16) {
@@ -968,23 +980,27 @@ void vp9_setup_mask(VP9_COMMON *const cm, const int mi_row, const int mi_col,
 
               switch (mip[0]->sb_type) {
                 case BLOCK_16X16:
-                  build_masks(lfi_n, mip[0], shift_y_16, shift_uv_16, lfm);
+                  add_mask_block(blocks, &n, mip[0], shift_y_16, shift_uv_16,
+                                 0);
                   break;
                 case BLOCK_16X8:
-                  build_masks(lfi_n, mip[0], shift_y_16, shift_uv_16, lfm);
+                  add_mask_block(blocks, &n, mip[0], shift_y_16, shift_uv_16,
+                                 0);
                   if (mi_16_row_offset + 1 >= max_rows) continue;
                   mip2 = mip + mode_info_stride;
-                  build_y_mask(lfi_n, mip2[0], shift_y_16 + 8, lfm);
+                  add_mask_block(blocks, &n, mip2[0], shift_y_16 + 8, 0, 1);
                   break;
                 case BLOCK_8X16:
-                  build_masks(lfi_n, mip[0], shift_y_16, shift_uv_16, lfm);
+                  add_mask_block(blocks, &n, mip[0], shift_y_16, shift_uv_16,
+                                 0);
                   if (mi_16_col_offset + 1 >= max_cols) continue;
                   mip2 = mip + 1;
-                  build_y_mask(lfi_n, mip2[0], shift_y_16 + 1, lfm);
+                  add_mask_block(blocks, &n, mip2[0], shift_y_16 + 1, 0, 1);
                   break;
                 default: {
                   const int shift_y_8_0 = shift_y_16 + shift_8_y[0];
-                  build_masks(lfi_n, mip[0], shift_y_8_0, shift_uv_16, lfm);
+                  add_mask_block(blocks, &n, mip[0], shift_y_8_0,
+                                 shift_uv_16, 0);
                   mip += offset[0];
                   for (idx_8 = 1; idx_8 < 4; mip += offset[idx_8], ++idx_8) {
                     const int shift_y_8 = shift_y_16 + shift_8_y[idx_8];
@@ -996,7 +1012,7 @@ void vp9_setup_mask(VP9_COMMON *const cm, const int mi_row, const int mi_col,
                     if (mi_8_col_offset >= max_cols ||
                         mi_8_row_offset >= max_rows)
                       continue;
-                    build_y_mask(lfi_n, mip[0], shift_y_8, lfm);
+                    add_mask_block(blocks, &n, mip[0], shift_y_8, 0, 1);
                   }
                   break;
                 }
@@ -1007,6 +1023,62 @@ void vp9_setup_mask(VP9_COMMON *const cm, const int mi_row, const int mi_col,
       }
       break;
   }
+  return n;
+}
+
+// The mode info fields that build_masks() and build_y_mask() depend on.
+static INLINE uint16_t get_mask_key(const MODE_INFO *mi, int filter_level) {
+  const int skip_border = mi->skip && is_inter_block(mi);
+  return mi->sb_type | (mi->tx_size << 4) | (skip_border << 6) |
+         (filter_level << 7);
+}
+
+void vp9_setup_mask(VP9_COMMON *const cm, const int mi_row, const int mi_col) {
+  const loop_filter_info_n *const lfi_n = &cm->lf_info;
+  LOOP_FILTER_MASK *const lfm = get_lfm(&cm->lf, mi_row, mi_col);
+  LOOP_FILTER_MASK_KEY *const key = get_lfm_key(&cm->lf, mi_row, mi_col);
+  const int max_rows =
+      (mi_row + MI_BLOCK_SIZE > cm->mi_rows ? cm->mi_rows - mi_row
+                                            : MI_BLOCK_SIZE);
+  const int max_cols =
+      (mi_col + MI_BLOCK_SIZE > cm->mi_cols ? cm->mi_cols - mi_col
+                                            : MI_BLOCK_SIZE);
+  MASK_BLOCK blocks[MI_BLOCK_SIZE * MI_BLOCK_SIZE];
+  uint16_t block_key[MI_BLOCK_SIZE * MI_BLOCK_SIZE];
+  uint8_t filter_level[MI_BLOCK_SIZE * MI_BLOCK_SIZE];
+  const int num_blocks = get_mask_blocks(
+      cm->mi_grid_visible + mi_row * cm->mi_stride + mi_col, cm->mi_stride,
+      max_rows, max_cols, blocks);
+  int i;
+
+  for (i = 0; i < num_blocks; ++i) {
+    filter_level[i] = get_filter_level(lfi_n, blocks[i].mi);
+    block_key[i] = get_mask_key(blocks[i].mi, filter_level[i]);
+  }
+
+  // The visited blocks, and so the shifts, follow from the block sizes, so
+  // an unchanged key means an unchanged mask.
+  if (key->num_blocks == num_blocks && key->max_rows == max_rows &&
+      key->max_cols == max_cols &&
+      !memcmp(key->block, block_key, num_blocks * sizeof(block_key[0]))) {
+    return;
+  }
+
+  vp9_zero(*lfm);
+  for (i = 0; i < num_blocks; ++i) {
+    const MASK_BLOCK *const block = &blocks[i];
+    if (block->y_only) {
+      build_y_mask(block->mi, filter_level[i], block->shift_y, lfm);
+    } else {
+      build_masks(block->mi, filter_level[i], block->shift_y, block->shift_uv,
+                  lfm);
+    }
+  }
+
+  key->num_blocks = num_blocks;
+  key->max_rows = max_rows;
+  key->max_cols = max_cols;
+  memcpy(key->block, block_key, num_blocks * sizeof(block_key[0]));
 }
 
 static void filter_selectively_vert(
@@ -1178,7 +1250,7 @@ void vp9_filter_block_plane_non420(VP9_COMMON *cm,
     }
 
     // Disable filtering on the leftmost column
-    border_mask = ~(mi_col == 0 ? 1u : 0u);
+    border_mask = ~(mi_col == cm->lf.mi_col_start ? 1u : 0u);
 #if CONFIG_VP9_HIGHBITDEPTH
     if (cm->use_highbitdepth) {
       highbd_filter_selectively_vert(
@@ -1419,53 +1491,74 @@ void vp9_filter_block_plane_ss11(VP9_COMMON *const cm,
   }
 }
 
-static void loop_filter_rows(YV12_BUFFER_CONFIG *frame_buffer, VP9_COMMON *cm,
-                             struct macroblockd_plane planes[MAX_MB_PLANE],
-                             int start, int stop, int y_only) {
-  const int num_planes = y_only ? 1 : MAX_MB_PLANE;
-  enum lf_path path;
-  int mi_row, mi_col;
-
+static enum lf_path get_lf_path(const struct macroblockd_plane *planes,
+                                int y_only) {
   if (y_only)
-    path = LF_PATH_444;
+    return LF_PATH_444;
   else if (planes[1].subsampling_y == 1 && planes[1].subsampling_x == 1)
-    path = LF_PATH_420;
+    return LF_PATH_420;
   else if (planes[1].subsampling_y == 0 && planes[1].subsampling_x == 0)
-    path = LF_PATH_444;
+    return LF_PATH_444;
   else
-    path = LF_PATH_SLOW;
-
-  for (mi_row = start; mi_row < stop; mi_row += MI_BLOCK_SIZE) {
-    MODE_INFO **mi = cm->mi_grid_visible + mi_row * cm->mi_stride;
-    LOOP_FILTER_MASK *lfm = get_lfm(&cm->lf, mi_row, 0);
-
-    for (mi_col = 0; mi_col < cm->mi_cols; mi_col += MI_BLOCK_SIZE, ++lfm) {
-      int plane;
-
-      vp9_setup_dst_planes(planes, frame_buffer, mi_row, mi_col);
-
-      // TODO(jimbankoski): For 444 only need to do y mask.
-      vp9_adjust_mask(cm, mi_row, mi_col, lfm);
+    return LF_PATH_SLOW;
+}
 
-      vp9_filter_block_plane_ss00(cm, &planes[0], mi_row, lfm);
-      for (plane = 1; plane < num_planes; ++plane) {
-        switch (path) {
-          case LF_PATH_420:
-            vp9_filter_block_plane_ss11(cm, &planes[plane], mi_row, lfm);
-            break;
-          case LF_PATH_444:
-            vp9_filter_block_plane_ss00(cm, &planes[plane], mi_row, lfm);
-            break;
-          case LF_PATH_SLOW:
-            vp9_filter_block_plane_non420(cm, &planes[plane], mi + mi_col,
-                                          mi_row, mi_col);
-            break;
-        }
+static void loop_filter_sb_cols(YV12_BUFFER_CONFIG *frame_buffer,
+                                VP9_COMMON *cm,
+                                struct macroblockd_plane planes[MAX_MB_PLANE],
+                                int mi_row, int mi_col_start, int mi_col_end,
+                                int y_only) {
+  const int num_planes = y_only ? 1 : MAX_MB_PLANE;
+  const enum lf_path path = get_lf_path(planes, y_only);
+  MODE_INFO **mi = cm->mi_grid_visible + mi_row * cm->mi_stride;
+  LOOP_FILTER_MASK *lfm = get_lfm(&cm->lf, mi_row, mi_col_start);
+  int mi_col;
+
+  for (mi_col = mi_col_start; mi_col < mi_col_end;
+       mi_col += MI_BLOCK_SIZE, ++lfm) {
+    int plane;
+
+    vp9_setup_dst_planes(planes, frame_buffer, mi_row, mi_col);
+
+    // TODO(jimbankoski): For 444 only need to do y mask.
+    vp9_adjust_mask(cm, mi_row, mi_col, lfm);
+
+    vp9_filter_block_plane_ss00(cm, &planes[0], mi_row, lfm);
+    for (plane = 1; plane < num_planes; ++plane) {
+      switch (path) {
+        case LF_PATH_420:
+          vp9_filter_block_plane_ss11(cm, &planes[plane], mi_row, lfm);
+          break;
+        case LF_PATH_444:
+          vp9_filter_block_plane_ss00(cm, &planes[plane], mi_row, lfm);
+          break;
+        case LF_PATH_SLOW:
+          vp9_filter_block_plane_non420(cm, &planes[plane], mi + mi_col,
+                                        mi_row, mi_col);
+          break;
       }
     }
   }
 }
 
+static void loop_filter_rows(YV12_BUFFER_CONFIG *frame_buffer, VP9_COMMON *cm,
+                             struct macroblockd_plane planes[MAX_MB_PLANE],
+                             int start, int stop, int y_only) {
+  int mi_row;
+
+  for (mi_row = start; mi_row < stop; mi_row += MI_BLOCK_SIZE) {
+    loop_filter_sb_cols(frame_buffer, cm, planes, mi_row, 0, cm->mi_cols,
+                        y_only);
+  }
+}
+
+void vp9_loop_filter_sb_cols(YV12_BUFFER_CONFIG *frame_buffer, VP9_COMMON *cm,
+                             struct macroblockd_plane planes[MAX_MB_PLANE],
+                             int mi_row, int mi_col_start, int mi_col_end) {
+  loop_filter_sb_cols(frame_buffer, cm, planes, mi_row, mi_col_start,
+                      mi_col_end, 0);
+}
+
 void vp9_loop_filter_frame(YV12_BUFFER_CONFIG *frame, VP9_COMMON *cm,
                            MACROBLOCKD *xd, int frame_filter_level, int y_only,
                            int partial_frame) {
@@ -1502,107 +1595,10 @@ void vp9_build_mask_frame(VP9_COMMON *cm, int frame_filter_level,
   vp9_loop_filter_frame_init(cm, frame_filter_level);
 
   for (mi_row = start_mi_row; mi_row < end_mi_row; mi_row += MI_BLOCK_SIZE) {
-    MODE_INFO **mi = cm->mi_grid_visible + mi_row * cm->mi_stride;
     for (mi_col = 0; mi_col < cm->mi_cols; mi_col += MI_BLOCK_SIZE) {
-      // vp9_setup_mask() zeros lfm
-      vp9_setup_mask(cm, mi_row, mi_col, mi + mi_col, cm->mi_stride,
-                     get_lfm(&cm->lf, mi_row, mi_col));
-    }
-  }
-}
-
-// 8x8 blocks in a superblock.  A "1" represents the first block in a 16x16
-// or greater area.
-static const uint8_t first_block_in_16x16[8][8] = {
-  { 1, 0, 1, 0, 1, 0, 1, 0 }, { 0, 0, 0, 0, 0, 0, 0, 0 },
-  { 1, 0, 1, 0, 1, 0, 1, 0 }, { 0, 0, 0, 0, 0, 0, 0, 0 },
-  { 1, 0, 1, 0, 1, 0, 1, 0 }, { 0, 0, 0, 0, 0, 0, 0, 0 },
-  { 1, 0, 1, 0, 1, 0, 1, 0 }, { 0, 0, 0, 0, 0, 0, 0, 0 }
-};
-
-// This function sets up the bit masks for a block represented
-// by mi_row, mi_col in a 64x64 region.
-// TODO(SJL): This function only works for yv12.
-void vp9_build_mask(VP9_COMMON *cm, const MODE_INFO *mi, int mi_row, int mi_col,
-                    int bw, int bh) {
-  const BLOCK_SIZE block_size = mi->sb_type;
-  const TX_SIZE tx_size_y = mi->tx_size;
-  const loop_filter_info_n *const lfi_n = &cm->lf_info;
-  const int filter_level = get_filter_level(lfi_n, mi);
-  const TX_SIZE tx_size_uv = uv_txsize_lookup[block_size][tx_size_y][1][1];
-  LOOP_FILTER_MASK *const lfm = get_lfm(&cm->lf, mi_row, mi_col);
-  uint64_t *const left_y = &lfm->left_y[tx_size_y];
-  uint64_t *const above_y = &lfm->above_y[tx_size_y];
-  uint64_t *const int_4x4_y = &lfm->int_4x4_y;
-  uint16_t *const left_uv = &lfm->left_uv[tx_size_uv];
-  uint16_t *const above_uv = &lfm->above_uv[tx_size_uv];
-  uint16_t *const int_4x4_uv = &lfm->int_4x4_uv;
-  const int row_in_sb = (mi_row & 7);
-  const int col_in_sb = (mi_col & 7);
-  const int shift_y = col_in_sb + (row_in_sb << 3);
-  const int shift_uv = (col_in_sb >> 1) + ((row_in_sb >> 1) << 2);
-  const int build_uv = first_block_in_16x16[row_in_sb][col_in_sb];
-
-  if (!filter_level) {
-    return;
-  } else {
-    int index = shift_y;
-    int i;
-    for (i = 0; i < bh; i++) {
-      memset(&lfm->lfl_y[index], filter_level, bw);
-      index += 8;
+      vp9_setup_mask(cm, mi_row, mi_col);
     }
   }
-
-  // These set 1 in the current block size for the block size edges.
-  // For instance if the block size is 32x16, we'll set:
-  //    above =   1111
-  //              0000
-  //    and
-  //    left  =   1000
-  //          =   1000
-  // NOTE : In this example the low bit is left most ( 1000 ) is stored as
-  //        1,  not 8...
-  //
-  // U and V set things on a 16 bit scale.
-  //
-  *above_y |= above_prediction_mask[block_size] << shift_y;
-  *left_y |= left_prediction_mask[block_size] << shift_y;
-
-  if (build_uv) {
-    *above_uv |= above_prediction_mask_uv[block_size] << shift_uv;
-    *left_uv |= left_prediction_mask_uv[block_size] << shift_uv;
-  }
-
-  // If the block has no coefficients and is not intra we skip applying
-  // the loop filter on block edges.
-  if (mi->skip && is_inter_block(mi)) return;
-
-  // Add a mask for the transform size. The transform size mask is set to
-  // be correct for a 64x64 prediction block size. Mask to match the size of
-  // the block we are working on and then shift it into place.
-  *above_y |= (size_mask[block_size] & above_64x64_txform_mask[tx_size_y])
-              << shift_y;
-  *left_y |= (size_mask[block_size] & left_64x64_txform_mask[tx_size_y])
-             << shift_y;
-
-  if (build_uv) {
-    *above_uv |=
-        (size_mask_uv[block_size] & above_64x64_txform_mask_uv[tx_size_uv])
-        << shift_uv;
-
-    *left_uv |=
-        (size_mask_uv[block_size] & left_64x64_txform_mask_uv[tx_size_uv])
-        << shift_uv;
-  }
-
-  // Try to determine what to do with the internal 4x4 block boundaries.  These
-  // differ from the 4x4 boundaries on the outside edge of an 8x8 in that the
-  // internal ones can be skipped and don't depend on the prediction block size.
-  if (tx_size_y == TX_4X4) *int_4x4_y |= size_mask[block_size] << shift_y;
-
-  if (build_uv && tx_size_uv == TX_4X4)
-    *int_4x4_uv |= (size_mask_uv[block_size] & 0xffff) << shift_uv;
 }
 
 void vp9_loop_filter_data_reset(
@@ -1616,14 +1612,6 @@ void vp9_loop_filter_data_reset(
   memcpy(lf_data->planes, planes, sizeof(lf_data->planes));
 }
 
-void vp9_reset_lfm(VP9_COMMON *const cm) {
-  if (cm->lf.filter_level) {
-    memset(cm->lf.lfm, 0,
-           ((cm->mi_rows + (MI_BLOCK_SIZE - 1)) >> 3) * cm->lf.lfm_stride *
-               sizeof(*cm->lf.lfm));
-  }
-}
-
 int vp9_loop_filter_worker(void *arg1, void *unused) {
   LFWorkerData *const lf_data = (LFWorkerData *)arg1;
   (void)unused;
@@ -67,6 +67,19 @@ typedef struct {
   uint8_t lfl_y[64];
 } LOOP_FILTER_MASK;
 
+// The mode info a LOOP_FILTER_MASK was last built from. Masks of superblocks
+// whose mode info is unchanged, e.g. in static areas of screen content, are
+// reused instead of being rebuilt.
+typedef struct {
+  // 0 if the mask has not been built.
+  uint8_t num_blocks;
+  uint8_t max_rows;
+  uint8_t max_cols;
+  // Block size, transform size, skip and filter level of each block, in the
+  // order vp9_setup_mask() visits them.
+  uint16_t block[MI_BLOCK_SIZE * MI_BLOCK_SIZE];
+} LOOP_FILTER_MASK_KEY;
+
 struct loopfilter {
   int filter_level;
   int last_filt_level;
@@ -86,7 +99,12 @@ struct loopfilter {
   signed char last_mode_deltas[MAX_MODE_LF_DELTAS];
 
   LOOP_FILTER_MASK *lfm;
+  LOOP_FILTER_MASK_KEY *lfm_key;
   int lfm_stride;
+
+  // Vertical edges on this mode info column are not filtered, like those on
+  // the left edge of the frame. Non-zero when only part of a frame is decoded.
+  int mi_col_start;
 };
 
 /* assorted loopfilter functions which get used elsewhere */
@@ -95,10 +113,10 @@ struct macroblockd;
 struct VP9LfSyncData;
 
 // This function sets up the bit masks for the entire 64x64 region represented
-// by mi_row, mi_col.
+// by mi_row, mi_col. The masks are left untouched if the mode info of the
+// region matches the one they were last built from.
 void vp9_setup_mask(struct VP9Common *const cm, const int mi_row,
-                    const int mi_col, MODE_INFO **mi8x8,
-                    const int mode_info_stride, LOOP_FILTER_MASK *lfm);
+                    const int mi_col);
 
 void vp9_filter_block_plane_ss00(struct VP9Common *const cm,
                                  struct macroblockd_plane *const plane,
@@ -123,19 +141,31 @@ void vp9_loop_filter_frame(YV12_BUFFER_CONFIG *frame, struct VP9Common *cm,
                            struct macroblockd *xd, int frame_filter_level,
                            int y_only, int partial_frame);
 
+// Filters the superblocks of one superblock row from mi_col_start up to
+// mi_col_end. The superblocks to their left in the row and all rows above must
+// already be filtered, and the decoder must be done reading their unfiltered
+// pixels for intra prediction.
+void vp9_loop_filter_sb_cols(YV12_BUFFER_CONFIG *frame_buffer,
+                             struct VP9Common *cm,
+                             struct macroblockd_plane planes[MAX_MB_PLANE],
+                             int mi_row, int mi_col_start, int mi_col_end);
+
 // Get the superblock lfm for a given mi_row, mi_col.
 static INLINE LOOP_FILTER_MASK *get_lfm(const struct loopfilter *lf,
                                         const int mi_row, const int mi_col) {
   return &lf->lfm[(mi_col >> 3) + ((mi_row >> 3) * lf->lfm_stride)];
 }
 
-void vp9_build_mask(struct VP9Common *cm, const MODE_INFO *mi, int mi_row,
-                    int mi_col, int bw, int bh);
+static INLINE LOOP_FILTER_MASK_KEY *get_lfm_key(const struct loopfilter *lf,
+                                                const int mi_row,
+                                                const int mi_col) {
+  return &lf->lfm_key[(mi_col >> 3) + ((mi_row >> 3) * lf->lfm_stride)];
+}
+
 void vp9_adjust_mask(struct VP9Common *const cm, const int mi_row,
                      const int mi_col, LOOP_FILTER_MASK *lfm);
 void vp9_build_mask_frame(struct VP9Common *cm, int frame_filter_level,
                           int partial_frame);
-void vp9_reset_lfm(struct VP9Common *const cm);
 
 typedef struct LoopFilterWorkerData {
   YV12_BUFFER_CONFIG *frame_buffer;
@@ -13,6 +13,7 @@
 
 #include "./vpx_config.h"
 #include "vpx/internal/vpx_codec_internal.h"
+#include "vpx_util/vpx_pthread.h"
 #include "./vp9_rtcd.h"
 #include "vp9/common/vp9_alloccommon.h"
 #include "vp9/common/vp9_loopfilter.h"
@@ -78,6 +79,12 @@ typedef struct {
                            // show_idx defined in EncodeFrameInfo.
   int frame_coding_index;  // The coding order (starting from zero) of this
                            // frame.
+
+  // Number of luma rows, from the top, that are fully reconstructed and loop
+  // filtered. Only maintained in frame-based multi-threaded decoding, where it
+  // is protected by BufferPool::pool_mutex.
+  int row;
+
   vpx_codec_frame_buffer_t raw_frame_buffer;
   YV12_BUFFER_CONFIG buf;
 } RefCntBuffer;
@@ -93,6 +100,14 @@ typedef struct BufferPool {
 
   // Frame buffers allocated internally by the codec.
   InternalFrameBufferList int_frame_buffers;
+
+#if CONFIG_MULTITHREAD
+  // Protects the reference counts and the decode progress of frame_bufs when
+  // several frames are decoded in parallel. pool_cond is broadcast whenever a
+  // frame makes progress.
+  pthread_mutex_t pool_mutex;
+  pthread_cond_t pool_cond;
+#endif
 } BufferPool;
 
 typedef struct VP9Common {
@@ -328,6 +343,22 @@ static INLINE YV12_BUFFER_CONFIG *get_frame_new_buffer(VP9_COMMON *cm) {
   return &cm->buffer_pool->frame_bufs[cm->new_fb_idx].buf;
 }
 
+static INLINE void lock_buffer_pool(BufferPool *const pool) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(&pool->pool_mutex);
+#else
+  (void)pool;
+#endif
+}
+
+static INLINE void unlock_buffer_pool(BufferPool *const pool) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_unlock(&pool->pool_mutex);
+#else
+  (void)pool;
+#endif
+}
+
 static INLINE int get_free_fb(VP9_COMMON *cm) {
   RefCntBuffer *const frame_bufs = cm->buffer_pool->frame_bufs;
   int i;
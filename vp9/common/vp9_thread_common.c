@@ -34,6 +34,19 @@ static INLINE void mutex_lock(pthread_mutex_t *const mutex) {
 
   if (!locked) pthread_mutex_lock(mutex);
 }
+
+// Sets the filtered superblock index of row 'r' and wakes the thread waiting
+// for it, if any.
+static INLINE void set_sb_col(VP9LfSync *const lf_sync, int r, int cur) {
+  vpx_atomic_store_release(&lf_sync->cur_sb_col[r], cur);
+  // The read-modify-write orders the store before the check, so a thread that
+  // is about to sleep either sees the new index or is seen here.
+  if (vpx_atomic_fetch_add(&lf_sync->num_waiting[r], 0) > 0) {
+    mutex_lock(&lf_sync->mutex[r]);
+    pthread_cond_signal(&lf_sync->cond[r]);
+    pthread_mutex_unlock(&lf_sync->mutex[r]);
+  }
+}
 #endif  // CONFIG_MULTITHREAD
 
 static INLINE void sync_read(VP9LfSync *const lf_sync, int r, int c) {
@@ -41,12 +54,23 @@ static INLINE void sync_read(VP9LfSync *const lf_sync, int r, int c) {
   const int nsync = lf_sync->sync_range;
 
   if (r && !(c & (nsync - 1))) {
+    const int kMaxSpins = 4000;
+    const vpx_atomic_int *const cur_sb_col = &lf_sync->cur_sb_col[r - 1];
     pthread_mutex_t *const mutex = &lf_sync->mutex[r - 1];
-    mutex_lock(mutex);
+    int i;
 
-    while (c > lf_sync->cur_sb_col[r - 1] - nsync) {
+    // The row above is usually done or about to be, so it is polled before
+    // sleeping on its condition.
+    for (i = 0; i < kMaxSpins; ++i) {
+      if (c <= vpx_atomic_load_acquire(cur_sb_col) - nsync) return;
+    }
+
+    mutex_lock(mutex);
+    vpx_atomic_fetch_add(&lf_sync->num_waiting[r - 1], 1);
+    while (c > vpx_atomic_load_acquire(cur_sb_col) - nsync) {
       pthread_cond_wait(&lf_sync->cond[r - 1], mutex);
     }
+    vpx_atomic_fetch_add(&lf_sync->num_waiting[r - 1], -1);
     pthread_mutex_unlock(mutex);
   }
 #else
@@ -71,14 +95,7 @@ static INLINE void sync_write(VP9LfSync *const lf_sync, int r, int c,
     cur = sb_cols + nsync;
   }
 
-  if (sig) {
-    mutex_lock(&lf_sync->mutex[r]);
-
-    lf_sync->cur_sb_col[r] = cur;
-
-    pthread_cond_signal(&lf_sync->cond[r]);
-    pthread_mutex_unlock(&lf_sync->mutex[r]);
-  }
+  if (sig) set_sb_col(lf_sync, r, cur);
 #else
   (void)lf_sync;
   (void)r;
@@ -142,6 +159,10 @@ static INLINE void thread_loop_filter_rows(
 
       sync_write(lf_sync, r, c, sb_cols);
     }
+    if (lf_sync->row_filtered != NULL) {
+      lf_sync->row_filtered(lf_sync->row_filtered_priv,
+                            mi_row >> MI_BLOCK_SIZE_LOG2);
+    }
   }
 }
 
@@ -179,7 +200,7 @@ static void loop_filter_rows_mt(YV12_BUFFER_CONFIG *frame, VP9_COMMON *cm,
   lf_sync->num_active_workers = num_workers;
 
   // Initialize cur_sb_col to -1 for all SB rows.
-  memset(lf_sync->cur_sb_col, -1, sizeof(*lf_sync->cur_sb_col) * sb_rows);
+  for (i = 0; i < sb_rows; ++i) vpx_atomic_init(&lf_sync->cur_sb_col[i], -1);
 
   // Set up loopfilter thread data.
   // The decoder is capping num_workers because it has been observed that using
@@ -243,6 +264,7 @@ void vp9_loop_filter_frame_mt(YV12_BUFFER_CONFIG *frame, VP9_COMMON *cm,
 void vp9_lpf_mt_init(VP9LfSync *lf_sync, VP9_COMMON *cm, int frame_filter_level,
                      int num_workers) {
   const int sb_rows = mi_cols_aligned_to_sb(cm->mi_rows) >> MI_BLOCK_SIZE_LOG2;
+  int i;
 
   if (!frame_filter_level) return;
 
@@ -253,7 +275,7 @@ void vp9_lpf_mt_init(VP9LfSync *lf_sync, VP9_COMMON *cm, int frame_filter_level,
   }
 
   // Initialize cur_sb_col to -1 for all SB rows.
-  memset(lf_sync->cur_sb_col, -1, sizeof(*lf_sync->cur_sb_col) * sb_rows);
+  for (i = 0; i < sb_rows; ++i) vpx_atomic_init(&lf_sync->cur_sb_col[i], -1);
 
   lf_sync->corrupted = 0;
 
@@ -300,6 +322,10 @@ void vp9_loop_filter_alloc(VP9LfSync *lf_sync, VP9_COMMON *cm, int rows,
       }
     }
 
+    CHECK_MEM_ERROR(&cm->error, lf_sync->num_waiting,
+                    vpx_malloc(sizeof(*lf_sync->num_waiting) * rows));
+    for (i = 0; i < rows; ++i) vpx_atomic_init(&lf_sync->num_waiting[i], 0);
+
     CHECK_MEM_ERROR(&cm->error, lf_sync->lf_mutex,
                     vpx_malloc(sizeof(*lf_sync->lf_mutex)));
     pthread_mutex_init(lf_sync->lf_mutex, NULL);
@@ -358,6 +384,7 @@ void vp9_loop_filter_dealloc(VP9LfSync *lf_sync) {
     }
     vpx_free(lf_sync->cond);
   }
+  vpx_free(lf_sync->num_waiting);
   if (lf_sync->recon_done_mutex != NULL) {
     int i;
     for (i = 0; i < lf_sync->rows; ++i) {
@@ -382,9 +409,15 @@ void vp9_loop_filter_dealloc(VP9LfSync *lf_sync) {
   vpx_free(lf_sync->lfdata);
   vpx_free(lf_sync->cur_sb_col);
   vpx_free(lf_sync->num_tiles_done);
-  // clear the structure as the source of this call may be a resize in which
-  // case this call will be followed by an _alloc() which may fail.
-  vp9_zero(*lf_sync);
+  {
+    void (*const row_filtered)(void *, int) = lf_sync->row_filtered;
+    void *const row_filtered_priv = lf_sync->row_filtered_priv;
+    // clear the structure as the source of this call may be a resize in which
+    // case this call will be followed by an _alloc() which may fail.
+    vp9_zero(*lf_sync);
+    lf_sync->row_filtered = row_filtered;
+    lf_sync->row_filtered_priv = row_filtered_priv;
+  }
 }
 
 static int get_next_row(VP9_COMMON *cm, VP9LfSync *lf_sync) {
@@ -418,11 +451,7 @@ static int get_next_row(VP9_COMMON *cm, VP9LfSync *lf_sync) {
   pthread_mutex_unlock(&lf_sync->recon_done_mutex[cur_row]);
   pthread_mutex_lock(lf_sync->lf_mutex);
   if (lf_sync->corrupted) {
-    int row = return_val >> MI_BLOCK_SIZE_LOG2;
-    pthread_mutex_lock(&lf_sync->mutex[row]);
-    lf_sync->cur_sb_col[row] = INT_MAX;
-    pthread_cond_signal(&lf_sync->cond[row]);
-    pthread_mutex_unlock(&lf_sync->mutex[row]);
+    set_sb_col(lf_sync, return_val >> MI_BLOCK_SIZE_LOG2, INT_MAX);
     return_val = -1;
   }
   pthread_mutex_unlock(lf_sync->lf_mutex);
@@ -485,6 +514,22 @@ void vp9_loopfilter_job(LFWorkerData *lf_data, VP9LfSync *lf_sync) {
                           lf_sync);
 }
 
+int vp9_lf_rows_filtered(VP9LfSync *lf_sync, int start, int sb_cols) {
+  int r = start;
+#if CONFIG_MULTITHREAD
+  // The last superblock of a row sets cur_sb_col past sb_cols, as does a
+  // corrupted frame.
+  while (r < lf_sync->rows &&
+         vpx_atomic_load_acquire(&lf_sync->cur_sb_col[r]) >= sb_cols) {
+    ++r;
+  }
+#else
+  (void)lf_sync;
+  (void)sb_cols;
+#endif  // CONFIG_MULTITHREAD
+  return r;
+}
+
 // Accumulate frame counts.
 void vp9_accumulate_frame_counts(FRAME_COUNTS *accum,
                                  const FRAME_COUNTS *counts, int is_dec) {
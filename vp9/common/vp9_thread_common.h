@@ -12,6 +12,7 @@
 #define VPX_VP9_COMMON_VP9_THREAD_COMMON_H_
 #include "./vpx_config.h"
 #include "vp9/common/vp9_loopfilter.h"
+#include "vpx_util/vpx_atomics.h"
 #include "vpx_util/vpx_pthread.h"
 #include "vpx_util/vpx_thread.h"
 
@@ -27,9 +28,12 @@ typedef struct VP9LfSyncData {
 #if CONFIG_MULTITHREAD
   pthread_mutex_t *mutex;
   pthread_cond_t *cond;
+  // Number of threads sleeping on the condition of each row. Rows are only
+  // signaled when it is not 0.
+  vpx_atomic_int *num_waiting;
 #endif
   // Allocate memory to store the loop-filtered superblock index in each row.
-  int *cur_sb_col;
+  vpx_atomic_int *cur_sb_col;
   // The optimal sync_range for different resolution and platform should be
   // determined by testing. Currently, it is chosen to be a power-of-2 number.
   int sync_range;
@@ -47,6 +51,11 @@ typedef struct VP9LfSyncData {
 #endif
   int *num_tiles_done;
   int corrupted;
+
+  // Optional. Called by the filtering thread each time it finishes superblock
+  // row 'sb_row'. Rows may finish out of order. Kept across reallocation.
+  void (*row_filtered)(void *priv, int sb_row);
+  void *row_filtered_priv;
 } VP9LfSync;
 
 // Allocate memory for loopfilter row synchronization.
@@ -74,6 +83,10 @@ void vp9_set_row(VP9LfSync *lf_sync, int num_tiles, int row, int is_last_row,
 
 void vp9_loopfilter_job(LFWorkerData *lf_data, VP9LfSync *lf_sync);
 
+// Returns the number of superblock rows from the top of the frame that have
+// been filtered, given that the first 'start' of them have.
+int vp9_lf_rows_filtered(VP9LfSync *lf_sync, int start, int sb_cols);
+
 void vp9_accumulate_frame_counts(struct FRAME_COUNTS *accum,
                                  const struct FRAME_COUNTS *counts, int is_dec);
 
@@ -46,6 +46,7 @@
 #include "vp9/decoder/vp9_decodemv.h"
 #include "vp9/decoder/vp9_decoder.h"
 #include "vp9/decoder/vp9_dsubexp.h"
+#include "vp9/decoder/vp9_dthread.h"
 #include "vp9/decoder/vp9_job_queue.h"
 
 #define MAX_VP9_HEADER_SIZE 80
@@ -361,6 +362,47 @@ static void parse_intra_block_row_mt(TileWorkerData *twd, MODE_INFO *const mi,
   }
 }
 
+// Clears the coefficients of a transform block that is not reconstructed.
+static INLINE void clear_dqcoeff(tran_low_t *dqcoeff, TX_SIZE tx_size,
+                                 int eob) {
+  if (eob == 1)
+    dqcoeff[0] = 0;
+  else if (eob > 1)
+    memset(dqcoeff, 0, (16 << (tx_size << 1)) * sizeof(dqcoeff[0]));
+}
+
+static void skip_intra_block(TileWorkerData *twd, MODE_INFO *const mi,
+                             int plane, int row, int col, TX_SIZE tx_size) {
+  MACROBLOCKD *const xd = &twd->xd;
+  struct macroblockd_plane *const pd = &xd->plane[plane];
+  PREDICTION_MODE mode = (plane == 0) ? mi->mode : mi->uv_mode;
+  TX_TYPE tx_type;
+  const ScanOrder *sc;
+
+  if (mi->sb_type < BLOCK_8X8)
+    if (plane == 0) mode = xd->mi[0]->bmi[(row << 1) + col].as_mode;
+
+  tx_type =
+      (plane || xd->lossless) ? DCT_DCT : intra_mode_to_tx_type_lookup[mode];
+  sc = (plane || xd->lossless) ? &vp9_default_scan_orders[tx_size]
+                               : &vp9_scan_orders[tx_size][tx_type];
+  clear_dqcoeff(pd->dqcoeff, tx_size,
+                vp9_decode_block_tokens(twd, plane, sc, col, row, tx_size,
+                                        mi->segment_id));
+}
+
+static int skip_inter_block(TileWorkerData *twd, MODE_INFO *const mi,
+                            int plane, int row, int col, TX_SIZE tx_size) {
+  MACROBLOCKD *const xd = &twd->xd;
+  struct macroblockd_plane *const pd = &xd->plane[plane];
+  const ScanOrder *sc = &vp9_default_scan_orders[tx_size];
+  const int eob = vp9_decode_block_tokens(twd, plane, sc, col, row, tx_size,
+                                          mi->segment_id);
+
+  clear_dqcoeff(pd->dqcoeff, tx_size, eob);
+  return eob;
+}
+
 static void predict_and_reconstruct_intra_block_row_mt(TileWorkerData *twd,
                                                        MODE_INFO *const mi,
                                                        int plane, int row,
@@ -576,11 +618,11 @@ static void extend_and_predict(TileWorkerData *twd, const uint8_t *buf_ptr1,
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 
 static void dec_build_inter_predictors(
-    TileWorkerData *twd, MACROBLOCKD *xd, int plane, int bw, int bh, int x,
-    int y, int w, int h, int mi_x, int mi_y, const InterpKernel *kernel,
-    const struct scale_factors *sf, struct buf_2d *pre_buf,
-    struct buf_2d *dst_buf, const MV *mv, RefCntBuffer *ref_frame_buf,
-    int is_scaled, int ref) {
+    TileWorkerData *twd, VP9Decoder *const pbi, MACROBLOCKD *xd, int plane,
+    int bw, int bh, int x, int y, int w, int h, int mi_x, int mi_y,
+    const InterpKernel *kernel, const struct scale_factors *sf,
+    struct buf_2d *pre_buf, struct buf_2d *dst_buf, const MV *mv,
+    RefCntBuffer *ref_frame_buf, int is_scaled, int ref) {
   struct macroblockd_plane *const pd = &xd->plane[plane];
   uint8_t *const dst = dst_buf->buf + dst_buf->stride * y + x;
   MV32 scaled_mv;
@@ -653,6 +695,18 @@ static void dec_build_inter_predictors(
   x0_16 += scaled_mv.col;
   y0_16 += scaled_mv.row;
 
+  // Wait until the reference rows read by the prediction, including the
+  // filter taps, have been decoded.
+  if (pbi->frame_parallel_decode) {
+    struct vpx_usec_timer timer;
+    int y1 = ((y0_16 + (h - 1) * ys) >> SUBPEL_BITS) + 1;
+    if (subpel_y || (sf->y_step_q4 != SUBPEL_SHIFTS)) y1 += VP9_INTERP_EXTEND;
+    dec_start_timing(pbi, &timer);
+    vp9_frameworker_wait(pbi->common.buffer_pool, ref_frame_buf,
+                         (VPXMAX(y1, 0) + 1) << pd->subsampling_y);
+    dec_end_timing(pbi, &timer, &pbi->stats.frame_wait_us);
+  }
+
   // Get reference block pointer.
   buf_ptr = ref_frame + y0 * pre_buf->stride + x0;
   buf_stride = pre_buf->stride;
@@ -713,6 +767,71 @@ static void dec_build_inter_predictors(
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 }
 
+// Prefetches the rows of the unscaled reference frames that the inter
+// predictors of the block read, in all planes, so that they load while the
+// remaining mode info is read and while the earlier planes are predicted.
+// The rows are clamped to the frame, as those outside of it are built from
+// its edges.
+static void dec_prefetch_inter_refs(const VP9Decoder *pbi,
+                                    const MACROBLOCKD *xd, const MODE_INFO *mi,
+                                    int mi_row, int mi_col) {
+  const VP9_COMMON *const cm = &pbi->common;
+  const int is_compound = has_second_ref(mi);
+  int ref, plane;
+
+  for (ref = 0; ref < 1 + is_compound; ++ref) {
+    const RefBuffer *const ref_buf = &cm->frame_refs[mi->ref_frame[ref] -
+                                                     LAST_FRAME];
+    const YV12_BUFFER_CONFIG *const buf = ref_buf->buf;
+    const MV mv = mi->mv[ref].as_mv;
+    int bytes_per_pixel = 1;
+    if (buf == NULL || vp9_is_scaled(&ref_buf->sf)) continue;
+#if CONFIG_VP9_HIGHBITDEPTH
+    if (buf->flags & YV12_FLAG_HIGHBITDEPTH) bytes_per_pixel = 2;
+#endif
+
+    for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
+      const struct macroblockd_plane *const pd = &xd->plane[plane];
+      const int ss_x = pd->subsampling_x;
+      const int ss_y = pd->subsampling_y;
+      const int frame_width = plane ? buf->uv_crop_width : buf->y_crop_width;
+      const int frame_height =
+          plane ? buf->uv_crop_height : buf->y_crop_height;
+      const int stride = (plane ? buf->uv_stride : buf->y_stride) *
+                         bytes_per_pixel;
+      const uint8_t *const frame = plane == 0   ? buf->y_buffer
+                                   : plane == 1 ? buf->u_buffer
+                                                : buf->v_buffer;
+      const int x = ((mi_col * MI_SIZE) >> ss_x) + (mv.col >> (3 + ss_x));
+      const int y = ((mi_row * MI_SIZE) >> ss_y) + (mv.row >> (3 + ss_y));
+      const int x0 = clamp(x - (VP9_INTERP_EXTEND - 1), 0, frame_width - 1);
+      const int x1 = clamp(x + 4 * pd->n4_w + VP9_INTERP_EXTEND, 0,
+                           frame_width - 1);
+      const int y0 = clamp(y - (VP9_INTERP_EXTEND - 1), 0, frame_height - 1);
+      const int y1 = clamp(y + 4 * pd->n4_h + VP9_INTERP_EXTEND, 0,
+                           frame_height - 1);
+      const uint8_t *row;
+      int r;
+#if CONFIG_VP9_HIGHBITDEPTH
+      if (bytes_per_pixel == 2) {
+        row = (const uint8_t *)CONVERT_TO_SHORTPTR(frame) + y0 * stride;
+      } else {
+        row = frame + y0 * stride;
+      }
+#else
+      row = frame + y0 * stride;
+#endif
+      for (r = y0; r <= y1; ++r, row += stride) {
+        int c;
+        for (c = x0 * bytes_per_pixel; c < x1 * bytes_per_pixel; c += 64) {
+          __builtin_prefetch(row + c);
+        }
+        __builtin_prefetch(row + x1 * bytes_per_pixel);
+      }
+    }
+  }
+}
+
 static void dec_build_inter_predictors_sb(TileWorkerData *twd,
                                           VP9Decoder *const pbi,
                                           MACROBLOCKD *xd, int mi_row,
@@ -757,9 +876,9 @@ static void dec_build_inter_predictors_sb(TileWorkerData *twd,
         for (y = 0; y < num_4x4_h; ++y) {
           for (x = 0; x < num_4x4_w; ++x) {
             const MV mv = average_split_mvs(pd, mi, ref, i++);
-            dec_build_inter_predictors(twd, xd, plane, n4w_x4, n4h_x4, 4 * x,
-                                       4 * y, 4, 4, mi_x, mi_y, kernel, sf,
-                                       pre_buf, dst_buf, &mv, ref_frame_buf,
+            dec_build_inter_predictors(twd, pbi, xd, plane, n4w_x4, n4h_x4,
+                                       4 * x, 4 * y, 4, 4, mi_x, mi_y, kernel,
+                                       sf, pre_buf, dst_buf, &mv, ref_frame_buf,
                                        is_scaled, ref);
           }
         }
@@ -774,9 +893,10 @@ static void dec_build_inter_predictors_sb(TileWorkerData *twd,
         const int n4w_x4 = 4 * num_4x4_w;
         const int n4h_x4 = 4 * num_4x4_h;
         struct buf_2d *const pre_buf = &pd->pre[ref];
-        dec_build_inter_predictors(twd, xd, plane, n4w_x4, n4h_x4, 0, 0, n4w_x4,
-                                   n4h_x4, mi_x, mi_y, kernel, sf, pre_buf,
-                                   dst_buf, &mv, ref_frame_buf, is_scaled, ref);
+        dec_build_inter_predictors(twd, pbi, xd, plane, n4w_x4, n4h_x4, 0, 0,
+                                   n4w_x4, n4h_x4, mi_x, mi_y, kernel, sf,
+                                   pre_buf, dst_buf, &mv, ref_frame_buf,
+                                   is_scaled, ref);
       }
     }
   }
@@ -821,15 +941,38 @@ static MODE_INFO *set_offsets_recon(VP9_COMMON *const cm, MACROBLOCKD *const xd,
   return xd->mi[0];
 }
 
-static MODE_INFO *set_offsets(VP9_COMMON *const cm, MACROBLOCKD *const xd,
+// Returns the mode info of the block at mi_row, mi_col. With 'compact_mi' the
+// blocks of each superblock are stored next to each other in parsing order,
+// in 64 entries per superblock as a block covers at least 8x8 pixels, rather
+// than at the position of their top left 8x8 block. The mode info read by the
+// motion vector reference search and the loop filter then spans a few cache
+// lines per superblock instead of up to 8 rows of the frame wide array.
+static MODE_INFO *get_block_mi(TileWorkerData *twd, VP9Decoder *const pbi,
+                               int mi_row, int mi_col) {
+  VP9_COMMON *const cm = &pbi->common;
+  if (!pbi->compact_mi) return &cm->mi[mi_row * cm->mi_stride + mi_col];
+  // The first block of a superblock is at its top left corner.
+  if (!(mi_row & MI_MASK) && !(mi_col & MI_MASK)) {
+    const int sb_cols =
+        mi_cols_aligned_to_sb(cm->mi_cols) >> MI_BLOCK_SIZE_LOG2;
+    const int sb_index = (mi_row >> MI_BLOCK_SIZE_LOG2) * sb_cols +
+                         (mi_col >> MI_BLOCK_SIZE_LOG2);
+    twd->next_mi = cm->mi + sb_index * MI_BLOCK_SIZE * MI_BLOCK_SIZE;
+  }
+  return twd->next_mi++;
+}
+
+static MODE_INFO *set_offsets(TileWorkerData *twd, VP9Decoder *const pbi,
                               BLOCK_SIZE bsize, int mi_row, int mi_col, int bw,
                               int bh, int x_mis, int y_mis, int bwl, int bhl) {
+  VP9_COMMON *const cm = &pbi->common;
+  MACROBLOCKD *const xd = &twd->xd;
   const int offset = mi_row * cm->mi_stride + mi_col;
   int x, y;
   const TileInfo *const tile = &xd->tile;
 
   xd->mi = cm->mi_grid_visible + offset;
-  xd->mi[0] = &cm->mi[offset];
+  xd->mi[0] = get_block_mi(twd, pbi, mi_row, mi_col);
   // TODO(slavarnway): Generate sb_type based on bwl and bhl, instead of
   // passing bsize from decode_partition().
   xd->mi[0]->sb_type = bsize;
@@ -921,7 +1064,7 @@ static void decode_block(TileWorkerData *twd, VP9Decoder *const pbi, int mi_row,
   vpx_reader *r = &twd->bit_reader;
   MACROBLOCKD *const xd = &twd->xd;
 
-  MODE_INFO *mi = set_offsets(cm, xd, bsize, mi_row, mi_col, bw, bh, x_mis,
+  MODE_INFO *mi = set_offsets(twd, pbi, bsize, mi_row, mi_col, bw, bh, x_mis,
                               y_mis, bwl, bhl);
 
   if (bsize >= BLOCK_8X8 && (cm->subsampling_x || cm->subsampling_y)) {
@@ -933,6 +1076,10 @@ static void decode_block(TileWorkerData *twd, VP9Decoder *const pbi, int mi_row,
   }
 
   vp9_read_mode_info(twd, pbi, mi_row, mi_col, x_mis, y_mis);
+  // The reference rows of a frame decoded in parallel may not be ready yet.
+  if (is_inter_block(mi) && !pbi->frame_parallel_decode) {
+    dec_prefetch_inter_refs(pbi, xd, mi, mi_row, mi_col);
+  }
 
   if (mi->skip) {
     dec_reset_skip_context(xd);
@@ -1022,10 +1169,6 @@ static void decode_block(TileWorkerData *twd, VP9Decoder *const pbi, int mi_row,
   }
 
   xd->corrupted |= vpx_reader_has_error(r);
-
-  if (cm->lf.filter_level) {
-    vp9_build_mask(cm, mi, mi_row, mi_col, bw, bh);
-  }
 }
 
 static void recon_block(TileWorkerData *twd, VP9Decoder *const pbi, int mi_row,
@@ -1049,6 +1192,9 @@ static void recon_block(TileWorkerData *twd, VP9Decoder *const pbi, int mi_row,
     predict_recon_intra(xd, mi, twd,
                         predict_and_reconstruct_intra_block_row_mt);
   } else {
+    // The mode info was read by the parse job, possibly on another thread.
+    dec_prefetch_inter_refs(pbi, xd, mi, mi_row, mi_col);
+
     // Prediction
     dec_build_inter_predictors_sb(twd, pbi, xd, mi_row, mi_col);
 
@@ -1057,8 +1203,6 @@ static void recon_block(TileWorkerData *twd, VP9Decoder *const pbi, int mi_row,
       predict_recon_inter(xd, mi, twd, reconstruct_inter_block_row_mt);
     }
   }
-
-  vp9_build_mask(cm, mi, mi_row, mi_col, bw, bh);
 }
 
 static void parse_block(TileWorkerData *twd, VP9Decoder *const pbi, int mi_row,
@@ -1071,7 +1215,7 @@ static void parse_block(TileWorkerData *twd, VP9Decoder *const pbi, int mi_row,
   vpx_reader *r = &twd->bit_reader;
   MACROBLOCKD *const xd = &twd->xd;
 
-  MODE_INFO *mi = set_offsets(cm, xd, bsize, mi_row, mi_col, bw, bh, x_mis,
+  MODE_INFO *mi = set_offsets(twd, pbi, bsize, mi_row, mi_col, bw, bh, x_mis,
                               y_mis, bwl, bhl);
 
   if (bsize >= BLOCK_8X8 && (cm->subsampling_x || cm->subsampling_y)) {
@@ -1120,6 +1264,45 @@ static void parse_block(TileWorkerData *twd, VP9Decoder *const pbi, int mi_row,
   xd->corrupted |= vpx_reader_has_error(r);
 }
 
+// Reads the modes and coefficients of a block outside of the decoded region
+// without reconstructing it.
+static void skip_block(TileWorkerData *twd, VP9Decoder *const pbi, int mi_row,
+                       int mi_col, BLOCK_SIZE bsize, int bwl, int bhl) {
+  VP9_COMMON *const cm = &pbi->common;
+  const int bw = 1 << (bwl - 1);
+  const int bh = 1 << (bhl - 1);
+  const int x_mis = VPXMIN(bw, cm->mi_cols - mi_col);
+  const int y_mis = VPXMIN(bh, cm->mi_rows - mi_row);
+  vpx_reader *r = &twd->bit_reader;
+  MACROBLOCKD *const xd = &twd->xd;
+
+  MODE_INFO *mi = set_offsets(twd, pbi, bsize, mi_row, mi_col, bw, bh, x_mis,
+                              y_mis, bwl, bhl);
+
+  if (bsize >= BLOCK_8X8 && (cm->subsampling_x || cm->subsampling_y)) {
+    const BLOCK_SIZE uv_subsize =
+        ss_size_lookup[bsize][cm->subsampling_x][cm->subsampling_y];
+    if (uv_subsize == BLOCK_INVALID)
+      vpx_internal_error(xd->error_info, VPX_CODEC_CORRUPT_FRAME,
+                         "Invalid block size.");
+  }
+
+  vp9_read_mode_info(twd, pbi, mi_row, mi_col, x_mis, y_mis);
+
+  if (mi->skip) {
+    dec_reset_skip_context(xd);
+  } else if (!is_inter_block(mi)) {
+    predict_recon_intra(xd, mi, twd, skip_intra_block);
+  } else {
+    // As in decode_block(), since later blocks read the skip flag as context.
+    if (predict_recon_inter(xd, mi, twd, skip_inter_block) == 0 &&
+        bsize >= BLOCK_8X8)
+      mi->skip = 1;
+  }
+
+  xd->corrupted |= vpx_reader_has_error(r);
+}
+
 static INLINE int dec_partition_plane_context(TileWorkerData *twd, int mi_row,
                                               int mi_col, int bsl) {
   const PARTITION_CONTEXT *above_ctx = twd->xd.above_seg_context + mi_col;
@@ -1521,6 +1704,7 @@ static void setup_frame_size(VP9_COMMON *cm, struct vpx_read_bit_buffer *rb) {
   resize_context_buffers(cm, width, height);
   setup_render_size(cm, rb);
 
+  lock_buffer_pool(pool);
   if (vpx_realloc_frame_buffer(
           get_frame_new_buffer(cm), cm->width, cm->height, cm->subsampling_x,
           cm->subsampling_y,
@@ -1530,9 +1714,11 @@ static void setup_frame_size(VP9_COMMON *cm, struct vpx_read_bit_buffer *rb) {
           VP9_DEC_BORDER_IN_PIXELS, cm->byte_alignment,
           &pool->frame_bufs[cm->new_fb_idx].raw_frame_buffer, pool->get_fb_cb,
           pool->cb_priv)) {
+    unlock_buffer_pool(pool);
     vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
                        "Failed to allocate frame buffer");
   }
+  unlock_buffer_pool(pool);
 
   pool->frame_bufs[cm->new_fb_idx].released = 0;
   pool->frame_bufs[cm->new_fb_idx].buf.subsampling_x = cm->subsampling_x;
@@ -1605,6 +1791,7 @@ static void setup_frame_size_with_refs(VP9_COMMON *cm,
   resize_context_buffers(cm, width, height);
   setup_render_size(cm, rb);
 
+  lock_buffer_pool(pool);
   if (vpx_realloc_frame_buffer(
           get_frame_new_buffer(cm), cm->width, cm->height, cm->subsampling_x,
           cm->subsampling_y,
@@ -1614,9 +1801,11 @@ static void setup_frame_size_with_refs(VP9_COMMON *cm,
           VP9_DEC_BORDER_IN_PIXELS, cm->byte_alignment,
           &pool->frame_bufs[cm->new_fb_idx].raw_frame_buffer, pool->get_fb_cb,
           pool->cb_priv)) {
+    unlock_buffer_pool(pool);
     vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
                        "Failed to allocate frame buffer");
   }
+  unlock_buffer_pool(pool);
 
   pool->frame_bufs[cm->new_fb_idx].released = 0;
   pool->frame_bufs[cm->new_fb_idx].buf.subsampling_x = cm->subsampling_x;
@@ -1768,15 +1957,29 @@ static void vp9_tile_done(VP9Decoder *pbi) {
 #endif
 }
 
-static void vp9_jobq_alloc(VP9Decoder *pbi) {
-  VP9_COMMON *const cm = &pbi->common;
-  RowMTWorkerData *const row_mt_worker_data = pbi->row_mt_worker_data;
+// Every tile row is parsed and reconstructed once, and every SB row is loop
+// filtered once.
+static void get_jobq_class_sizes(const VP9_COMMON *cm,
+                                 int class_size[NUM_JOB_TYPES]) {
   const int aligned_rows = mi_cols_aligned_to_sb(cm->mi_rows);
   const int sb_rows = aligned_rows >> MI_BLOCK_SIZE_LOG2;
   const int tile_cols = 1 << cm->log2_tile_cols;
-  const size_t jobq_size = (tile_cols * sb_rows * 2 + sb_rows) * sizeof(Job);
+  class_size[PARSE_JOB] = tile_cols * sb_rows;
+  class_size[RECON_JOB] = tile_cols * sb_rows;
+  class_size[LPF_JOB] = sb_rows;
+}
+
+static void vp9_jobq_alloc(VP9Decoder *pbi) {
+  VP9_COMMON *const cm = &pbi->common;
+  RowMTWorkerData *const row_mt_worker_data = pbi->row_mt_worker_data;
+  int class_size[NUM_JOB_TYPES];
+  size_t jobq_size;
 
+  get_jobq_class_sizes(cm, class_size);
+  jobq_size = vp9_jobq_buf_size(sizeof(Job), NUM_JOB_TYPES, class_size);
   if (jobq_size > row_mt_worker_data->jobq_size) {
+    if (row_mt_worker_data->jobq_buf != NULL)
+      vp9_jobq_deinit(&row_mt_worker_data->jobq);
     vpx_free(row_mt_worker_data->jobq_buf);
     CHECK_MEM_ERROR(&cm->error, row_mt_worker_data->jobq_buf,
                     vpx_calloc(1, jobq_size));
@@ -1826,6 +2029,8 @@ static void recon_tile_row(TileWorkerData *tile_data, VP9Decoder *pbi,
       // Queue LPF_JOB
       int is_lpf_job_ready = 0;
 
+      vp9_setup_mask(cm, mi_row, mi_col);
+
       if (mi_col + MI_BLOCK_SIZE >= mi_col_end) {
         // Checks if this row has been decoded in all tiles
         is_lpf_job_ready = lpf_map_write_check(lf_sync, cur_sb_row, tile_cols);
@@ -1835,12 +2040,12 @@ static void recon_tile_row(TileWorkerData *tile_data, VP9Decoder *pbi,
           lpf_job.job_type = LPF_JOB;
           if (cur_sb_row > 0) {
             lpf_job.row_num = mi_row - MI_BLOCK_SIZE;
-            vp9_jobq_queue(&row_mt_worker_data->jobq, &lpf_job,
+            vp9_jobq_queue(&row_mt_worker_data->jobq, LPF_JOB, &lpf_job,
                            sizeof(lpf_job));
           }
           if (is_last_row) {
             lpf_job.row_num = mi_row;
-            vp9_jobq_queue(&row_mt_worker_data->jobq, &lpf_job,
+            vp9_jobq_queue(&row_mt_worker_data->jobq, LPF_JOB, &lpf_job,
                            sizeof(lpf_job));
           }
         }
@@ -1893,6 +2098,17 @@ static void parse_tile_row(TileWorkerData *tile_data, VP9Decoder *pbi,
   }
 }
 
+static int dequeue_job(ThreadData *const thread_data, Job *job) {
+  RowMTWorkerData *const row_mt_worker_data =
+      thread_data->pbi->row_mt_worker_data;
+  struct vpx_usec_timer timer;
+  int ret;
+  dec_start_timing(thread_data->pbi, &timer);
+  ret = vp9_jobq_dequeue(&row_mt_worker_data->jobq, job, sizeof(*job), 1);
+  dec_end_timing(thread_data->pbi, &timer, &thread_data->idle_us);
+  return ret;
+}
+
 static int row_decode_worker_hook(void *arg1, void *arg2) {
   ThreadData *const thread_data = (ThreadData *)arg1;
   uint8_t **data_end = (uint8_t **)arg2;
@@ -1909,9 +2125,11 @@ static int row_decode_worker_hook(void *arg1, void *arg2) {
   volatile int corrupted = 0;
   TileWorkerData *volatile tile_data_recon = NULL;
 
-  while (!vp9_jobq_dequeue(&row_mt_worker_data->jobq, &job, sizeof(job), 1)) {
+  while (!dequeue_job(thread_data, &job)) {
     int mi_col;
     const int mi_row = job.row_num;
+    int64_t *const job_us = &thread_data->job_us[job.job_type];
+    struct vpx_usec_timer timer;
 
     if (job.job_type == LPF_JOB) {
       lf_data->start = mi_row;
@@ -1919,7 +2137,9 @@ static int row_decode_worker_hook(void *arg1, void *arg2) {
 
       if (cm->lf.filter_level && !cm->skip_loop_filter &&
           mi_row < cm->mi_rows) {
+        dec_start_timing(pbi, &timer);
         vp9_loopfilter_job(lf_data, lf_sync);
+        dec_end_timing(pbi, &timer, job_us);
       }
     } else if (job.job_type == RECON_JOB) {
       const int cur_sb_row = mi_row >> MI_BLOCK_SIZE_LOG2;
@@ -1954,8 +2174,10 @@ static int row_decode_worker_hook(void *arg1, void *arg2) {
       tile_data_recon->error_info.setjmp = 1;
       tile_data_recon->xd.error_info = &tile_data_recon->error_info;
 
+      dec_start_timing(pbi, &timer);
       recon_tile_row(tile_data_recon, pbi, mi_row, is_last_row, lf_sync,
                      job.tile_col);
+      dec_end_timing(pbi, &timer, job_us);
 
       if (corrupted)
         vpx_internal_error(&tile_data_recon->error_info,
@@ -1981,7 +2203,9 @@ static int row_decode_worker_hook(void *arg1, void *arg2) {
 
       tile_data->error_info.setjmp = 1;
 
+      dec_start_timing(pbi, &timer);
       parse_tile_row(tile_data, pbi, mi_row, job.tile_col, data_end);
+      dec_end_timing(pbi, &timer, job_us);
 
       corrupted |= tile_data->xd.corrupted;
       if (corrupted)
@@ -1994,7 +2218,7 @@ static int row_decode_worker_hook(void *arg1, void *arg2) {
         recon_job.row_num = mi_row;
         recon_job.tile_col = job.tile_col;
         recon_job.job_type = RECON_JOB;
-        vp9_jobq_queue(&row_mt_worker_data->jobq, &recon_job,
+        vp9_jobq_queue(&row_mt_worker_data->jobq, RECON_JOB, &recon_job,
                        sizeof(recon_job));
       }
 
@@ -2004,7 +2228,7 @@ static int row_decode_worker_hook(void *arg1, void *arg2) {
         parse_job.row_num = mi_row + MI_BLOCK_SIZE;
         parse_job.tile_col = job.tile_col;
         parse_job.job_type = PARSE_JOB;
-        vp9_jobq_queue(&row_mt_worker_data->jobq, &parse_job,
+        vp9_jobq_queue(&row_mt_worker_data->jobq, PARSE_JOB, &parse_job,
                        sizeof(parse_job));
       }
     }
@@ -2014,6 +2238,258 @@ static int row_decode_worker_hook(void *arg1, void *arg2) {
   return !corrupted;
 }
 
+// Finds the part of the frame that is decoded when only pbi->decode_rect is
+// needed. Returns 0 if the whole frame is decoded.
+static int setup_decode_region(VP9Decoder *pbi) {
+  VP9_COMMON *const cm = &pbi->common;
+  const vpx_image_rect_t *const rect = &pbi->decode_rect;
+  DecodeRegion *const region = &pbi->region;
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  int mi_col_start, mi_col_end, mi_row_end, tile_col;
+  TileInfo tile;
+
+  cm->lf.mi_col_start = 0;
+  // Later frames may predict from any part of a reference frame.
+  if (rect->w == 0 || rect->h == 0 || rect->x >= (unsigned int)cm->width ||
+      rect->y >= (unsigned int)cm->height || pbi->refresh_frame_flags != 0)
+    return 0;
+
+  mi_col_start = rect->x >> MI_SIZE_LOG2;
+  mi_col_end = (int)((VPXMIN((int64_t)rect->x + rect->w, cm->width) +
+                      MI_SIZE - 1) >>
+                     MI_SIZE_LOG2);
+  mi_row_end = (int)((VPXMIN((int64_t)rect->y + rect->h, cm->height) +
+                      MI_SIZE - 1) >>
+                     MI_SIZE_LOG2);
+
+  region->tile_col_start = tile_cols;
+  region->tile_col_end = 0;
+  for (tile_col = 0; tile_col < tile_cols; ++tile_col) {
+    vp9_tile_set_col(&tile, cm, tile_col);
+    if (tile.mi_col_end > mi_col_start && tile.mi_col_start < mi_col_end) {
+      region->tile_col_start = VPXMIN(region->tile_col_start, tile_col);
+      region->tile_col_end = tile_col + 1;
+    }
+  }
+  region->mi_row_end = VPXMIN(
+      ALIGN_POWER_OF_TWO(mi_row_end, MI_BLOCK_SIZE_LOG2), cm->mi_rows);
+  if (region->tile_col_start == 0 && region->tile_col_end == tile_cols &&
+      region->mi_row_end == cm->mi_rows)
+    return 0;
+
+  // The next frame reads the motion vectors of a shown inter frame and the
+  // segmentation map, and the counts adapt the stored entropy context.
+  region->skip_tiles =
+      !cm->seg.enabled &&
+      (!cm->refresh_frame_context || cm->frame_parallel_decoding_mode) &&
+      (!cm->show_frame || cm->intra_only);
+
+  vp9_tile_set_col(&tile, cm, region->tile_col_start);
+  cm->lf.mi_col_start = tile.mi_col_start;
+  return 1;
+}
+
+// Runs in pbi->lf_worker, which only filters while decode_tiles() does not.
+static int loop_filter_worker_hook(void *arg1, void *arg2) {
+  VP9Decoder *const pbi = (VP9Decoder *)arg2;
+  struct vpx_usec_timer timer;
+  dec_start_timing(pbi, &timer);
+  vp9_loop_filter_worker(arg1, NULL);
+  dec_end_timing(pbi, &timer, &pbi->stats.loop_filter_us);
+  return 1;
+}
+
+static void loop_filter_sb_cols(VP9Decoder *pbi, int mi_row, int mi_col_start,
+                                int mi_col_end) {
+  LFWorkerData *const lf_data = (LFWorkerData *)pbi->lf_worker.data1;
+  struct vpx_usec_timer timer;
+  dec_start_timing(pbi, &timer);
+  vp9_loop_filter_sb_cols(lf_data->frame_buffer, &pbi->common, lf_data->planes,
+                          mi_row, mi_col_start, mi_col_end);
+  dec_end_timing(pbi, &timer, &pbi->stats.loop_filter_us);
+}
+
+// Sets up 'scaled_frame' to scale 'buf' down to the size requested with
+// VP9D_SET_OUTPUT_SIZE. Frames are output at full size instead unless they are
+// 8-bit 4:2:0 and at most 4 times as large as the requested size in each
+// dimension, the range of vpx_scaled_2d(). Returns 'scale_output'.
+static int setup_scaled_output(VP9Decoder *pbi, const YV12_BUFFER_CONFIG *buf) {
+  VP9_COMMON *const cm = &pbi->common;
+  const int w = pbi->output_width;
+  const int h = pbi->output_height;
+
+  pbi->scale_output = 0;
+  pbi->scaled_rows = 0;
+  if (w <= 0 || h <= 0 || w > buf->y_crop_width || h > buf->y_crop_height ||
+      (w == buf->y_crop_width && h == buf->y_crop_height) ||
+      4 * w < buf->y_crop_width || 4 * h < buf->y_crop_height ||
+      buf->subsampling_x != 1 || buf->subsampling_y != 1) {
+    return 0;
+  }
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (buf->flags & YV12_FLAG_HIGHBITDEPTH) return 0;
+#endif
+
+  if (vpx_realloc_frame_buffer(&pbi->scaled_frame, w, h, 1, 1,
+#if CONFIG_VP9_HIGHBITDEPTH
+                               0,
+#endif
+                               VP9_DEC_BORDER_IN_PIXELS, cm->byte_alignment,
+                               NULL, NULL, NULL) < 0)
+    vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
+                       "Failed to allocate scaled output frame");
+  pbi->scaled_frame.color_space = buf->color_space;
+  pbi->scaled_frame.color_range = buf->color_range;
+  pbi->scaled_frame.render_width = w;
+  pbi->scaled_frame.render_height = h;
+  pbi->scale_output = 1;
+  return 1;
+}
+
+// Scales one row of bs x bs blocks of a plane, starting at y_q4 in the plane,
+// of which the top 'plane_rows' rows are final. Blocks reading outside of the
+// plane or, including the rows vpx_scaled_2d() may read past the ones it
+// filters, outside of the final rows are copied with clamped edges first.
+static void scale_block_row(const uint8_t *src, int src_stride, int plane_w,
+                            int plane_h, int plane_rows, uint8_t *dst,
+                            int dst_stride, int bs, int y_q4, int src_w,
+                            int dst_w, int x_step_q4, int y_step_q4) {
+  const InterpKernel *const kernel = vp9_filter_kernels[EIGHTTAP];
+  const int y = y_q4 >> SUBPEL_BITS;
+  const int top = y - (SUBPEL_TAPS / 2 - 1);
+  const int bottom =
+      y + (((bs - 1) * y_step_q4 + (y_q4 & SUBPEL_MASK)) >> SUBPEL_BITS) +
+      SUBPEL_TAPS / 2;
+  int x;
+
+  for (x = 0; x < dst_w; x += 16) {
+    const int x_q4 = (int)((int64_t)x * bs * src_w / dst_w);
+    const int left = (x_q4 >> SUBPEL_BITS) - (SUBPEL_TAPS / 2 - 1);
+    const int right =
+        (x_q4 >> SUBPEL_BITS) +
+        (((bs - 1) * x_step_q4 + (x_q4 & SUBPEL_MASK)) >> SUBPEL_BITS) +
+        SUBPEL_TAPS / 2;
+    const uint8_t *src_ptr = src + y * src_stride + (x_q4 >> SUBPEL_BITS);
+    int stride = src_stride;
+    DECLARE_ALIGNED(16, uint8_t, mc_buf[96 * 96]);
+
+    if (top < 0 || left < 0 || right >= plane_w || bottom >= plane_h ||
+        (plane_rows < plane_h && bottom + 8 >= plane_rows)) {
+      // Up to 68 columns and rows are filtered, and the SIMD versions read up
+      // to 16 more columns and 8 more rows.
+      build_mc_border(src + top * src_stride + left, src_stride, mc_buf, 96,
+                      left, top, right - left + 1 + 16, bottom - top + 1 + 8,
+                      plane_w, plane_rows);
+      src_ptr = mc_buf + (y - top) * 96 + (x_q4 >> SUBPEL_BITS) - left;
+      stride = 96;
+    }
+    vpx_scaled_2d(src_ptr, stride, dst + x * bs / 16, dst_stride, kernel,
+                  x_q4 & SUBPEL_MASK, x_step_q4, y_q4 & SUBPEL_MASK, y_step_q4,
+                  bs, bs);
+  }
+}
+
+// Scales the rows of 'buf' into 'scaled_frame' that only depend on its top
+// 'end' luma rows, 16 rows at a time like vp9_scale_and_extend_frame().
+static void scale_rows(VP9Decoder *pbi, const YV12_BUFFER_CONFIG *buf,
+                       int end) {
+  YV12_BUFFER_CONFIG *const dst = &pbi->scaled_frame;
+  const uint8_t *const srcs[3] = { buf->y_buffer, buf->u_buffer,
+                                   buf->v_buffer };
+  const int src_strides[3] = { buf->y_stride, buf->uv_stride, buf->uv_stride };
+  const int plane_ws[3] = { buf->y_crop_width, buf->uv_crop_width,
+                            buf->uv_crop_width };
+  const int plane_hs[3] = { buf->y_crop_height, buf->uv_crop_height,
+                            buf->uv_crop_height };
+  uint8_t *const dsts[3] = { dst->y_buffer, dst->u_buffer, dst->v_buffer };
+  const int dst_strides[3] = { dst->y_stride, dst->uv_stride, dst->uv_stride };
+  const int src_w = buf->y_crop_width;
+  const int src_h = buf->y_crop_height;
+  const int dst_w = dst->y_crop_width;
+  const int dst_h = dst->y_crop_height;
+  const int x_step_q4 = 16 * src_w / dst_w;
+  const int y_step_q4 = 16 * src_h / dst_h;
+  int plane_rows[3];
+  int i;
+
+  for (i = 0; i < MAX_MB_PLANE; ++i) {
+    plane_rows[i] = end >= src_h ? plane_hs[i] : end / (i == 0 ? 1 : 2);
+  }
+
+  while (pbi->scaled_rows < dst_h) {
+    const int y = pbi->scaled_rows;
+    // All planes of the block row are scaled together once their source rows
+    // are final.
+    for (i = 0; i < MAX_MB_PLANE; ++i) {
+      const int bs = i == 0 ? 16 : 8;
+      const int y_q4 = (int)((int64_t)y * bs * src_h / dst_h);
+      const int last =
+          (y_q4 >> SUBPEL_BITS) +
+          (((bs - 1) * y_step_q4 + (y_q4 & SUBPEL_MASK)) >> SUBPEL_BITS) +
+          SUBPEL_TAPS / 2;
+      if (VPXMIN(last, plane_hs[i] - 1) >= plane_rows[i]) return;
+    }
+    for (i = 0; i < MAX_MB_PLANE; ++i) {
+      const int bs = i == 0 ? 16 : 8;
+      scale_block_row(srcs[i], src_strides[i], plane_ws[i], plane_hs[i],
+                      plane_rows[i], dsts[i] + y * bs / 16 * dst_strides[i],
+                      dst_strides[i], bs,
+                      (int)((int64_t)y * bs * src_h / dst_h), src_w, dst_w,
+                      x_step_q4, y_step_q4);
+    }
+    pbi->scaled_rows += 16;
+  }
+}
+
+// Reports the rows of the frame above 'mi_row' once all of them are
+// reconstructed and, with the loop filter on, filtered. With a scaled output
+// the rows are scaled first, and the rows of the scaled frame are reported.
+static void report_rows_ready(VP9Decoder *pbi, int mi_row) {
+  VP9_COMMON *const cm = &pbi->common;
+  int end = cm->height;
+  if (!pbi->report_rows) return;
+  if (mi_row < cm->mi_rows) {
+    end = mi_row << MI_SIZE_LOG2;
+    // Filtering the next row modifies up to 7 rows above it in each plane,
+    // i.e. up to 14 luma rows with vertically subsampled chroma.
+    if (cm->lf.filter_level && !cm->skip_loop_filter) end -= 16;
+    end = VPXMIN(end, cm->height);
+  }
+  if (end <= pbi->rows_ready) return;
+  if (pbi->scale_output) {
+    const int dst_h = pbi->scaled_frame.y_crop_height;
+    const int start = VPXMIN(pbi->scaled_rows, dst_h);
+    scale_rows(pbi, get_frame_new_buffer(cm), end);
+    if (pbi->rows_ready_cb != NULL &&
+        VPXMIN(pbi->scaled_rows, dst_h) > start) {
+      pbi->rows_ready_cb(pbi->rows_ready_priv, &pbi->scaled_frame, start,
+                         VPXMIN(pbi->scaled_rows, dst_h));
+    }
+  } else {
+    pbi->rows_ready_cb(pbi->rows_ready_priv, get_frame_new_buffer(cm),
+                       pbi->rows_ready, end);
+  }
+  pbi->rows_ready = end;
+}
+
+#if CONFIG_MULTITHREAD
+// Called by the loop filter threads as they finish superblock rows. Only the
+// thread finishing the first row not yet known to be filtered looks for
+// further rows, the others have nothing new to report.
+static void lf_row_filtered(void *priv, int sb_row) {
+  VP9Decoder *const pbi = (VP9Decoder *)priv;
+  const int sb_cols =
+      mi_cols_aligned_to_sb(pbi->common.mi_cols) >> MI_BLOCK_SIZE_LOG2;
+  pthread_mutex_lock(&pbi->rows_ready_mutex);
+  if (sb_row == pbi->lf_sb_rows_filtered) {
+    pbi->lf_sb_rows_filtered =
+        vp9_lf_rows_filtered(&pbi->lf_row_sync, sb_row, sb_cols);
+    report_rows_ready(pbi, pbi->lf_sb_rows_filtered << MI_BLOCK_SIZE_LOG2);
+  }
+  pthread_mutex_unlock(&pbi->rows_ready_mutex);
+}
+#endif  // CONFIG_MULTITHREAD
+
 static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
                                    const uint8_t *data_end) {
   VP9_COMMON *const cm = &pbi->common;
@@ -2025,12 +2501,26 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
   int tile_row, tile_col;
   int mi_row, mi_col;
   TileWorkerData *tile_data = NULL;
+  // Without a loop filter thread, each superblock of the row above is filtered
+  // as soon as the superblock below and to the right of it is decoded, while
+  // its pixels are still in cache. Intra prediction of the current row only
+  // reads unfiltered pixels from superblocks that have not been filtered yet.
+  // This relies on superblocks being decoded in raster order.
+  const int lf_sb_wavefront = cm->lf.filter_level && !cm->skip_loop_filter &&
+                              pbi->max_threads <= 1 && !pbi->inv_tile_order &&
+                              !pbi->decode_partial;
+  const DecodeRegion *const region = &pbi->region;
+  // Superblock columns of the decoded region, only used when decode_partial.
+  int region_mi_col_start = 0, region_mi_col_end = 0;
 
   if (cm->lf.filter_level && !cm->skip_loop_filter &&
       pbi->lf_worker.data1 == NULL) {
     CHECK_MEM_ERROR(&cm->error, pbi->lf_worker.data1,
                     vpx_memalign(32, sizeof(LFWorkerData)));
-    pbi->lf_worker.hook = vp9_loop_filter_worker;
+    pbi->lf_worker.hook = loop_filter_worker_hook;
+    pbi->lf_worker.data2 = pbi;
+    pbi->lf_worker.submit = pbi->thread_pool.submit;
+    pbi->lf_worker.submit_priv = pbi->thread_pool.pool_priv;
     if (pbi->max_threads > 1 && !winterface->reset(&pbi->lf_worker)) {
       vpx_internal_error(&cm->error, VPX_CODEC_ERROR,
                          "Loop filter thread creation failed");
@@ -2056,8 +2546,6 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
   memset(cm->above_seg_context, 0,
          sizeof(*cm->above_seg_context) * aligned_cols);
 
-  vp9_reset_lfm(cm);
-
   get_tile_buffers(pbi, data, data_end, tile_cols, tile_rows, tile_buffers);
 
   // Load all tile information into tile_data.
@@ -2078,20 +2566,58 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
     }
   }
 
+  if (pbi->decode_partial) {
+    TileInfo tile;
+    vp9_tile_set_col(&tile, cm, region->tile_col_start);
+    region_mi_col_start = tile.mi_col_start;
+    vp9_tile_set_col(&tile, cm, region->tile_col_end - 1);
+    region_mi_col_end = tile.mi_col_end;
+  }
+
   for (tile_row = 0; tile_row < tile_rows; ++tile_row) {
     TileInfo tile;
     vp9_tile_set_row(&tile, cm, tile_row);
     for (mi_row = tile.mi_row_start; mi_row < tile.mi_row_end;
          mi_row += MI_BLOCK_SIZE) {
+      // The co-located motion vectors of the previous frame are read while
+      // parsing the modes of this row.
+      if (pbi->frame_parallel_decode && cm->use_prev_frame_mvs) {
+        struct vpx_usec_timer timer;
+        dec_start_timing(pbi, &timer);
+        vp9_frameworker_wait(cm->buffer_pool, cm->prev_frame,
+                             (mi_row + MI_BLOCK_SIZE) << MI_SIZE_LOG2);
+        dec_end_timing(pbi, &timer, &pbi->stats.frame_wait_us);
+      }
       for (tile_col = 0; tile_col < tile_cols; ++tile_col) {
         const int col =
             pbi->inv_tile_order ? tile_cols - tile_col - 1 : tile_col;
+        const int in_region =
+            !pbi->decode_partial ||
+            (col >= region->tile_col_start && col < region->tile_col_end &&
+             mi_row < region->mi_row_end);
         tile_data = pbi->tile_worker_data + tile_cols * tile_row + col;
+        // The end of the frame data is found by reading the last tile.
+        if (!in_region && region->skip_tiles &&
+            tile_data != pbi->tile_worker_data + tile_cols * tile_rows - 1)
+          continue;
         vp9_tile_set_col(&tile, cm, col);
         vp9_zero(tile_data->xd.left_context);
         vp9_zero(tile_data->xd.left_seg_context);
         for (mi_col = tile.mi_col_start; mi_col < tile.mi_col_end;
              mi_col += MI_BLOCK_SIZE) {
+          struct vpx_usec_timer timer;
+          dec_start_timing(pbi, &timer);
+          if (!in_region) {
+            PARTITION_TYPE partition[PARTITIONS_PER_SB];
+            int plane;
+            for (plane = 0; plane < MAX_MB_PLANE; ++plane)
+              tile_data->xd.plane[plane].dqcoeff = tile_data->dqcoeff;
+            tile_data->xd.partition = partition;
+            process_partition(tile_data, pbi, mi_row, mi_col, BLOCK_64X64, 4,
+                              PARSE, skip_block);
+            dec_end_timing(pbi, &timer, &pbi->stats.parse_us);
+            continue;
+          }
           if (pbi->row_mt == 1) {
             int plane;
             RowMTWorkerData *const row_mt_worker_data = pbi->row_mt_worker_data;
@@ -2115,6 +2641,13 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
           } else {
             decode_partition(tile_data, pbi, mi_row, mi_col, BLOCK_64X64, 4);
           }
+          if (cm->lf.filter_level && !cm->skip_loop_filter)
+            vp9_setup_mask(cm, mi_row, mi_col);
+          dec_end_timing(pbi, &timer, &pbi->stats.parse_us);
+          if (lf_sb_wavefront && mi_row > 0 && mi_col > 0) {
+            loop_filter_sb_cols(pbi, mi_row - MI_BLOCK_SIZE,
+                                mi_col - MI_BLOCK_SIZE, mi_col);
+          }
         }
         pbi->mb.corrupted |= tile_data->xd.corrupted;
         if (pbi->mb.corrupted)
@@ -2129,17 +2662,47 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
         // delay the loopfilter by 1 macroblock row.
         if (lf_start < 0) continue;
 
-        // decoding has completed: finish up the loop filter in this thread.
-        if (mi_row + MI_BLOCK_SIZE >= cm->mi_rows) continue;
-
-        winterface->sync(&pbi->lf_worker);
-        lf_data->start = lf_start;
-        lf_data->stop = mi_row;
-        if (pbi->max_threads > 1) {
-          winterface->launch(&pbi->lf_worker);
+        if (pbi->decode_partial) {
+          if (lf_start < region->mi_row_end) {
+            loop_filter_sb_cols(pbi, lf_start, region_mi_col_start,
+                                region_mi_col_end);
+          }
+          lf_data->start = lf_start;
+          lf_data->stop = mi_row;
+        } else if (lf_sb_wavefront) {
+          // Only the last superblock of the row above is left.
+          loop_filter_sb_cols(pbi, lf_start, aligned_cols - MI_BLOCK_SIZE,
+                              cm->mi_cols);
+          lf_data->start = lf_start;
+          lf_data->stop = mi_row;
+          report_rows_ready(pbi, mi_row);
         } else {
-          winterface->execute(&pbi->lf_worker);
+          // decoding has completed: finish up the loop filter in this thread.
+          if (mi_row + MI_BLOCK_SIZE >= cm->mi_rows) continue;
+
+          winterface->sync(&pbi->lf_worker);
+          report_rows_ready(pbi, lf_data->stop);
+          lf_data->start = lf_start;
+          lf_data->stop = mi_row;
+          if (pbi->max_threads > 1) {
+            winterface->launch(&pbi->lf_worker);
+          } else {
+            winterface->execute(&pbi->lf_worker);
+          }
+        }
+
+        // Filtering the next row modifies up to 7 rows above it in each plane,
+        // i.e. up to 14 luma rows with vertically subsampled chroma.
+        if (pbi->frame_parallel_decode) {
+          vp9_frameworker_broadcast(cm->buffer_pool, pbi->cur_buf,
+                                    (mi_row << MI_SIZE_LOG2) - 16);
         }
+      } else {
+        if (pbi->frame_parallel_decode) {
+          vp9_frameworker_broadcast(cm->buffer_pool, pbi->cur_buf,
+                                    (mi_row + MI_BLOCK_SIZE) << MI_SIZE_LOG2);
+        }
+        report_rows_ready(pbi, mi_row + MI_BLOCK_SIZE);
       }
     }
   }
@@ -2148,9 +2711,16 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi, const uint8_t *data,
   if (cm->lf.filter_level && !cm->skip_loop_filter) {
     LFWorkerData *const lf_data = (LFWorkerData *)pbi->lf_worker.data1;
     winterface->sync(&pbi->lf_worker);
-    lf_data->start = lf_data->stop;
-    lf_data->stop = cm->mi_rows;
-    winterface->execute(&pbi->lf_worker);
+    if (pbi->decode_partial) {
+      if (lf_data->stop < region->mi_row_end) {
+        loop_filter_sb_cols(pbi, lf_data->stop, region_mi_col_start,
+                            region_mi_col_end);
+      }
+    } else {
+      lf_data->start = lf_data->stop;
+      lf_data->stop = cm->mi_rows;
+      winterface->execute(&pbi->lf_worker);
+    }
   }
 
   // Get last tile data.
@@ -2195,6 +2765,7 @@ static int tile_worker_hook(void *arg1, void *arg2) {
 
   volatile int mi_row = 0;
   volatile int n = tile_data->buf_start;
+  struct vpx_usec_timer timer;
   if (setjmp(tile_data->error_info.jmp)) {
     tile_data->error_info.setjmp = 0;
     tile_data->xd.corrupted = 1;
@@ -2211,6 +2782,7 @@ static int tile_worker_hook(void *arg1, void *arg2) {
 
   tile_data->xd.corrupted = 0;
 
+  dec_start_timing(pbi, &timer);
   do {
     int mi_col;
     const TileBuffer *const buf = pbi->tile_buffers + n;
@@ -2236,6 +2808,8 @@ static int tile_worker_hook(void *arg1, void *arg2) {
       for (mi_col = tile->mi_col_start; mi_col < tile->mi_col_end;
            mi_col += MI_BLOCK_SIZE) {
         decode_partition(tile_data, pbi, mi_row, mi_col, BLOCK_64X64, 4);
+        if (cm->lf.filter_level && !cm->skip_loop_filter)
+          vp9_setup_mask(cm, mi_row, mi_col);
       }
       if (pbi->lpf_mt_opt && cm->lf.filter_level && !cm->skip_loop_filter) {
         const int aligned_rows = mi_cols_aligned_to_sb(cm->mi_rows);
@@ -2251,6 +2825,7 @@ static int tile_worker_hook(void *arg1, void *arg2) {
       bit_reader_end = vpx_reader_find_end(&tile_data->bit_reader);
     }
   } while (!tile_data->xd.corrupted && ++n <= tile_data->buf_end);
+  dec_end_timing(pbi, &timer, &tile_data->decode_us);
 
   if (pbi->lpf_mt_opt && n < tile_data->buf_end && cm->lf.filter_level &&
       !cm->skip_loop_filter) {
@@ -2264,7 +2839,9 @@ static int tile_worker_hook(void *arg1, void *arg2) {
 
   if (pbi->lpf_mt_opt && !tile_data->xd.corrupted && cm->lf.filter_level &&
       !cm->skip_loop_filter) {
+    dec_start_timing(pbi, &timer);
     vp9_loopfilter_rows(lf_data, lf_sync);
+    dec_end_timing(pbi, &timer, &tile_data->loop_filter_us);
   }
 
   tile_data->data_end = bit_reader_end;
@@ -2295,6 +2872,8 @@ static INLINE void init_mt(VP9Decoder *pbi) {
 
       winterface->init(worker);
       worker->thread_name = "vpx tile worker";
+      worker->submit = pbi->thread_pool.submit;
+      worker->submit_priv = pbi->thread_pool.pool_priv;
       if (n < num_threads - 1 && !winterface->reset(worker)) {
         do {
           winterface->end(&pbi->tile_workers[pbi->num_tile_workers - 1]);
@@ -2321,8 +2900,6 @@ static INLINE void init_mt(VP9Decoder *pbi) {
 
   memset(cm->above_seg_context, 0,
          sizeof(*cm->above_seg_context) * aligned_mi_cols);
-
-  vp9_reset_lfm(cm);
 }
 
 static const uint8_t *decode_tiles_row_wise_mt(VP9Decoder *pbi,
@@ -2341,6 +2918,7 @@ static const uint8_t *decode_tiles_row_wise_mt(VP9Decoder *pbi,
   const int sb_cols = mi_cols_aligned_to_sb(cm->mi_cols) >> MI_BLOCK_SIZE_LOG2;
   VP9LfSync *lf_row_sync = &pbi->lf_row_sync;
   YV12_BUFFER_CONFIG *const new_fb = get_frame_new_buffer(cm);
+  int class_size[NUM_JOB_TYPES];
 
   assert(tile_cols <= (1 << 6));
   assert(tile_rows == 1);
@@ -2365,6 +2943,8 @@ static const uint8_t *decode_tiles_row_wise_mt(VP9Decoder *pbi,
     }
 
     thread_data->pbi = pbi;
+    vp9_zero(thread_data->job_us);
+    thread_data->idle_us = 0;
 
     worker->hook = row_decode_worker_hook;
     worker->data1 = thread_data;
@@ -2379,7 +2959,9 @@ static const uint8_t *decode_tiles_row_wise_mt(VP9Decoder *pbi,
   }
 
   /* Reset the jobq to start of the jobq buffer */
-  vp9_jobq_reset(&row_mt_worker_data->jobq);
+  get_jobq_class_sizes(cm, class_size);
+  vp9_jobq_reset(&row_mt_worker_data->jobq, sizeof(Job), NUM_JOB_TYPES,
+                 class_size);
   row_mt_worker_data->num_tiles_done = 0;
   row_mt_worker_data->data_end = NULL;
 
@@ -2401,7 +2983,8 @@ static const uint8_t *decode_tiles_row_wise_mt(VP9Decoder *pbi,
     parse_job.row_num = 0;
     parse_job.tile_col = col;
     parse_job.job_type = PARSE_JOB;
-    vp9_jobq_queue(&row_mt_worker_data->jobq, &parse_job, sizeof(parse_job));
+    vp9_jobq_queue(&row_mt_worker_data->jobq, PARSE_JOB, &parse_job,
+                   sizeof(parse_job));
   }
 
   for (i = 0; i < num_workers; ++i) {
@@ -2425,6 +3008,33 @@ static const uint8_t *decode_tiles_row_wise_mt(VP9Decoder *pbi,
 
   pbi->mb.corrupted = corrupted;
 
+  if (pbi->collect_stats) {
+    vpx_decode_stats_t *const stats = &pbi->stats;
+    stats->num_workers = VPXMIN(num_workers, VPX_DECODE_STATS_MAX_WORKERS);
+    for (n = 0; n < num_workers; ++n) {
+      const ThreadData *const thread_data = &row_mt_worker_data->thread_data[n];
+      const int64_t busy_us = thread_data->job_us[PARSE_JOB] +
+                              thread_data->job_us[RECON_JOB] +
+                              thread_data->job_us[LPF_JOB];
+      stats->parse_us += thread_data->job_us[PARSE_JOB];
+      stats->recon_us += thread_data->job_us[RECON_JOB];
+      stats->loop_filter_us += thread_data->job_us[LPF_JOB];
+      if (n < stats->num_workers) {
+        stats->worker_busy_us[n] += busy_us;
+        stats->worker_idle_us[n] += thread_data->idle_us;
+      }
+    }
+  }
+
+  for (i = 0; i < NUM_JOB_TYPES; ++i) {
+    int num_jobs;
+    int64_t wait_us;
+    vp9_jobq_get_wait_stats(&row_mt_worker_data->jobq, i, &num_jobs,
+                            &wait_us);
+    row_mt_worker_data->job_count[i] += num_jobs;
+    row_mt_worker_data->job_wait_us[i] += wait_us;
+  }
+
   {
     /* Set data end */
     TileWorkerData *const tile_data = &pbi->tile_worker_data[tile_cols - 1];
@@ -2536,6 +3146,8 @@ static const uint8_t *decode_tiles_mt(VP9Decoder *pbi, const uint8_t *data,
       tile_data->buf_start = buf_start;
       tile_data->buf_end = buf_start + count - 1;
       tile_data->data_end = data_end;
+      tile_data->decode_us = 0;
+      tile_data->loop_filter_us = 0;
       buf_start += count;
 
       worker->had_error = 0;
@@ -2556,6 +3168,8 @@ static const uint8_t *decode_tiles_mt(VP9Decoder *pbi, const uint8_t *data,
       // detected, there's no point in continuing to decode tiles.
       pbi->mb.corrupted |= !winterface->sync(worker);
       if (!bit_reader_end) bit_reader_end = tile_data->data_end;
+      pbi->stats.parse_us += tile_data->decode_us;
+      pbi->stats.loop_filter_us += tile_data->loop_filter_us;
     }
   }
 
@@ -2637,6 +3251,22 @@ static INLINE void flush_all_fb_on_key(VP9_COMMON *cm) {
   }
 }
 
+// Drops the references of the reference map, e.g. to resync on a key frame.
+// Unlike flush_all_fb_on_key(), this leaves buffers used by frames that are
+// decoded in parallel untouched.
+static void reset_ref_frame_map(VP9Decoder *pbi) {
+  VP9_COMMON *const cm = &pbi->common;
+  if (pbi->frame_parallel_decode) {
+    BufferPool *const pool = cm->buffer_pool;
+    int i;
+    lock_buffer_pool(pool);
+    for (i = 0; i < REF_FRAMES; ++i)
+      decrease_ref_count(cm->ref_frame_map[i], pool->frame_bufs, pool);
+    unlock_buffer_pool(pool);
+  }
+  memset(&cm->ref_frame_map, -1, sizeof(cm->ref_frame_map));
+}
+
 static size_t read_uncompressed_header(VP9Decoder *pbi,
                                        struct vpx_read_bit_buffer *rb) {
   VP9_COMMON *const cm = &pbi->common;
@@ -2667,13 +3297,20 @@ static size_t read_uncompressed_header(VP9Decoder *pbi,
   if (cm->show_existing_frame) {
     // Show an existing frame directly.
     const int frame_to_show = cm->ref_frame_map[vpx_rb_read_literal(rb, 3)];
+    lock_buffer_pool(pool);
     if (frame_to_show < 0 || frame_bufs[frame_to_show].ref_count < 1) {
+      unlock_buffer_pool(pool);
       vpx_internal_error(&cm->error, VPX_CODEC_UNSUP_BITSTREAM,
                          "Buffer %d does not contain a decoded frame",
                          frame_to_show);
     }
 
     ref_cnt_fb(frame_bufs, &cm->new_fb_idx, frame_to_show);
+    unlock_buffer_pool(pool);
+    if (pbi->frame_parallel_decode) {
+      memcpy(cm->next_ref_frame_map, cm->ref_frame_map,
+             sizeof(cm->ref_frame_map));
+    }
     pbi->refresh_frame_flags = 0;
     cm->lf.filter_level = 0;
     cm->show_frame = 1;
@@ -2700,8 +3337,8 @@ static size_t read_uncompressed_header(VP9Decoder *pbi,
 
     setup_frame_size(cm, rb);
     if (pbi->need_resync) {
-      memset(&cm->ref_frame_map, -1, sizeof(cm->ref_frame_map));
-      flush_all_fb_on_key(cm);
+      reset_ref_frame_map(pbi);
+      if (!pbi->frame_parallel_decode) flush_all_fb_on_key(cm);
       pbi->need_resync = 0;
     }
   } else {
@@ -2733,7 +3370,7 @@ static size_t read_uncompressed_header(VP9Decoder *pbi,
       pbi->refresh_frame_flags = vpx_rb_read_literal(rb, REF_FRAMES);
       setup_frame_size(cm, rb);
       if (pbi->need_resync) {
-        memset(&cm->ref_frame_map, -1, sizeof(cm->ref_frame_map));
+        reset_ref_frame_map(pbi);
         pbi->need_resync = 0;
       }
     } else if (pbi->need_resync != 1) { /* Skip if need resync */
@@ -2795,6 +3432,7 @@ static size_t read_uncompressed_header(VP9Decoder *pbi,
   cm->frame_context_idx = vpx_rb_read_literal(rb, FRAME_CONTEXTS_LOG2);
 
   // Generate next_ref_frame_map.
+  lock_buffer_pool(pool);
   for (mask = pbi->refresh_frame_flags; mask; mask >>= 1) {
     if (mask & 1) {
       cm->next_ref_frame_map[ref_index] = cm->new_fb_idx;
@@ -2814,8 +3452,20 @@ static size_t read_uncompressed_header(VP9Decoder *pbi,
     if (cm->ref_frame_map[ref_index] >= 0)
       ++frame_bufs[cm->ref_frame_map[ref_index]].ref_count;
   }
+  unlock_buffer_pool(pool);
   pbi->hold_ref_buf = 1;
 
+  // Pick up the segmentation map left by the previous frame, as a serial
+  // decoder would have. A size change resets it.
+  if (pbi->fp_last_seg_map != NULL && cm->last_frame_seg_map != NULL) {
+    if (cm->width == cm->last_width && cm->height == cm->last_height) {
+      memcpy(cm->last_frame_seg_map, pbi->fp_last_seg_map,
+             cm->mi_rows * cm->mi_cols);
+    } else {
+      memset(cm->last_frame_seg_map, 0, cm->mi_rows * cm->mi_cols);
+    }
+  }
+
   if (frame_is_intra_only(cm) || cm->error_resilient_mode)
     vp9_setup_past_independence(cm);
 
@@ -2975,6 +3625,8 @@ void vp9_decode_frame(VP9Decoder *pbi, const uint8_t *data,
   if (!first_partition_size) {
     // showing a frame directly
     *p_data_end = data + (cm->profile <= PROFILE_2 ? 1 : 2);
+    if (setup_scaled_output(pbi, new_fb))
+      scale_rows(pbi, new_fb, new_fb->y_crop_height);
     return;
   }
 
@@ -2988,6 +3640,20 @@ void vp9_decode_frame(VP9Decoder *pbi, const uint8_t *data,
       cm->height == cm->last_height && !cm->last_intra_only &&
       cm->last_show_frame && (cm->last_frame_type != KEY_FRAME);
 
+  pbi->decode_partial = setup_decode_region(pbi);
+
+  // Only shown frames are scaled, and only if they are decoded in full.
+  pbi->scale_output = 0;
+  if (cm->show_frame && !pbi->decode_partial) setup_scaled_output(pbi, new_fb);
+  pbi->report_rows = (pbi->rows_ready_cb != NULL || pbi->scale_output) &&
+                     cm->show_frame && !pbi->decode_partial;
+  pbi->rows_ready = 0;
+  pbi->lf_sb_rows_filtered = 0;
+#if CONFIG_MULTITHREAD
+  pbi->lf_row_sync.row_filtered = pbi->report_rows ? lf_row_filtered : NULL;
+  pbi->lf_row_sync.row_filtered_priv = pbi;
+#endif
+
   vp9_setup_block_planes(xd, cm->subsampling_x, cm->subsampling_y);
 
   *cm->fc = cm->frame_contexts[cm->frame_context_idx];
@@ -3005,6 +3671,23 @@ void vp9_decode_frame(VP9Decoder *pbi, const uint8_t *data,
     vp9_loop_filter_frame_init(cm, cm->lf.filter_level);
   }
 
+  if (pbi->collect_stats) {
+    vpx_usec_timer_mark(&pbi->frame_timer);
+    pbi->stats.header_us += vpx_usec_timer_elapsed(&pbi->frame_timer);
+  }
+
+  // Unless the segmentation map or backward adaptation of the entropy context
+  // is needed, the rest of the frame does not change the state the next frame
+  // starts from, so it can be released to the next frame worker now.
+  if (pbi->frame_parallel_decode && !cm->seg.enabled &&
+      (!cm->refresh_frame_context || cm->frame_parallel_decoding_mode)) {
+    if (cm->refresh_frame_context) {
+      context_updated = 1;
+      cm->frame_contexts[cm->frame_context_idx] = *cm->fc;
+    }
+    vp9_frameworker_signal_context_ready(pbi);
+  }
+
   if (pbi->tile_worker_data == NULL ||
       (tile_cols * tile_rows) != pbi->total_tiles) {
     const int num_tile_workers =
@@ -3019,8 +3702,10 @@ void vp9_decode_frame(VP9Decoder *pbi, const uint8_t *data,
     pbi->total_tiles = tile_rows * tile_cols;
   }
 
+  // A partially decoded frame is decoded by this thread, which filters the
+  // region as it goes.
   if (pbi->max_threads > 1 && tile_rows == 1 &&
-      (tile_cols > 1 || pbi->row_mt == 1)) {
+      (tile_cols > 1 || pbi->row_mt == 1) && !pbi->decode_partial) {
     if (pbi->row_mt == 1) {
       *p_data_end =
           decode_tiles_row_wise_mt(pbi, data + first_partition_size, data_end);
@@ -3030,11 +3715,14 @@ void vp9_decode_frame(VP9Decoder *pbi, const uint8_t *data,
       if (!pbi->lpf_mt_opt) {
         if (!xd->corrupted) {
           if (!cm->skip_loop_filter) {
+            struct vpx_usec_timer timer;
             // If multiple threads are used to decode tiles, then we use those
             // threads to do parallel loopfiltering.
+            dec_start_timing(pbi, &timer);
             vp9_loop_filter_frame_mt(
                 new_fb, cm, pbi->mb.plane, cm->lf.filter_level, 0, 0,
                 pbi->tile_workers, pbi->num_tile_workers, &pbi->lf_row_sync);
+            dec_end_timing(pbi, &timer, &pbi->stats.loop_filter_us);
           }
         } else {
           vpx_internal_error(&cm->error, VPX_CODEC_CORRUPT_FRAME,
@@ -3047,6 +3735,7 @@ void vp9_decode_frame(VP9Decoder *pbi, const uint8_t *data,
   }
 
   if (!xd->corrupted) {
+    report_rows_ready(pbi, cm->mi_rows);
     if (!cm->error_resilient_mode && !cm->frame_parallel_decoding_mode) {
       vp9_adapt_coef_probs(cm);
 
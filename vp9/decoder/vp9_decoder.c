@@ -173,6 +173,9 @@ VP9Decoder *vp9_decoder_create(BufferPool *const pool) {
   if (!cm) return NULL;
 
   vp9_zero(*pbi);
+#if CONFIG_MULTITHREAD
+  pthread_mutex_init(&pbi->rows_ready_mutex, NULL);
+#endif
 
   if (setjmp(cm->error.jmp)) {
     cm->error.setjmp = 0;
@@ -197,6 +200,7 @@ VP9Decoder *vp9_decoder_create(BufferPool *const pool) {
 
   init_frame_indexes(cm);
   pbi->ready_for_new_data = 1;
+  pbi->compact_mi = 1;
   pbi->common.buffer_pool = pool;
 
   cm->bit_depth = VPX_BITS_8;
@@ -239,7 +243,8 @@ void vp9_decoder_remove(VP9Decoder *pbi) {
   if (pbi->row_mt == 1) {
     vp9_dec_free_row_mt_mem(pbi->row_mt_worker_data);
     if (pbi->row_mt_worker_data != NULL) {
-      vp9_jobq_deinit(&pbi->row_mt_worker_data->jobq);
+      if (pbi->row_mt_worker_data->jobq_buf != NULL)
+        vp9_jobq_deinit(&pbi->row_mt_worker_data->jobq);
       vpx_free(pbi->row_mt_worker_data->jobq_buf);
 #if CONFIG_MULTITHREAD
       pthread_mutex_destroy(&pbi->row_mt_worker_data->recon_done_mutex);
@@ -248,6 +253,11 @@ void vp9_decoder_remove(VP9Decoder *pbi) {
     vpx_free(pbi->row_mt_worker_data);
   }
 
+#if CONFIG_MULTITHREAD
+  pthread_mutex_destroy(&pbi->rows_ready_mutex);
+#endif
+  vpx_free_frame_buffer(&pbi->scaled_frame);
+
   vp9_remove_common(&pbi->common);
   vpx_free(pbi);
 }
@@ -340,6 +350,7 @@ static void swap_frame_buffers(VP9Decoder *pbi) {
   BufferPool *const pool = cm->buffer_pool;
   RefCntBuffer *const frame_bufs = cm->buffer_pool->frame_bufs;
 
+  lock_buffer_pool(pool);
   for (mask = pbi->refresh_frame_flags; mask; mask >>= 1) {
     const int old_idx = cm->ref_frame_map[ref_index];
     // Current thread releases the holding of reference frame.
@@ -362,7 +373,10 @@ static void swap_frame_buffers(VP9Decoder *pbi) {
   pbi->hold_ref_buf = 0;
   cm->frame_to_show = get_frame_new_buffer(cm);
 
-  --frame_bufs[cm->new_fb_idx].ref_count;
+  // In frame parallel decode the caller drops this hold after taking its own
+  // reference on a frame that is to be output.
+  if (!pbi->frame_parallel_decode) --frame_bufs[cm->new_fb_idx].ref_count;
+  unlock_buffer_pool(pool);
 
   // Invalidate these references until the next frame starts.
   for (ref_index = 0; ref_index < 3; ref_index++)
@@ -386,6 +400,7 @@ static void release_fb_on_decoder_exit(VP9Decoder *pbi) {
   // Release all the reference buffers if worker thread is holding them.
   if (pbi->hold_ref_buf == 1) {
     int ref_index = 0, mask;
+    lock_buffer_pool(pool);
     for (mask = pbi->refresh_frame_flags; mask; mask >>= 1) {
       const int old_idx = cm->ref_frame_map[ref_index];
       // Current thread releases the holding of reference frame.
@@ -403,7 +418,13 @@ static void release_fb_on_decoder_exit(VP9Decoder *pbi) {
       const int old_idx = cm->ref_frame_map[ref_index];
       decrease_ref_count(old_idx, frame_bufs, pool);
     }
+    unlock_buffer_pool(pool);
     pbi->hold_ref_buf = 0;
+  } else if (pbi->frame_parallel_decode) {
+    // The frame failed before its reference map was built. The next frame
+    // continues from the current one, whose references are still held.
+    memcpy(cm->next_ref_frame_map, cm->ref_frame_map,
+           sizeof(cm->ref_frame_map));
   }
 }
 
@@ -416,6 +437,8 @@ int vp9_receive_compressed_data(VP9Decoder *pbi, size_t size,
   int retcode = 0;
   cm->error.error_code = VPX_CODEC_OK;
 
+  if (pbi->collect_stats) vpx_usec_timer_start(&pbi->frame_timer);
+
   if (size == 0) {
     // This is used to signal that we are missing frames.
     // We do not know if the missing frame(s) was supposed to update
@@ -433,23 +456,27 @@ int vp9_receive_compressed_data(VP9Decoder *pbi, size_t size,
 
   pbi->ready_for_new_data = 0;
 
-  // Check if the previous frame was a frame without any references to it.
-  if (cm->new_fb_idx >= 0 && frame_bufs[cm->new_fb_idx].ref_count == 0 &&
-      !frame_bufs[cm->new_fb_idx].released) {
-    pool->release_fb_cb(pool->cb_priv,
-                        &frame_bufs[cm->new_fb_idx].raw_frame_buffer);
-    frame_bufs[cm->new_fb_idx].released = 1;
-  }
+  // In frame parallel decode the frame buffer is assigned by the caller, which
+  // also releases buffers that are no longer referenced.
+  if (!pbi->frame_parallel_decode) {
+    // Check if the previous frame was a frame without any references to it.
+    if (cm->new_fb_idx >= 0 && frame_bufs[cm->new_fb_idx].ref_count == 0 &&
+        !frame_bufs[cm->new_fb_idx].released) {
+      pool->release_fb_cb(pool->cb_priv,
+                          &frame_bufs[cm->new_fb_idx].raw_frame_buffer);
+      frame_bufs[cm->new_fb_idx].released = 1;
+    }
 
-  // Find a free frame buffer. Return error if can not find any.
-  cm->new_fb_idx = get_free_fb(cm);
-  if (cm->new_fb_idx == INVALID_IDX) {
-    pbi->ready_for_new_data = 1;
-    release_fb_on_decoder_exit(pbi);
-    vpx_clear_system_state();
-    vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
-                       "Unable to find free frame buffer");
-    return cm->error.error_code;
+    // Find a free frame buffer. Return error if can not find any.
+    cm->new_fb_idx = get_free_fb(cm);
+    if (cm->new_fb_idx == INVALID_IDX) {
+      pbi->ready_for_new_data = 1;
+      release_fb_on_decoder_exit(pbi);
+      vpx_clear_system_state();
+      vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
+                         "Unable to find free frame buffer");
+      return cm->error.error_code;
+    }
   }
 
   // Assign a MV array to the frame buffer.
@@ -463,7 +490,9 @@ int vp9_receive_compressed_data(VP9Decoder *pbi, size_t size,
     pbi->ready_for_new_data = 1;
     release_fb_on_decoder_exit(pbi);
     // Release current frame.
+    lock_buffer_pool(pool);
     decrease_ref_count(cm->new_fb_idx, frame_bufs, pool);
+    unlock_buffer_pool(pool);
     vpx_clear_system_state();
     return -1;
   }
@@ -476,18 +505,28 @@ int vp9_receive_compressed_data(VP9Decoder *pbi, size_t size,
   vpx_clear_system_state();
 
   if (!cm->show_existing_frame) {
-    cm->last_show_frame = cm->show_frame;
-    cm->prev_frame = cm->cur_frame;
     if (cm->seg.enabled) vp9_swap_current_and_last_seg_map(cm);
   }
 
   if (cm->show_frame) cm->cur_show_frame_fb_idx = cm->new_fb_idx;
 
-  // Update progress in frame parallel decode.
-  cm->last_width = cm->width;
-  cm->last_height = cm->height;
-  if (cm->show_frame) {
-    cm->current_video_frame++;
+  // In frame parallel decode this state is passed to the next frame by
+  // vp9_frameworker_copy_context().
+  if (!pbi->frame_parallel_decode) {
+    if (!cm->show_existing_frame) {
+      cm->last_show_frame = cm->show_frame;
+      cm->prev_frame = cm->cur_frame;
+    }
+    cm->last_width = cm->width;
+    cm->last_height = cm->height;
+    if (cm->show_frame) {
+      cm->current_video_frame++;
+    }
+  }
+
+  if (pbi->collect_stats) {
+    vpx_usec_timer_mark(&pbi->frame_timer);
+    pbi->stats.frame_us += vpx_usec_timer_elapsed(&pbi->frame_timer);
   }
 
   cm->error.setjmp = 0;
@@ -511,9 +550,18 @@ int vp9_get_raw_frame(VP9Decoder *pbi, YV12_BUFFER_CONFIG *sd,
 
   pbi->ready_for_new_data = 1;
 
+  // A scaled down frame is returned as is.
+  if (pbi->scale_output) {
+    *sd = pbi->scaled_frame;
+    return 0;
+  }
+
 #if CONFIG_VP9_POSTPROC
   if (!cm->show_existing_frame) {
+    struct vpx_usec_timer timer;
+    dec_start_timing(pbi, &timer);
     ret = vp9_post_proc_frame(cm, sd, flags, cm->width);
+    dec_end_timing(pbi, &timer, &pbi->stats.postproc_us);
   } else {
     *sd = *cm->frame_to_show;
     ret = 0;
@@ -13,8 +13,11 @@
 
 #include "./vpx_config.h"
 
+#include "vpx/vp8dx.h"
 #include "vpx/vpx_codec.h"
+#include "vpx/vpx_image.h"
 #include "vpx_dsp/bitreader.h"
+#include "vpx_ports/vpx_timer.h"
 #include "vpx_scale/yv12config.h"
 #include "vpx_util/vpx_pthread.h"
 #include "vpx_util/vpx_thread.h"
@@ -32,12 +35,18 @@ extern "C" {
 #define DQCOEFFS_PER_SB_LOG2 12
 #define PARTITIONS_PER_SB 85
 
-typedef enum JobType { PARSE_JOB, RECON_JOB, LPF_JOB } JobType;
+// Row-MT job types, also their queue priorities: parsing is on the critical
+// path, and reconstruction gates the loop filter.
+typedef enum JobType { PARSE_JOB, RECON_JOB, LPF_JOB, NUM_JOB_TYPES } JobType;
 
 typedef struct ThreadData {
   struct VP9Decoder *pbi;
   LFWorkerData *lf_data;
   VP9LfSync *lf_sync;
+  // Time spent running each JobType and waiting for jobs in the current
+  // frame, only counted with VP9D_SET_COLLECT_STATS.
+  int64_t job_us[NUM_JOB_TYPES];
+  int64_t idle_us;
 } ThreadData;
 
 typedef struct TileBuffer {
@@ -53,6 +62,13 @@ typedef struct TileWorkerData {
   FRAME_COUNTS counts;
   LFWorkerData *lf_data;
   VP9LfSync *lf_sync;
+  // Time spent decoding and loop filtering by this tile worker in the current
+  // frame, only counted with VP9D_SET_COLLECT_STATS.
+  int64_t decode_us;
+  int64_t loop_filter_us;
+  // Entry of VP9_COMMON::mi for the next block of the current superblock, see
+  // VP9Decoder::compact_mi.
+  MODE_INFO *next_mi;
   DECLARE_ALIGNED(16, MACROBLOCKD, xd);
   /* dqcoeff are shared by all the planes. So planes must be decoded serially */
   DECLARE_ALIGNED(32, tran_low_t, dqcoeff[32 * 32]);
@@ -77,6 +93,10 @@ typedef struct RowMTWorkerData {
   size_t jobq_size;
   int num_tiles_done;
   int num_jobs;
+  // Jobs run and the total time they spent queued, per JobType, accumulated
+  // over all frames.
+  int64_t job_count[NUM_JOB_TYPES];
+  int64_t job_wait_us[NUM_JOB_TYPES];
 #if CONFIG_MULTITHREAD
   pthread_mutex_t recon_done_mutex;
   pthread_mutex_t *recon_sync_mutex;
@@ -92,6 +112,24 @@ typedef struct Job {
   JobType job_type;
 } Job;
 
+// The part of a frame decoded for VP9D_SET_DECODE_REGION.
+typedef struct DecodeRegion {
+  // The superblocks of tile columns [tile_col_start, tile_col_end) above
+  // mi_row_end are reconstructed.
+  int tile_col_start;
+  int tile_col_end;
+  int mi_row_end;
+  // Set if the other tiles are not read at all. Otherwise they are parsed for
+  // the state the following frames depend on.
+  int skip_tiles;
+} DecodeRegion;
+
+// Called with the luma rows [start, end) of 'buf' that no longer change while
+// the frame is decoded. The chroma rows they cover are final too.
+typedef void (*vp9_rows_ready_cb_fn_t)(void *priv,
+                                       const YV12_BUFFER_CONFIG *buf,
+                                       int start, int end);
+
 typedef struct VP9Decoder {
   DECLARE_ALIGNED(16, MACROBLOCKD, mb);
 
@@ -124,7 +162,62 @@ typedef struct VP9Decoder {
 
   int row_mt;
   int lpf_mt_opt;
+  // Store the mode info of the blocks of each superblock together instead of
+  // at their positions in the frame, see get_block_mi(). Set by default.
+  int compact_mi;
   RowMTWorkerData *row_mt_worker_data;
+
+  // Set with VP9D_SET_THREAD_POOL. The workers then run as tasks of the pool.
+  vpx_thread_pool_t thread_pool;
+
+  // Frame-based multi-threading: each frame worker owns a decoder and frames
+  // overlap, waiting on the rows of their references they predict from.
+  int frame_parallel_decode;
+  // Set once the state the next frame copies from this decoder is final.
+  // Protected by BufferPool::pool_mutex.
+  int frame_context_ready;
+  int hold_prev_frame_buf;  // hold cm->prev_frame until the frame is decoded.
+  // Segmentation map of the previous frame when it was decoded by another
+  // frame worker.
+  const uint8_t *fp_last_seg_map;
+
+  // Requested with VP9D_SET_DECODE_REGION. Frames are decoded in full while it
+  // is empty.
+  vpx_image_rect_t decode_rect;
+  // Set if only 'region' of the current frame is decoded.
+  int decode_partial;
+  DecodeRegion region;
+
+  // Requested with VP9D_SET_OUTPUT_SIZE, 0 to output frames at full size.
+  // 'scale_output' is set if the current frame is scaled down into
+  // 'scaled_frame' as its rows become final, of which 'scaled_rows' luma rows
+  // have been written.
+  int output_width;
+  int output_height;
+  int scale_output;
+  YV12_BUFFER_CONFIG scaled_frame;
+  int scaled_rows;
+
+  // Set with VP9D_SET_COLLECT_STATS. 'stats' then holds the times of the
+  // current frame, started by 'frame_timer'.
+  int collect_stats;
+  vpx_decode_stats_t stats;
+  struct vpx_usec_timer frame_timer;
+
+  // If set, called from top to bottom as the rows of each shown frame become
+  // final. 'report_rows' is set for frames that are reported, of which
+  // 'rows_ready' luma rows have been, and of which the top
+  // 'lf_sb_rows_filtered' superblock rows are known to be filtered by
+  // 'lf_row_sync'.
+  vp9_rows_ready_cb_fn_t rows_ready_cb;
+  void *rows_ready_priv;
+  int report_rows;
+  int rows_ready;
+  int lf_sb_rows_filtered;
+#if CONFIG_MULTITHREAD
+  // Serializes the reports of the loop filter threads.
+  pthread_mutex_t rows_ready_mutex;
+#endif
 } VP9Decoder;
 
 int vp9_receive_compressed_data(struct VP9Decoder *pbi, size_t size,
@@ -167,6 +260,21 @@ void vp9_dec_alloc_row_mt_mem(RowMTWorkerData *row_mt_worker_data,
                               int num_jobs);
 void vp9_dec_free_row_mt_mem(RowMTWorkerData *row_mt_worker_data);
 
+static INLINE void dec_start_timing(const VP9Decoder *pbi,
+                                    struct vpx_usec_timer *timer) {
+  if (pbi->collect_stats) vpx_usec_timer_start(timer);
+}
+
+// Adds the time since dec_start_timing() to 'total'.
+static INLINE void dec_end_timing(const VP9Decoder *pbi,
+                                  struct vpx_usec_timer *timer,
+                                  int64_t *total) {
+  if (pbi->collect_stats) {
+    vpx_usec_timer_mark(timer);
+    *total += vpx_usec_timer_elapsed(timer);
+  }
+}
+
 static INLINE void decrease_ref_count(int idx, RefCntBuffer *const frame_bufs,
                                       BufferPool *const pool) {
   if (idx >= 0 && frame_bufs[idx].ref_count > 0) {
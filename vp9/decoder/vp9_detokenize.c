@@ -8,6 +8,8 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <assert.h>
+
 #include "vpx_mem/vpx_mem.h"
 #include "vpx_ports/mem.h"
 
@@ -29,8 +31,18 @@
     if (counts) ++coef_counts[band][ctx][token]; \
   } while (0)
 
-static INLINE int read_bool(vpx_reader *r, int prob, BD_VALUE *value,
-                            int *count, unsigned int *range) {
+static INLINE void fill_value(vpx_reader *r, BD_VALUE *value, int *count) {
+  r->value = *value;
+  r->count = *count;
+  vpx_reader_fill_fast(r);
+  *value = r->value;
+  *count = r->count;
+}
+
+// Reads a bool without refilling 'value'; the caller makes sure enough bits
+// are buffered.
+static INLINE int read_bool_buffered(int prob, BD_VALUE *value, int *count,
+                                     unsigned int *range) {
   const unsigned int split = (*range * prob + (256 - prob)) >> CHAR_BIT;
   const BD_VALUE bigsplit = (BD_VALUE)split << (BD_VALUE_SIZE - CHAR_BIT);
 #if CONFIG_BITSTREAM_DEBUG
@@ -48,13 +60,7 @@ static INLINE int read_bool(vpx_reader *r, int prob, BD_VALUE *value,
   }
 #endif
 
-  if (*count < 0) {
-    r->value = *value;
-    r->count = *count;
-    vpx_reader_fill(r);
-    *value = r->value;
-    *count = r->count;
-  }
+  assert(*count >= 0);
 
   if (*value >= bigsplit) {
     *range = *range - split;
@@ -104,6 +110,24 @@ static INLINE int read_bool(vpx_reader *r, int prob, BD_VALUE *value,
   return 0;
 }
 
+static INLINE int read_bool(vpx_reader *r, int prob, BD_VALUE *value,
+                            int *count, unsigned int *range) {
+  if (*count < 0) fill_value(r, value, count);
+  return read_bool_buffered(prob, value, count, range);
+}
+
+#if SIZE_MAX == 0xffffffffffffffffULL
+// A bool consumes at most 7 bits and a refill leaves at least 49 bits in a
+// 64-bit 'value', so after making sure TOKEN_MIN_BITS are buffered the token
+// tree, at most 7 bools after the last check, is read without refill checks.
+#define TOKEN_MIN_BITS (6 * 7)
+#define read_token_bool(r, prob, value, count, range) \
+  read_bool_buffered(prob, value, count, range)
+#else
+#define TOKEN_MIN_BITS 0
+#define read_token_bool read_bool
+#endif
+
 static INLINE int read_coeff(vpx_reader *r, const vpx_prob *probs, int n,
                              BD_VALUE *value, int *count, unsigned int *range) {
   int i, val = 0;
@@ -161,12 +185,14 @@ static int decode_coefs(const MACROBLOCKD *xd, PLANE_TYPE type,
     band = *band_translate++;
     prob = coef_probs[band][ctx];
     if (counts) ++eob_branch_count[band][ctx];
-    if (!read_bool(r, prob[EOB_CONTEXT_NODE], &value, &count, &range)) {
+    if (count < TOKEN_MIN_BITS) fill_value(r, &value, &count);
+    if (!read_token_bool(r, prob[EOB_CONTEXT_NODE], &value, &count, &range)) {
       INCREMENT_COUNT(EOB_MODEL_TOKEN);
       break;
     }
 
-    while (!read_bool(r, prob[ZERO_CONTEXT_NODE], &value, &count, &range)) {
+    while (
+        !read_token_bool(r, prob[ZERO_CONTEXT_NODE], &value, &count, &range)) {
       INCREMENT_COUNT(ZERO_TOKEN);
       dqv = dq[1];
       token_cache[scan[c]] = 0;
@@ -180,23 +206,24 @@ static int decode_coefs(const MACROBLOCKD *xd, PLANE_TYPE type,
       ctx = get_coef_context(nb, token_cache, c);
       band = *band_translate++;
       prob = coef_probs[band][ctx];
+      if (count < TOKEN_MIN_BITS) fill_value(r, &value, &count);
     }
 
-    if (read_bool(r, prob[ONE_CONTEXT_NODE], &value, &count, &range)) {
+    if (read_token_bool(r, prob[ONE_CONTEXT_NODE], &value, &count, &range)) {
       const vpx_prob *p = vp9_pareto8_full[prob[PIVOT_NODE] - 1];
       INCREMENT_COUNT(TWO_TOKEN);
-      if (read_bool(r, p[0], &value, &count, &range)) {
-        if (read_bool(r, p[3], &value, &count, &range)) {
+      if (read_token_bool(r, p[0], &value, &count, &range)) {
+        if (read_token_bool(r, p[3], &value, &count, &range)) {
           token_cache[scan[c]] = 5;
-          if (read_bool(r, p[5], &value, &count, &range)) {
-            if (read_bool(r, p[7], &value, &count, &range)) {
+          if (read_token_bool(r, p[5], &value, &count, &range)) {
+            if (read_token_bool(r, p[7], &value, &count, &range)) {
               val = CAT6_MIN_VAL +
                     read_coeff(r, cat6_prob, cat6_bits, &value, &count, &range);
             } else {
               val = CAT5_MIN_VAL +
                     read_coeff(r, vp9_cat5_prob, 5, &value, &count, &range);
             }
-          } else if (read_bool(r, p[6], &value, &count, &range)) {
+          } else if (read_token_bool(r, p[6], &value, &count, &range)) {
             val = CAT4_MIN_VAL +
                   read_coeff(r, vp9_cat4_prob, 4, &value, &count, &range);
           } else {
@@ -205,7 +232,7 @@ static int decode_coefs(const MACROBLOCKD *xd, PLANE_TYPE type,
           }
         } else {
           token_cache[scan[c]] = 4;
-          if (read_bool(r, p[4], &value, &count, &range)) {
+          if (read_token_bool(r, p[4], &value, &count, &range)) {
             val = CAT2_MIN_VAL +
                   read_coeff(r, vp9_cat2_prob, 2, &value, &count, &range);
           } else {
@@ -220,9 +247,9 @@ static int decode_coefs(const MACROBLOCKD *xd, PLANE_TYPE type,
         v = (val * dqv) >> dq_shift;
 #endif
       } else {
-        if (read_bool(r, p[1], &value, &count, &range)) {
+        if (read_token_bool(r, p[1], &value, &count, &range)) {
           token_cache[scan[c]] = 3;
-          v = ((3 + read_bool(r, p[2], &value, &count, &range)) * dqv) >>
+          v = ((3 + read_token_bool(r, p[2], &value, &count, &range)) * dqv) >>
               dq_shift;
         } else {
           token_cache[scan[c]] = 2;
@@ -0,0 +1,132 @@
+/*
+ *  Copyright (c) 2014 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "./vpx_config.h"
+#include "vp9/common/vp9_onyxc_int.h"
+#include "vp9/decoder/vp9_decoder.h"
+#include "vp9/decoder/vp9_dthread.h"
+
+void vp9_frameworker_wait(BufferPool *const pool, RefCntBuffer *const ref_buf,
+                          int row) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(&pool->pool_mutex);
+  while (ref_buf->row < row)
+    pthread_cond_wait(&pool->pool_cond, &pool->pool_mutex);
+  pthread_mutex_unlock(&pool->pool_mutex);
+#else
+  (void)pool;
+  (void)ref_buf;
+  (void)row;
+  // Frame workers run synchronously, so references are always complete.
+  assert(ref_buf->row >= row);
+#endif
+}
+
+void vp9_frameworker_broadcast(BufferPool *const pool, RefCntBuffer *const buf,
+                               int row) {
+  lock_buffer_pool(pool);
+  if (row > buf->row) {
+    buf->row = row;
+#if CONFIG_MULTITHREAD
+    pthread_cond_broadcast(&pool->pool_cond);
+#endif
+  }
+  unlock_buffer_pool(pool);
+}
+
+void vp9_frameworker_signal_context_ready(VP9Decoder *const pbi) {
+  BufferPool *const pool = pbi->common.buffer_pool;
+  lock_buffer_pool(pool);
+  if (!pbi->frame_context_ready) {
+    pbi->frame_context_ready = 1;
+#if CONFIG_MULTITHREAD
+    pthread_cond_broadcast(&pool->pool_cond);
+#endif
+  }
+  unlock_buffer_pool(pool);
+}
+
+void vp9_frameworker_copy_context(VP9Decoder *const dst,
+                                  VP9Decoder *const src) {
+  VP9_COMMON *const dst_cm = &dst->common;
+  VP9_COMMON *const src_cm = &src->common;
+  BufferPool *const pool = dst_cm->buffer_pool;
+  // A frame shown with show_existing_frame leaves the decoder state untouched,
+  // so the state it received from its own predecessor is passed on unchanged.
+  const int show_existing = src_cm->show_existing_frame;
+
+  lock_buffer_pool(pool);
+#if CONFIG_MULTITHREAD
+  while (!src->frame_context_ready)
+    pthread_cond_wait(&pool->pool_cond, &pool->pool_mutex);
+#else
+  assert(src->frame_context_ready);
+#endif
+
+  // Hold the previous frame while its motion vectors may be referenced. The
+  // hold is released once 'dst' has finished decoding.
+  assert(!dst->hold_prev_frame_buf);
+  dst_cm->prev_frame = show_existing ? src_cm->prev_frame : src_cm->cur_frame;
+  if (dst_cm->prev_frame != NULL) {
+    ++dst_cm->prev_frame->ref_count;
+    dst->hold_prev_frame_buf = 1;
+  }
+  unlock_buffer_pool(pool);
+
+  dst_cm->last_show_frame =
+      show_existing ? src_cm->last_show_frame : src_cm->show_frame;
+  dst_cm->last_width = show_existing ? src_cm->last_width : src_cm->width;
+  dst_cm->last_height = show_existing ? src_cm->last_height : src_cm->height;
+  dst_cm->current_video_frame =
+      src_cm->current_video_frame + src_cm->show_frame;
+  // show_existing_frame returns before the header applies fp_last_seg_map.
+  dst->fp_last_seg_map = (show_existing && src->fp_last_seg_map != NULL)
+                             ? src->fp_last_seg_map
+                             : src_cm->last_frame_seg_map;
+  // The decoder's own map is already in place and may be reallocated by a size
+  // change, so it must not be referenced here.
+  if (dst->fp_last_seg_map == dst_cm->last_frame_seg_map)
+    dst->fp_last_seg_map = NULL;
+
+  // A failed frame leaves its own reference map stale, so this is needed even
+  // when 'dst' continues from its own previous frame.
+  memcpy(dst_cm->ref_frame_map, src_cm->next_ref_frame_map,
+         sizeof(src_cm->ref_frame_map));
+
+  if (dst == src) return;
+
+  dst->need_resync = src->need_resync;
+
+  dst_cm->frame_type = src_cm->frame_type;
+  dst_cm->intra_only = src_cm->intra_only;
+  dst_cm->bit_depth = src_cm->bit_depth;
+#if CONFIG_VP9_HIGHBITDEPTH
+  dst_cm->use_highbitdepth = src_cm->use_highbitdepth;
+#endif
+  dst_cm->subsampling_x = src_cm->subsampling_x;
+  dst_cm->subsampling_y = src_cm->subsampling_y;
+  dst_cm->color_space = src_cm->color_space;
+  dst_cm->color_range = src_cm->color_range;
+
+  memcpy(dst_cm->lf.ref_deltas, src_cm->lf.ref_deltas,
+         sizeof(src_cm->lf.ref_deltas));
+  memcpy(dst_cm->lf.mode_deltas, src_cm->lf.mode_deltas,
+         sizeof(src_cm->lf.mode_deltas));
+  memcpy(dst_cm->lf.last_ref_deltas, src_cm->lf.last_ref_deltas,
+         sizeof(src_cm->lf.last_ref_deltas));
+  memcpy(dst_cm->lf.last_mode_deltas, src_cm->lf.last_mode_deltas,
+         sizeof(src_cm->lf.last_mode_deltas));
+  dst_cm->seg = src_cm->seg;
+  memcpy(dst_cm->frame_contexts, src_cm->frame_contexts,
+         FRAME_CONTEXTS * sizeof(src_cm->frame_contexts[0]));
+}
@@ -0,0 +1,73 @@
+/*
+ *  Copyright (c) 2014 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef VPX_VP9_DECODER_VP9_DTHREAD_H_
+#define VPX_VP9_DECODER_VP9_DTHREAD_H_
+
+#include "./vpx_config.h"
+#include "vp9/common/vp9_onyxc_int.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct VP9Decoder;
+
+// Upper bound on the number of frames decoded concurrently in frame-based
+// multi-threaded mode.
+#define MAX_FRAME_WORKERS 8
+
+// WorkerData for the frame-based multi-threaded decoder. Each frame worker owns
+// a complete VP9Decoder instance; all of them share one BufferPool.
+typedef struct FrameWorkerData {
+  struct VP9Decoder *pbi;
+  const uint8_t *data;
+  const uint8_t *data_end;
+  size_t data_size;
+  void *user_priv;
+  int result;
+
+  // The compressed data is copied here so that it outlives the decode call
+  // that submitted it.
+  uint8_t *scratch_buffer;
+  size_t scratch_buffer_size;
+
+  // Set if this is the last frame of its compressed chunk. As in serial
+  // decoding, only the last frame of a chunk may be output.
+  int last_in_chunk;
+
+  // Index of the frame buffer that holds this worker's displayable output, or
+  // -1 if there is none. A reference is held on the buffer until the frame has
+  // been output.
+  int output_fb_idx;
+} FrameWorkerData;
+
+// Blocks until the first 'row' luma rows of 'ref_buf' have been decoded;
+// INT_MAX waits for the whole frame.
+void vp9_frameworker_wait(BufferPool *const pool, RefCntBuffer *const ref_buf,
+                          int row);
+
+// Publishes that the first 'row' luma rows of 'buf' are final.
+void vp9_frameworker_broadcast(BufferPool *const pool, RefCntBuffer *const buf,
+                               int row);
+
+// Marks the state required to start the next frame as available.
+void vp9_frameworker_signal_context_ready(struct VP9Decoder *const pbi);
+
+// Waits for 'src' to finish its frame header and copies the inter-frame state
+// the next frame depends on into 'dst'.
+void vp9_frameworker_copy_context(struct VP9Decoder *const dst,
+                                  struct VP9Decoder *const src);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // VPX_VP9_DECODER_VP9_DTHREAD_H_
@@ -12,114 +12,250 @@
 #include <string.h>
 
 #include "vpx/vpx_integer.h"
+#include "vpx_dsp/vpx_dsp_common.h"
+#include "vpx_ports/mem.h"
+#include "vpx_ports/vpx_timer.h"
 #include "vpx_util/vpx_pthread.h"
 
 #include "vp9/decoder/vp9_job_queue.h"
 
+// Stored in front of each job.
+typedef struct {
+  // Set once the job has been written.
+  jobq_atomic_int ready;
+  // Time the job spent in the queue, valid once it has been dequeued.
+  int64_t wait_us;
+  struct vpx_usec_timer timer;
+} JobSlotHeader;
+
+#if CONFIG_MULTITHREAD
+static INLINE int jobq_load(const jobq_atomic_int *atomic) {
+  return vpx_atomic_load_acquire(atomic);
+}
+
+static INLINE void jobq_store(jobq_atomic_int *atomic, int value) {
+  vpx_atomic_store_release(atomic, value);
+}
+
+static INLINE int jobq_fetch_add(jobq_atomic_int *atomic, int value) {
+  return vpx_atomic_fetch_add(atomic, value);
+}
+
+static INLINE int jobq_compare_exchange(jobq_atomic_int *atomic, int expected,
+                                        int desired) {
+  return vpx_atomic_compare_exchange(atomic, expected, desired);
+}
+#else
+static INLINE int jobq_load(const jobq_atomic_int *atomic) { return *atomic; }
+
+static INLINE void jobq_store(jobq_atomic_int *atomic, int value) {
+  *atomic = value;
+}
+
+static INLINE int jobq_fetch_add(jobq_atomic_int *atomic, int value) {
+  const int old_value = *atomic;
+  *atomic += value;
+  return old_value;
+}
+
+static INLINE int jobq_compare_exchange(jobq_atomic_int *atomic, int expected,
+                                        int desired) {
+  if (*atomic != expected) return 0;
+  *atomic = desired;
+  return 1;
+}
+#endif  // CONFIG_MULTITHREAD
+
+static size_t get_slot_size(size_t job_size) {
+  return ALIGN_POWER_OF_TWO(sizeof(JobSlotHeader) + job_size, 3);
+}
+
+static JobSlotHeader *get_slot(const JobQueueRowMt *jobq,
+                               const JobQueueClass *job_class, int idx) {
+  return (JobSlotHeader *)(job_class->buf_base + idx * jobq->slot_size);
+}
+
+size_t vp9_jobq_buf_size(size_t job_size, int num_classes,
+                         const int *class_size) {
+  size_t num_slots = 0;
+  int i;
+  for (i = 0; i < num_classes; ++i) num_slots += class_size[i];
+  return num_slots * get_slot_size(job_size);
+}
+
 void vp9_jobq_init(JobQueueRowMt *jobq, uint8_t *buf, size_t buf_size) {
 #if CONFIG_MULTITHREAD
   pthread_mutex_init(&jobq->mutex, NULL);
   pthread_cond_init(&jobq->cond, NULL);
 #endif
   jobq->buf_base = buf;
-  jobq->buf_wr = buf;
-  jobq->buf_rd = buf;
   jobq->buf_end = buf + buf_size;
-  jobq->terminate = 0;
+  jobq->slot_size = 0;
+  jobq->num_classes = 0;
+  jobq_store(&jobq->num_pending, 0);
+  jobq_store(&jobq->num_waiting, 0);
+  jobq_store(&jobq->terminate, 0);
 }
 
-void vp9_jobq_reset(JobQueueRowMt *jobq) {
-#if CONFIG_MULTITHREAD
-  pthread_mutex_lock(&jobq->mutex);
-#endif
-  jobq->buf_wr = jobq->buf_base;
-  jobq->buf_rd = jobq->buf_base;
-  jobq->terminate = 0;
-#if CONFIG_MULTITHREAD
-  pthread_mutex_unlock(&jobq->mutex);
-#endif
+void vp9_jobq_reset(JobQueueRowMt *jobq, size_t job_size, int num_classes,
+                    const int *class_size) {
+  uint8_t *buf = jobq->buf_base;
+  int i;
+
+  assert(num_classes <= JOBQ_MAX_CLASSES);
+  assert(vp9_jobq_buf_size(job_size, num_classes, class_size) <=
+         (size_t)(jobq->buf_end - jobq->buf_base));
+
+  // Clear the slots used since the last reset.
+  for (i = 0; i < jobq->num_classes; ++i) {
+    JobQueueClass *const job_class = &jobq->job_class[i];
+    const int num_used =
+        VPXMIN(jobq_load(&job_class->wr_idx), job_class->num_slots);
+    memset(job_class->buf_base, 0, num_used * jobq->slot_size);
+  }
+
+  jobq->slot_size = get_slot_size(job_size);
+  jobq->num_classes = num_classes;
+  for (i = 0; i < num_classes; ++i) {
+    JobQueueClass *const job_class = &jobq->job_class[i];
+    job_class->buf_base = buf;
+    job_class->num_slots = class_size[i];
+    jobq_store(&job_class->wr_idx, 0);
+    jobq_store(&job_class->rd_idx, 0);
+    buf += class_size[i] * jobq->slot_size;
+  }
+  jobq_store(&jobq->num_pending, 0);
+  jobq_store(&jobq->num_waiting, 0);
+  jobq_store(&jobq->terminate, 0);
 }
 
 void vp9_jobq_deinit(JobQueueRowMt *jobq) {
-  vp9_jobq_reset(jobq);
 #if CONFIG_MULTITHREAD
   pthread_mutex_destroy(&jobq->mutex);
   pthread_cond_destroy(&jobq->cond);
 #endif
+  jobq->num_classes = 0;
 }
 
 void vp9_jobq_terminate(JobQueueRowMt *jobq) {
 #if CONFIG_MULTITHREAD
   pthread_mutex_lock(&jobq->mutex);
 #endif
-  jobq->terminate = 1;
+  jobq_store(&jobq->terminate, 1);
 #if CONFIG_MULTITHREAD
   pthread_cond_broadcast(&jobq->cond);
   pthread_mutex_unlock(&jobq->mutex);
 #endif
 }
 
-int vp9_jobq_queue(JobQueueRowMt *jobq, void *job, size_t job_size) {
-  int ret = 0;
-#if CONFIG_MULTITHREAD
-  pthread_mutex_lock(&jobq->mutex);
-#endif
-  if (jobq->buf_end >= jobq->buf_wr + job_size) {
-    memcpy(jobq->buf_wr, job, job_size);
-    jobq->buf_wr = jobq->buf_wr + job_size;
-#if CONFIG_MULTITHREAD
-    pthread_cond_signal(&jobq->cond);
-#endif
-    ret = 0;
-  } else {
+int vp9_jobq_queue(JobQueueRowMt *jobq, int job_class, void *job,
+                   size_t job_size) {
+  JobQueueClass *const queue = &jobq->job_class[job_class];
+  JobSlotHeader *slot;
+  int idx;
+
+  assert(job_class < jobq->num_classes);
+  assert(get_slot_size(job_size) == jobq->slot_size);
+  (void)job_size;
+
+  idx = jobq_fetch_add(&queue->wr_idx, 1);
+  if (idx >= queue->num_slots) {
     /* Wrap around case is not supported */
     assert(0);
-    ret = 1;
+    return 1;
   }
+
+  slot = get_slot(jobq, queue, idx);
+  memcpy(slot + 1, job, job_size);
+  vpx_usec_timer_start(&slot->timer);
+  jobq_store(&slot->ready, 1);
+
+  // Pairs with the consumer incrementing num_waiting before it checks
+  // num_pending: either the consumer sees this job or it is woken up here.
+  jobq_fetch_add(&jobq->num_pending, 1);
+  if (jobq_fetch_add(&jobq->num_waiting, 0) > 0) {
 #if CONFIG_MULTITHREAD
-  pthread_mutex_unlock(&jobq->mutex);
+    pthread_mutex_lock(&jobq->mutex);
+    pthread_cond_signal(&jobq->cond);
+    pthread_mutex_unlock(&jobq->mutex);
 #endif
-  return ret;
+  }
+  return 0;
+}
+
+// Takes the oldest job of the given class if one is ready.
+static int dequeue_class(JobQueueRowMt *jobq, JobQueueClass *queue, void *job,
+                         size_t job_size) {
+  for (;;) {
+    const int idx = jobq_load(&queue->rd_idx);
+    JobSlotHeader *slot;
+    if (idx >= VPXMIN(jobq_load(&queue->wr_idx), queue->num_slots)) return 0;
+
+    // The slot is reserved but its producer has not finished writing it.
+    slot = get_slot(jobq, queue, idx);
+    if (!jobq_load(&slot->ready)) return 0;
+
+    if (jobq_compare_exchange(&queue->rd_idx, idx, idx + 1)) {
+      memcpy(job, slot + 1, job_size);
+      vpx_usec_timer_mark(&slot->timer);
+      slot->wait_us = vpx_usec_timer_elapsed(&slot->timer);
+      jobq_fetch_add(&jobq->num_pending, -1);
+      return 1;
+    }
+  }
 }
 
 int vp9_jobq_dequeue(JobQueueRowMt *jobq, void *job, size_t job_size,
                      int blocking) {
-  int ret = 0;
-#if CONFIG_MULTITHREAD
-  pthread_mutex_lock(&jobq->mutex);
-#endif
-  if (jobq->buf_end >= jobq->buf_rd + job_size) {
-    while (1) {
-      if (jobq->buf_wr >= jobq->buf_rd + job_size) {
-        memcpy(job, jobq->buf_rd, job_size);
-        jobq->buf_rd = jobq->buf_rd + job_size;
-        ret = 0;
-        break;
-      } else {
-        /* If all the entries have been dequeued, then break and return */
-        if (jobq->terminate == 1) {
-          ret = 1;
-          break;
-        }
-        if (blocking == 1) {
-#if CONFIG_MULTITHREAD
-          pthread_cond_wait(&jobq->cond, &jobq->mutex);
-#endif
-        } else {
-          /* If there is no job available,
-           * and this is non blocking call then return fail */
-          ret = 1;
-          break;
-        }
-      }
+  assert(get_slot_size(job_size) == jobq->slot_size);
+
+  for (;;) {
+    int i;
+    for (i = 0; i < jobq->num_classes; ++i) {
+      if (dequeue_class(jobq, &jobq->job_class[i], job, job_size)) return 0;
     }
-  } else {
-    /* Wrap around case is not supported */
-    ret = 1;
-  }
+
+    // A job counted in num_pending is still being written or was taken by
+    // another consumer; look again.
+    if (jobq_fetch_add(&jobq->num_pending, 0) > 0) continue;
+
+    /* If all the entries have been dequeued, then break and return */
+    if (jobq_load(&jobq->terminate)) {
+      if (jobq_fetch_add(&jobq->num_pending, 0) > 0) continue;
+      return 1;
+    }
+
+    /* If there is no job available,
+     * and this is non blocking call then return fail */
+    if (!blocking) return 1;
+
 #if CONFIG_MULTITHREAD
-  pthread_mutex_unlock(&jobq->mutex);
+    pthread_mutex_lock(&jobq->mutex);
+    jobq_fetch_add(&jobq->num_waiting, 1);
+    while (jobq_fetch_add(&jobq->num_pending, 0) == 0 &&
+           !jobq_load(&jobq->terminate)) {
+      pthread_cond_wait(&jobq->cond, &jobq->mutex);
+    }
+    jobq_fetch_add(&jobq->num_waiting, -1);
+    pthread_mutex_unlock(&jobq->mutex);
+#else
+    // Jobs are only queued by the single thread.
+    return 1;
 #endif
+  }
+}
 
-  return ret;
+void vp9_jobq_get_wait_stats(const JobQueueRowMt *jobq, int job_class,
+                             int *num_jobs, int64_t *wait_us) {
+  *num_jobs = 0;
+  *wait_us = 0;
+  if (job_class < jobq->num_classes) {
+    const JobQueueClass *const queue = &jobq->job_class[job_class];
+    const int num_done = VPXMIN(jobq_load(&queue->rd_idx), queue->num_slots);
+    int i;
+    for (i = 0; i < num_done; ++i) {
+      *wait_us += get_slot(jobq, queue, i)->wait_us;
+    }
+    *num_jobs = num_done;
+  }
 }
@@ -11,22 +11,60 @@
 #ifndef VPX_VP9_DECODER_VP9_JOB_QUEUE_H_
 #define VPX_VP9_DECODER_VP9_JOB_QUEUE_H_
 
+#include "./vpx_config.h"
+#include "vpx/vpx_integer.h"
+#include "vpx_util/vpx_atomics.h"
 #include "vpx_util/vpx_pthread.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define JOBQ_MAX_CLASSES 4
+
+#if CONFIG_MULTITHREAD
+typedef vpx_atomic_int jobq_atomic_int;
+#else
+typedef int jobq_atomic_int;
+#endif
+
+// A FIFO of the jobs of one class. Slots are used once between resets, so the
+// queue does not wrap around.
 typedef struct {
-  // Pointer to buffer base which contains the jobs
+  // Pointer to the first slot
   uint8_t *buf_base;
+  int num_slots;
 
-  // Pointer to current address where new job can be added
-  uint8_t *volatile buf_wr;
+  // Index of the next slot to be filled by a producer
+  jobq_atomic_int wr_idx;
 
-  // Pointer to current address from where next job can be obtained
-  uint8_t *volatile buf_rd;
+  // Index of the next slot to be taken by a consumer
+  jobq_atomic_int rd_idx;
+} JobQueueClass;
+
+// Multi-producer, multi-consumer job queue. Jobs are queued and dequeued
+// without taking a lock. Each job belongs to a class and dequeue returns the
+// oldest job of the lowest numbered class that has one, so class 0 has the
+// highest priority. The mutex and condition variable are only used to put idle
+// consumers to sleep.
+typedef struct {
+  // Pointer to buffer base which contains the jobs
+  uint8_t *buf_base;
 
   // Pointer to end of job buffer
   uint8_t *buf_end;
 
-  int terminate;
+  size_t slot_size;
+  int num_classes;
+  JobQueueClass job_class[JOBQ_MAX_CLASSES];
+
+  // Number of jobs queued but not yet dequeued
+  jobq_atomic_int num_pending;
+
+  // Number of consumers waiting for a job
+  jobq_atomic_int num_waiting;
+
+  jobq_atomic_int terminate;
 
 #if CONFIG_MULTITHREAD
   pthread_mutex_t mutex;
@@ -34,12 +72,32 @@ typedef struct {
 #endif
 } JobQueueRowMt;
 
+// Returns the buffer size needed to hold class_size[i] jobs of job_size bytes
+// in each of the num_classes classes.
+size_t vp9_jobq_buf_size(size_t job_size, int num_classes,
+                         const int *class_size);
+
 void vp9_jobq_init(JobQueueRowMt *jobq, uint8_t *buf, size_t buf_size);
-void vp9_jobq_reset(JobQueueRowMt *jobq);
+
+// Empties the queue and splits its buffer between the job classes. Must not
+// be called while other threads access the queue.
+void vp9_jobq_reset(JobQueueRowMt *jobq, size_t job_size, int num_classes,
+                    const int *class_size);
 void vp9_jobq_deinit(JobQueueRowMt *jobq);
 void vp9_jobq_terminate(JobQueueRowMt *jobq);
-int vp9_jobq_queue(JobQueueRowMt *jobq, void *job, size_t job_size);
+int vp9_jobq_queue(JobQueueRowMt *jobq, int job_class, void *job,
+                   size_t job_size);
 int vp9_jobq_dequeue(JobQueueRowMt *jobq, void *job, size_t job_size,
                      int blocking);
 
+// Reports the number of jobs of a class dequeued since the last reset and
+// the total time in microseconds they spent queued. Must not be called while
+// other threads access the queue.
+void vp9_jobq_get_wait_stats(const JobQueueRowMt *jobq, int job_class,
+                             int *num_jobs, int64_t *wait_us);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
 #endif  // VPX_VP9_DECODER_VP9_JOB_QUEUE_H_
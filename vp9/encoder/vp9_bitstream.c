@@ -680,14 +680,15 @@ static void update_coef_probs_common(vpx_writer *const bc, VP9_COMP *cpi,
   }
 }
 
-static void update_coef_probs(VP9_COMP *cpi, vpx_writer *w) {
+static void update_coef_probs(VP9_COMP *cpi, vpx_writer *w,
+                              const FRAME_COUNTS *counts) {
   const TX_MODE tx_mode = cpi->common.tx_mode;
   const TX_SIZE max_tx_size = tx_mode_to_biggest_tx_size[tx_mode];
   TX_SIZE tx_size;
   for (tx_size = TX_4X4; tx_size <= max_tx_size; ++tx_size) {
     vp9_coeff_stats frame_branch_ct[PLANE_TYPES];
     vp9_coeff_probs_model frame_coef_probs[PLANE_TYPES];
-    if (cpi->td.counts->tx.tx_totals[tx_size] <= 20 ||
+    if (counts->tx.tx_totals[tx_size] <= 20 ||
         (tx_size >= TX_16X16 && cpi->sf.tx_size_search_method == USE_TX_8X8)) {
       vpx_write_bit(w, 0);
     } else {
@@ -973,6 +974,10 @@ void vp9_bitstream_encode_tiles_buffer_dealloc(VP9_COMP *const cpi) {
     vpx_free(cpi->vp9_bitstream_worker_data);
     cpi->vp9_bitstream_worker_data = NULL;
   }
+  vpx_free(cpi->packed_tiles_buf);
+  cpi->packed_tiles_buf = NULL;
+  cpi->packed_tiles_buf_size = 0;
+  cpi->pack_tiles_early = 0;
 }
 
 static size_t encode_tiles_buffer_alloc_size(const VP9_COMP *cpi) {
@@ -1001,9 +1006,75 @@ static void encode_tiles_buffer_alloc(VP9_COMP *const cpi,
   }
 }
 
+void vp9_bitstream_setup_packed_tiles(VP9_COMP *cpi) {
+  VP9_COMMON *const cm = &cpi->common;
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  const size_t buf_size = encode_tiles_buffer_alloc_size(cpi);
+  int tile_col;
+
+  cpi->pack_tiles_early = 0;
+#if !CONFIG_BITSTREAM_DEBUG
+  // Tiles in the same column would have to be packed in order, and the
+  // segmentation map probabilities and the segmentation itself may still
+  // change once the frame is encoded.
+  if (!cpi->oxcf.pipelined_packing || cpi->num_workers < 2 ||
+      cm->log2_tile_rows > 0 || cm->seg.enabled) {
+    return;
+  }
+
+  if (cpi->packed_tiles_buf_size != buf_size) {
+    vpx_free(cpi->packed_tiles_buf);
+    cpi->packed_tiles_buf_size = 0;
+    CHECK_MEM_ERROR(&cm->error, cpi->packed_tiles_buf, vpx_malloc(buf_size));
+    cpi->packed_tiles_buf_size = buf_size;
+  }
+
+  // Each tile gets the share of the buffer its width takes of the frame. A
+  // tile that does not fit is packed again by vp9_pack_bitstream().
+  for (tile_col = 0; tile_col < tile_cols; ++tile_col) {
+    const TileInfo *const tile = &cpi->tile_data[tile_col].tile_info;
+    VP9PackedTile *const packed = &cpi->packed_tiles[tile_col];
+    const size_t start =
+        (size_t)((uint64_t)buf_size * tile->mi_col_start / cm->mi_cols);
+    const size_t end =
+        (size_t)((uint64_t)buf_size * tile->mi_col_end / cm->mi_cols);
+    packed->dest = cpi->packed_tiles_buf + start;
+    packed->dest_size = end - start;
+    packed->size = 0;
+    vpx_atomic_init(&packed->rows_left,
+                    (tile->mi_row_end - tile->mi_row_start + MI_BLOCK_SIZE - 1) >>
+                        MI_BLOCK_SIZE_LOG2);
+  }
+  cpi->pack_tiles_early = 1;
+#endif  // !CONFIG_BITSTREAM_DEBUG
+}
+
+void vp9_bitstream_pack_tile(VP9_COMP *cpi, const MACROBLOCKD *xd,
+                             int tile_col) {
+  VP9_COMMON *const cm = &cpi->common;
+  const TileInfo *const tile = &cpi->tile_data[tile_col].tile_info;
+  VP9PackedTile *const packed = &cpi->packed_tiles[tile_col];
+  DECLARE_ALIGNED(16, MACROBLOCKD, tile_xd);
+  vpx_writer w;
+
+  assert(cpi->pack_tiles_early);
+  tile_xd = *xd;
+  // The other tiles are still encoded, so only the tile's columns are reset.
+  memset(cm->above_seg_context + tile->mi_col_start, 0,
+         sizeof(*cm->above_seg_context) *
+             (mi_cols_aligned_to_sb(tile->mi_col_end) - tile->mi_col_start));
+  packed->max_mv_magnitude = 0;
+  memset(packed->interp_filter_selected, 0,
+         sizeof(packed->interp_filter_selected));
+
+  vpx_start_encode(&w, packed->dest, packed->dest_size);
+  write_modes(cpi, &tile_xd, tile, &w, 0, tile_col, &packed->max_mv_magnitude,
+              packed->interp_filter_selected);
+  packed->size = vpx_stop_encode(&w) == 0 ? w.pos : 0;
+}
+
 static size_t encode_tiles_mt(VP9_COMP *cpi, uint8_t *data_ptr,
                               size_t data_size) {
-  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
   VP9_COMMON *const cm = &cpi->common;
   const int tile_cols = 1 << cm->log2_tile_cols;
   const int num_workers = cpi->num_workers;
@@ -1020,8 +1091,8 @@ static size_t encode_tiles_mt(VP9_COMP *cpi, uint8_t *data_ptr,
 
   while (tile_col < tile_cols) {
     int i, j;
+    vp9_task_group_init(&cpi->stage_tasks, NULL);
     for (i = 0; i < num_workers && tile_col < tile_cols; ++i) {
-      VPxWorker *const worker = &cpi->workers[i];
       VP9BitstreamWorkerData *const data = &cpi->vp9_bitstream_worker_data[i];
 
       // Populate the worker data.
@@ -1043,32 +1114,19 @@ static size_t encode_tiles_mt(VP9_COMP *cpi, uint8_t *data_ptr,
         data->dest = data_ptr + offset;
         data->dest_size = data_size - offset;
       }
-      worker->data1 = cpi;
-      worker->data2 = data;
-      worker->hook = encode_tile_worker;
-      worker->had_error = 0;
-
-      if (i < num_workers - 1) {
-        winterface->launch(worker);
-      } else {
-        winterface->execute(worker);
-      }
+      vp9_task_pool_add(&cpi->task_pool, &cpi->stage_tasks, encode_tile_worker,
+                        cpi, data);
       ++tile_col;
     }
+    if (!vp9_task_pool_wait(&cpi->task_pool, &cpi->stage_tasks)) {
+      vpx_internal_error(&cm->error, VPX_CODEC_ERROR,
+                         "encode_tiles_mt: output buffer full");
+    }
     for (j = 0; j < i; ++j) {
-      VPxWorker *const worker = &cpi->workers[j];
-      VP9BitstreamWorkerData *const data =
-          (VP9BitstreamWorkerData *)worker->data2;
-      uint32_t tile_size;
+      VP9BitstreamWorkerData *const data = &cpi->vp9_bitstream_worker_data[j];
+      const uint32_t tile_size = data->bit_writer.pos;
       int k;
 
-      if (!winterface->sync(worker)) {
-        error = 1;
-        continue;
-      }
-
-      tile_size = data->bit_writer.pos;
-
       // Aggregate per-thread bitstream stats.
       cpi->max_mv_magnitude =
           VPXMAX(cpi->max_mv_magnitude, data->max_mv_magnitude);
@@ -1118,13 +1176,15 @@ static size_t encode_tiles(VP9_COMP *cpi, uint8_t *data_ptr, size_t data_size) {
   // modes the speed up is insignificant and requires further testing to ensure
   // that it does not make the overall process worse in any case.
   if (cpi->oxcf.mode == REALTIME && cpi->num_workers > 1 && tile_rows == 1 &&
-      tile_cols > 1) {
+      tile_cols > 1 && !cpi->pack_tiles_early) {
     return encode_tiles_mt(cpi, data_ptr, data_size);
   }
 
   for (tile_row = 0; tile_row < tile_rows; tile_row++) {
     for (tile_col = 0; tile_col < tile_cols; tile_col++) {
       int tile_idx = tile_row * tile_cols + tile_col;
+      const VP9PackedTile *const packed = &cpi->packed_tiles[tile_idx];
+      size_t tile_size;
 
       size_t offset;
       if (tile_col < tile_cols - 1 || tile_row < tile_rows - 1)
@@ -1135,23 +1195,41 @@ static size_t encode_tiles(VP9_COMP *cpi, uint8_t *data_ptr, size_t data_size) {
         vpx_internal_error(&cm->error, VPX_CODEC_ERROR,
                            "encode_tiles: output buffer full");
       }
-      vpx_start_encode(&residual_bc, data_ptr + offset, data_size - offset);
 
-      write_modes(cpi, xd, &cpi->tile_data[tile_idx].tile_info, &residual_bc,
-                  tile_row, tile_col, &cpi->max_mv_magnitude,
-                  cpi->interp_filter_selected);
+      if (cpi->pack_tiles_early && packed->size > 0) {
+        int k;
+        if (data_size - offset < packed->size) {
+          vpx_internal_error(&cm->error, VPX_CODEC_ERROR,
+                             "encode_tiles: output buffer full");
+        }
+        memcpy(data_ptr + offset, packed->dest, packed->size);
+        tile_size = packed->size;
+        cpi->max_mv_magnitude =
+            VPXMAX(cpi->max_mv_magnitude, packed->max_mv_magnitude);
+        for (k = 0; k < SWITCHABLE; ++k) {
+          cpi->interp_filter_selected[0][k] +=
+              packed->interp_filter_selected[0][k];
+        }
+      } else {
+        vpx_start_encode(&residual_bc, data_ptr + offset, data_size - offset);
 
-      if (vpx_stop_encode(&residual_bc)) {
-        vpx_internal_error(&cm->error, VPX_CODEC_ERROR,
-                           "encode_tiles: output buffer full");
+        write_modes(cpi, xd, &cpi->tile_data[tile_idx].tile_info, &residual_bc,
+                    tile_row, tile_col, &cpi->max_mv_magnitude,
+                    cpi->interp_filter_selected);
+
+        if (vpx_stop_encode(&residual_bc)) {
+          vpx_internal_error(&cm->error, VPX_CODEC_ERROR,
+                             "encode_tiles: output buffer full");
+        }
+        tile_size = residual_bc.pos;
       }
       if (tile_col < tile_cols - 1 || tile_row < tile_rows - 1) {
         // size of this tile
-        mem_put_be32(data_ptr + total_size, residual_bc.pos);
+        mem_put_be32(data_ptr + total_size, (unsigned int)tile_size);
         total_size += 4;
       }
 
-      total_size += residual_bc.pos;
+      total_size += tile_size;
     }
   }
   return total_size;
@@ -1307,7 +1385,8 @@ static void write_uncompressed_header(VP9_COMP *cpi,
 
       vpx_wb_write_bit(wb, cm->allow_high_precision_mv);
 
-      fix_interp_filter(cm, cpi->td.counts);
+      // The tiles may already be packed with the frame's filter.
+      if (!cpi->oxcf.pipelined_packing) fix_interp_filter(cm, cpi->td.counts);
       write_interp_filter(cm->interp_filter, wb);
     }
   }
@@ -1332,8 +1411,17 @@ static size_t write_compressed_header(VP9_COMP *cpi, uint8_t *data,
   MACROBLOCKD *const xd = &cpi->td.mb.e_mbd;
   FRAME_CONTEXT *const fc = cm->fc;
   FRAME_COUNTS *counts = cpi->td.counts;
+  FRAME_COUNTS no_counts;
   vpx_writer header_bc;
 
+  // The tiles may be packed before the frame counts are known, so the
+  // probabilities are left as the frame started with. Without counts no
+  // update is worth its cost.
+  if (cpi->oxcf.pipelined_packing) {
+    vp9_zero(no_counts);
+    counts = &no_counts;
+  }
+
   vpx_start_encode(&header_bc, data, data_size);
 
   if (xd->lossless)
@@ -1341,7 +1429,7 @@ static size_t write_compressed_header(VP9_COMP *cpi, uint8_t *data,
   else
     encode_txfm_probs(cm, &header_bc, counts);
 
-  update_coef_probs(cpi, &header_bc);
+  update_coef_probs(cpi, &header_bc, counts);
   update_skip_probs(cm, &header_bc, counts);
 
   if (!frame_is_intra_only(cm)) {
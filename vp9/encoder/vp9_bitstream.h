@@ -35,6 +35,16 @@ int vp9_get_refresh_mask(VP9_COMP *cpi);
 
 void vp9_bitstream_encode_tiles_buffer_dealloc(VP9_COMP *const cpi);
 
+// Called once the tiles of a frame are set up for encoding with more than one
+// worker. Sets cpi->pack_tiles_early if each tile is to be packed by
+// vp9_bitstream_pack_tile() as soon as it is encoded.
+void vp9_bitstream_setup_packed_tiles(VP9_COMP *cpi);
+
+// Packs an encoded tile of the first tile row. 'xd' is the encoding thread's,
+// and is copied.
+void vp9_bitstream_pack_tile(VP9_COMP *cpi, const MACROBLOCKD *xd,
+                             int tile_col);
+
 void vp9_pack_bitstream(VP9_COMP *cpi, uint8_t *dest, size_t dest_size,
                         size_t *size);
 
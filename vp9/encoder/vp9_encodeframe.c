@@ -6190,6 +6190,8 @@ static void encode_frame_internal(VP9_COMP *cpi) {
     struct vpx_usec_timer emr_timer;
     vpx_usec_timer_start(&emr_timer);
 
+    // Set again by the multi-threaded paths if they pack the tiles.
+    cpi->pack_tiles_early = 0;
     if (!cpi->row_mt) {
       cpi->row_mt_sync_read_ptr = vp9_row_mt_sync_read_dummy;
       cpi->row_mt_sync_write_ptr = vp9_row_mt_sync_write_dummy;
@@ -6352,7 +6354,10 @@ void vp9_encode_frame(VP9_COMP *cpi) {
     for (i = 0; i < SWITCHABLE_FILTER_CONTEXTS; ++i)
       filter_thrs[i] = (filter_thrs[i] + rdc->filter_diff[i] / cm->MBs) / 2;
 
-    if (cm->reference_mode == REFERENCE_MODE_SELECT) {
+    // With pipelined packing the tiles may already be packed with the modes
+    // the frame was encoded with.
+    if (cm->reference_mode == REFERENCE_MODE_SELECT &&
+        !cpi->oxcf.pipelined_packing) {
       int single_count_zero = 0;
       int comp_count_zero = 0;
 
@@ -6370,7 +6375,7 @@ void vp9_encode_frame(VP9_COMP *cpi) {
       }
     }
 
-    if (cm->tx_mode == TX_MODE_SELECT) {
+    if (cm->tx_mode == TX_MODE_SELECT && !cpi->oxcf.pipelined_packing) {
       int count4x4 = 0;
       int count8x8_lp = 0, count8x8_8x8p = 0;
       int count16x16_16x16p = 0, count16x16_lp = 0;
@@ -6414,7 +6419,8 @@ void vp9_encode_frame(VP9_COMP *cpi) {
 
     encode_frame_internal(cpi);
 
-    if (cm->reference_mode == REFERENCE_MODE_SELECT) {
+    if (cm->reference_mode == REFERENCE_MODE_SELECT &&
+        !cpi->oxcf.pipelined_packing) {
       int single_count_zero = 0;
       int comp_count_zero = 0;
       int i;
@@ -14,6 +14,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+struct VP9_COMP;
+static void install_wrappers(struct VP9_COMP *cpi);
 
 #include "./vp9_rtcd.h"
 #include "./vpx_config.h"
@@ -1027,6 +1029,9 @@ static void dealloc_compressor_data(VP9_COMP *cpi) {
   vpx_free(cpi->mi_ssim_rdmult_scaling_factors);
   cpi->mi_ssim_rdmult_scaling_factors = NULL;
 
+  vpx_free(cpi->twopass.fp_mb_mvs);
+  cpi->twopass.fp_mb_mvs = NULL;
+
 #if CONFIG_RATE_CTRL
   if (cpi->oxcf.use_simple_encode_api) {
     free_partition_info(cpi);
@@ -1046,6 +1051,7 @@ static void dealloc_compressor_data(VP9_COMP *cpi) {
   vpx_free_frame_buffer(&cpi->scaled_source);
   vpx_free_frame_buffer(&cpi->scaled_last_source);
   vpx_free_frame_buffer(&cpi->tf_buffer);
+  vpx_free_frame_buffer(&cpi->arnr_next.buffer);
 #ifdef ENABLE_KF_DENOISE
   vpx_free_frame_buffer(&cpi->raw_unscaled_source);
   vpx_free_frame_buffer(&cpi->raw_scaled_source);
@@ -2074,6 +2080,11 @@ void vp9_change_config(struct VP9_COMP *cpi, const VP9EncoderConfig *oxcf) {
   int last_w = cpi->oxcf.width;
   int last_h = cpi->oxcf.height;
 
+#if !CONFIG_REALTIME_ONLY
+  // The ARF filtered ahead depends on the configuration.
+  vp9_temporal_filter_cancel_next(cpi);
+#endif
+
   vp9_init_quantizer(cpi);
   if (cm->profile != oxcf->profile) cm->profile = oxcf->profile;
   cm->bit_depth = oxcf->bit_depth;
@@ -2212,6 +2223,7 @@ void vp9_change_config(struct VP9_COMP *cpi, const VP9EncoderConfig *oxcf) {
 #endif
 
   vp9_set_row_mt(cpi);
+  if (getenv("SADPX")) install_wrappers(cpi);
 }
 
 /***********************************************************************
@@ -2632,6 +2644,17 @@ VP9_COMP *vp9_create_compressor(const VP9EncoderConfig *oxcf,
       fps_init_first_pass_info(&cpi->twopass.first_pass_info,
                                oxcf->two_pass_stats_in.buf, num_frames);
 
+      if (oxcf->firstpass_mb_stats_in.buf != NULL) {
+        TWO_PASS *const twopass = &cpi->twopass;
+        twopass->mb_mvs_in_rows = (oxcf->height + 15) >> 4;
+        twopass->mb_mvs_in_cols = (oxcf->width + 15) >> 4;
+        twopass->mb_mvs_in = oxcf->firstpass_mb_stats_in.buf;
+        twopass->mb_mvs_in_frames =
+            (int)(oxcf->firstpass_mb_stats_in.sz /
+                  (twopass->mb_mvs_in_rows * twopass->mb_mvs_in_cols *
+                   sizeof(*twopass->mb_mvs_in)));
+      }
+
       vp9_init_second_pass(cpi);
     }
   }
@@ -2776,6 +2799,36 @@ VP9_COMP *vp9_create_compressor(const VP9EncoderConfig *oxcf,
   snprintf((H) + strlen(H), sizeof(H) - strlen(H), (T), (V))
 #endif  // CONFIG_INTERNAL_STATS
 
+
+static vpx_sad_fn_t g_sdf[BLOCK_SIZES];
+static vpx_sad_multi_d_fn_t g_sdx4[BLOCK_SIZES];
+static vpx_sad_fn_t g_sdsf[BLOCK_SIZES];
+static vpx_sad_multi_d_fn_t g_sdsx4[BLOCK_SIZES];
+static double g_sad_px, g_sad_tpl;
+static int g_in_tpl;
+static void print_sad_px(void) { fprintf(stderr, "SADPX %.0f TPL %.0f\n", g_sad_px, g_sad_tpl); }
+#define ACC (*(g_in_tpl ? &g_sad_tpl : &g_sad_px))
+#define WRAP(b) \
+  static unsigned int wsdf##b(const uint8_t *a, int as, const uint8_t *r, int rs) { ACC += (1 << num_pels_log2_lookup[b]); return g_sdf[b](a, as, r, rs); } \
+  static void wsdx4##b(const uint8_t *a, int as, const uint8_t *const r[4], int rs, uint32_t *res) { ACC += 4 * (1 << num_pels_log2_lookup[b]); g_sdx4[b](a, as, r, rs, res); } \
+  static unsigned int wsdsf##b(const uint8_t *a, int as, const uint8_t *r, int rs) { ACC += (1 << num_pels_log2_lookup[b]) / 2; return g_sdsf[b](a, as, r, rs); } \
+  static void wsdsx4##b(const uint8_t *a, int as, const uint8_t *const r[4], int rs, uint32_t *res) { ACC += 2 * (1 << num_pels_log2_lookup[b]); g_sdsx4[b](a, as, r, rs, res); }
+WRAP(0) WRAP(1) WRAP(2) WRAP(3) WRAP(4) WRAP(5) WRAP(6) WRAP(7) WRAP(8) WRAP(9) WRAP(10) WRAP(11) WRAP(12)
+#define L(n) { n##0, n##1, n##2, n##3, n##4, n##5, n##6, n##7, n##8, n##9, n##10, n##11, n##12 }
+static void install_wrappers(VP9_COMP *cpi) {
+  static const vpx_sad_fn_t w1[] = L(wsdf), ws1[] = L(wsdsf);
+  static const vpx_sad_multi_d_fn_t w4[] = L(wsdx4), ws4[] = L(wsdsx4);
+  int b;
+  static int reg = 0;
+  if (!reg) { atexit(print_sad_px); reg = 1; }
+  if (cpi->fn_ptr[0].sdf == w1[0]) return;
+  for (b = 0; b < BLOCK_SIZES; ++b) {
+    g_sdf[b] = cpi->fn_ptr[b].sdf; cpi->fn_ptr[b].sdf = w1[b];
+    g_sdx4[b] = cpi->fn_ptr[b].sdx4df; cpi->fn_ptr[b].sdx4df = w4[b];
+    g_sdsf[b] = cpi->fn_ptr[b].sdsf; cpi->fn_ptr[b].sdsf = ws1[b];
+    g_sdsx4[b] = cpi->fn_ptr[b].sdsx4df; cpi->fn_ptr[b].sdsx4df = ws4[b];
+  }
+}
 void vp9_remove_compressor(VP9_COMP *cpi) {
   VP9_COMMON *cm;
   unsigned int i;
@@ -2891,6 +2944,8 @@ void vp9_remove_compressor(VP9_COMP *cpi) {
 
   vp9_free_tpl_buffer(cpi);
 
+  // Wait for the loop filter tasks left by a frame that failed to encode.
+  vp9_task_pool_wait(&cpi->task_pool, &cpi->lf_border_task);
   vp9_loop_filter_dealloc(&cpi->lf_row_sync);
   vp9_bitstream_encode_tiles_buffer_dealloc(cpi);
   vp9_row_mt_mem_dealloc(cpi);
@@ -3424,6 +3479,12 @@ void vp9_update_reference_frames(VP9_COMP *cpi) {
   if (is_one_pass_svc(cpi)) vp9_svc_update_ref_frame(cpi);
 }
 
+static int extend_inner_borders_task(void *arg1, void *unused) {
+  (void)unused;
+  vpx_extend_frame_inner_borders((YV12_BUFFER_CONFIG *)arg1);
+  return 1;
+}
+
 static void loopfilter_frame(VP9_COMP *cpi, VP9_COMMON *cm) {
   MACROBLOCKD *xd = &cpi->td.mb.e_mbd;
   struct loopfilter *lf = &cm->lf;
@@ -3475,12 +3536,19 @@ static void loopfilter_frame(VP9_COMP *cpi, VP9_COMMON *cm) {
   if (lf->filter_level > 0 && is_reference_frame) {
     vp9_build_mask_frame(cm, lf->filter_level, 0);
 
-    if (cpi->num_workers > 1)
-      vp9_loop_filter_frame_mt(cm->frame_to_show, cm, xd->plane,
-                               lf->filter_level, 0, 0, cpi->workers,
-                               cpi->num_workers, &cpi->lf_row_sync);
-    else
-      vp9_loop_filter_frame(cm->frame_to_show, cm, xd, lf->filter_level, 0, 0);
+    if (cpi->num_workers > 1) {
+      // The frame is filtered and its borders are extended while the
+      // bitstream is packed, which does not read it. It is waited for in
+      // encode_frame_to_data_rate().
+      vp9_task_group_init(&cpi->lf_tasks, NULL);
+      vp9_loop_filter_frame_tasks(cpi, cm->frame_to_show, lf->filter_level, 0,
+                                  0, &cpi->lf_tasks);
+      vp9_task_group_init(&cpi->lf_border_task, &cpi->lf_tasks);
+      vp9_task_pool_add(&cpi->task_pool, &cpi->lf_border_task,
+                        extend_inner_borders_task, cm->frame_to_show, NULL);
+      return;
+    }
+    vp9_loop_filter_frame(cm->frame_to_show, cm, xd, lf->filter_level, 0, 0);
   }
 
   vpx_extend_frame_inner_borders(cm->frame_to_show);
@@ -5549,6 +5617,29 @@ static void update_encode_frame_result_simple_encode(
 #endif  // CONFIG_RATE_CTRL
 #endif  // !CONFIG_REALTIME_ONLY
 
+#if !CONFIG_REALTIME_ONLY
+// Starts filtering the source of the next frame if it is an ARF, so that the
+// encoder threads filter it while this frame is loop filtered and packed.
+// Everything the filter depends on is final once the frame is coded, except
+// for the rate control state updated afterwards, which
+// vp9_temporal_filter() checks.
+static void start_next_arf_filter(VP9_COMP *cpi) {
+  const VP9EncoderConfig *const oxcf = &cpi->oxcf;
+  const GF_GROUP *const gf_group = &cpi->twopass.gf_group;
+  const int next_index = gf_group->index + 1;
+
+  if (oxcf->pass != 2 || oxcf->mode == REALTIME || cpi->use_svc ||
+      !is_altref_enabled(cpi) || oxcf->arnr_max_frames <= 0 ||
+      oxcf->arnr_strength <= 0 || cpi->num_workers < 2 ||
+      cpi->common.show_existing_frame || next_index >= gf_group->gf_group_size ||
+      gf_group->update_type[next_index] != ARF_UPDATE) {
+    return;
+  }
+  vp9_temporal_filter_start_next(cpi, gf_group->arf_src_offset[next_index],
+                                 ALTREF_HIGH_PRECISION_MV);
+}
+#endif  // !CONFIG_REALTIME_ONLY
+
 static void encode_frame_to_data_rate(
     VP9_COMP *cpi, size_t *size, uint8_t *dest, size_t dest_size,
     unsigned int *frame_flags, ENCODE_FRAME_RESULT *encode_frame_result) {
@@ -5732,6 +5823,10 @@ static void encode_frame_to_data_rate(
   cm->frame_to_show->render_width = cm->render_width;
   cm->frame_to_show->render_height = cm->render_height;
 
+#if !CONFIG_REALTIME_ONLY
+  start_next_arf_filter(cpi);
+#endif
+
 #if CONFIG_COLLECT_COMPONENT_TIMING
   start_timing(cpi, loopfilter_frame_time);
 #endif
@@ -5752,6 +5847,8 @@ static void encode_frame_to_data_rate(
   end_timing(cpi, vp9_pack_bitstream_time);
 #endif
 
+  vp9_task_pool_wait(&cpi->task_pool, &cpi->lf_border_task);
+
   if (cpi->ext_ratectrl.ready &&
       cpi->ext_ratectrl.funcs.update_encodeframe_result != NULL) {
     vpx_codec_err_t codec_status = vp9_extrc_update_encodeframe_result(
@@ -6427,6 +6524,13 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
 
   vpx_usec_timer_start(&cmptimer);
 
+  // The loop filter of the last frame is still running if packing its
+  // bitstream failed.
+  vp9_task_pool_wait(&cpi->task_pool, &cpi->lf_border_task);
+#if !CONFIG_REALTIME_ONLY
+  vp9_temporal_filter_wait_next(cpi);
+#endif
+
   vp9_set_high_precision_mv(cpi, ALTREF_HIGH_PRECISION_MV);
 
   // Is multi-arf enabled.
@@ -6684,7 +6788,9 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
   if (should_run_tpl(cpi, cpi->twopass.gf_group.index)) {
     vp9_init_tpl_buffer(cpi);
     vp9_estimate_tpl_qp_gop(cpi);
+    g_in_tpl = 1;
     vp9_setup_tpl_stats(cpi);
+    g_in_tpl = 0;
   }
 #if CONFIG_COLLECT_COMPONENT_TIMING
   end_timing(cpi, setup_tpl_stats_time);
@@ -7020,6 +7126,39 @@ int vp9_get_preview_raw_frame(VP9_COMP *cpi, YV12_BUFFER_CONFIG *dest,
   }
 }
 
+int vp9_set_two_pass_chunk(VP9_COMP *cpi, int first_frame, int num_frames) {
+#if !CONFIG_REALTIME_ONLY
+  const VP9EncoderConfig *const oxcf = &cpi->oxcf;
+  const TWO_PASS *const twopass = &cpi->twopass;
+  const FIRSTPASS_STATS *const stats = oxcf->two_pass_stats_in.buf;
+  int num_stats_frames;
+
+  if (oxcf->pass != 2 || stats == NULL || cpi->svc.number_spatial_layers > 1 ||
+      cpi->svc.number_temporal_layers > 1 || cpi->ext_ratectrl.ready) {
+    return -1;
+  }
+  // Nothing must have been encoded, nor a chunk set already.
+  num_stats_frames = (int)(oxcf->two_pass_stats_in.sz / sizeof(*stats)) - 1;
+  if (cpi->common.current_video_frame > 0 ||
+      (cpi->lookahead != NULL && vp9_lookahead_depth(cpi->lookahead) > 0) ||
+      twopass->stats_in_start != stats ||
+      twopass->stats_in_end != stats + num_stats_frames) {
+    return -1;
+  }
+  if (first_frame < 0 || num_frames <= 0 ||
+      num_frames > num_stats_frames - first_frame) {
+    return -1;
+  }
+  vp9_init_second_pass_chunk(cpi, first_frame, num_frames);
+  return 0;
+#else
+  (void)cpi;
+  (void)first_frame;
+  (void)num_frames;
+  return -1;
+#endif  // !CONFIG_REALTIME_ONLY
+}
+
 int vp9_set_internal_size(VP9_COMP *cpi, VPX_SCALING_MODE horiz_mode,
                           VPX_SCALING_MODE vert_mode) {
   VP9_COMMON *cm = &cpi->common;
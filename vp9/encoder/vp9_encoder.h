@@ -26,6 +26,7 @@
 #include "vpx_dsp/psnr.h"
 #include "vpx_ports/system_state.h"
 #include "vpx_util/vpx_pthread.h"
+#include "vpx_util/vpx_atomics.h"
 #include "vpx_util/vpx_thread.h"
 #include "vpx_util/vpx_timestamp.h"
 
@@ -54,6 +55,7 @@
 #include "vp9/encoder/vp9_rd.h"
 #include "vp9/encoder/vp9_speed_features.h"
 #include "vp9/encoder/vp9_svc_layercontext.h"
+#include "vp9/encoder/vp9_task_pool.h"
 #include "vp9/encoder/vp9_tokenize.h"
 
 #if CONFIG_VP9_TEMPORAL_DENOISING
@@ -270,6 +272,7 @@ typedef struct VP9EncoderConfig {
   unsigned int target_level;
 
   vpx_fixed_buf_t two_pass_stats_in;
+  vpx_fixed_buf_t firstpass_mb_stats_in;
 
   vp8e_tuning tuning;
   vp9e_tune_content content;
@@ -286,6 +289,11 @@ typedef struct VP9EncoderConfig {
   unsigned int motion_vector_unit_test;
   int delta_q_uv;
   int use_simple_encode_api;  // Use SimpleEncode APIs or not
+
+  // Fix the frame level coding modes before a frame is encoded and send no
+  // forward probability updates, so that the tiles can be packed while the
+  // rest of the frame is encoded.
+  int pipelined_packing;
 } VP9EncoderConfig;
 
 static INLINE int is_lossless_requested(const VP9EncoderConfig *cfg) {
@@ -301,6 +309,9 @@ typedef struct TplDepStats {
 
   int ref_frame_index;
   int_mv mv;
+  // Motion against each reference of the frame, INVALID_MV where the
+  // reference is missing.
+  int_mv ref_mv[MAX_INTER_REF_FRAMES];
 } TplDepStats;
 
 #if CONFIG_NON_GREEDY_MV
@@ -321,6 +332,10 @@ typedef struct TplDepFrame {
   int mi_rows;
   int mi_cols;
   int base_qindex;
+  // Display order of the frame and of its references, -1 where a reference
+  // is missing.
+  int frame_index;
+  int ref_frame_index[MAX_INTER_REF_FRAMES];
 #if CONFIG_NON_GREEDY_MV
   int lambda;
   int *mv_mode_arr[3];
@@ -349,10 +364,10 @@ typedef struct TileDataEnc {
 } TileDataEnc;
 
 typedef struct RowMTInfo {
-  JobQueueHandle job_queue_hdl;
-#if CONFIG_MULTITHREAD
-  pthread_mutex_t job_mutex;
-#endif
+  // Index of the next job of the tile column to be taken. Workers take jobs
+  // from their own tile column and then from the one with the most jobs left,
+  // always in row order, so that a row only waits for rows already taken.
+  vpx_atomic_int next_job;
 } RowMTInfo;
 
 typedef struct {
@@ -504,10 +519,47 @@ typedef struct ARNRFilterData {
   int strength;
   int frame_count;
   int alt_ref_index;
+  int allow_high_precision_mv;
   struct scale_factors sf;
   YV12_BUFFER_CONFIG *dst;
 } ARNRFilterData;
 
+// Filtering of the ARF coded after the current frame, started by
+// vp9_temporal_filter_start_next() while the frame is still being packed and
+// waited for by the next vp9_get_compressed_data() call. The ARF then uses
+// 'buffer' if it is filtered with the same parameters.
+typedef struct ARNRNextFilter {
+  // Set from when the filtering is queued until it is waited for.
+  int pending;
+  // Set if 'buffer' holds the filtered frame for the current call.
+  int done;
+  int distance;
+  // What cpi->arnr_filter_data and the motion search were set up with. The
+  // rows are filtered with copies of 'x'.
+  ARNRFilterData data;
+  MACROBLOCK x;
+  YV12_BUFFER_CONFIG buffer;
+  // One thread data per task filtering rows, which take them in order.
+  ThreadData *td;
+  int num_td;
+  int num_rows;
+  vpx_atomic_int next_row;
+  VP9TaskGroup tasks;
+} ARNRNextFilter;
+
+// A tile packed by vp9_bitstream_pack_tile() as soon as it is encoded, to be
+// copied into the bitstream by vp9_pack_bitstream().
+typedef struct VP9PackedTile {
+  uint8_t *dest;
+  size_t dest_size;
+  // The size of the packed tile, or 0 if it did not fit in 'dest'.
+  size_t size;
+  // Superblock rows of the tile that are not encoded yet, with row-mt.
+  vpx_atomic_int rows_left;
+  unsigned int max_mv_magnitude;
+  int interp_filter_selected[1][SWITCHABLE];
+} VP9PackedTile;
+
 typedef struct EncFrameBuf {
   int mem_valid;
   int released;
@@ -991,10 +1043,24 @@ typedef struct VP9_COMP {
 
   // Multi-threading
   int num_workers;
-  VPxWorker *workers;
+  // Runs the multi-threaded stages on num_workers - 1 threads and the thread
+  // that waits for them, with one EncWorkerData per task of a stage.
+  VP9TaskPool task_pool;
+  // Tasks of the multi-threaded stage being run.
+  VP9TaskGroup stage_tasks;
+  // Loop filtering of the last frame, queued by loopfilter_frame() to run
+  // while the bitstream is packed, and the extension of its borders once the
+  // frame is filtered.
+  VP9TaskGroup lf_tasks;
+  VP9TaskGroup lf_border_task;
   struct EncWorkerData *tile_thr_data;
   VP9LfSync lf_row_sync;
   struct VP9BitstreamWorkerData *vp9_bitstream_worker_data;
+  // Set while the tiles of the frame are packed as they are encoded.
+  int pack_tiles_early;
+  VP9PackedTile packed_tiles[1 << 6];
+  uint8_t *packed_tiles_buf;
+  size_t packed_tiles_buf_size;
 
   int keep_level_stats;
   Vp9LevelInfo level_info;
@@ -1002,6 +1068,7 @@ typedef struct VP9_COMP {
   void (*row_mt_sync_read_ptr)(VP9RowMTSync *const, int, int);
   void (*row_mt_sync_write_ptr)(VP9RowMTSync *const, int, int, const int);
   ARNRFilterData arnr_filter_data;
+  ARNRNextFilter arnr_next;
 
   int row_mt;
   unsigned int row_mt_bit_exact;
@@ -1253,6 +1320,11 @@ int vp9_set_active_map(VP9_COMP *cpi, unsigned char *new_map_16x16, int rows,
 int vp9_get_active_map(VP9_COMP *cpi, unsigned char *new_map_16x16, int rows,
                        int cols);
 
+// Encodes the 'num_frames' frames of the two pass stats from 'first_frame' as
+// a chunk of the sequence, see VP9E_SET_TWO_PASS_CHUNK. Returns -1 if the
+// encoder is not in its second pass or has started encoding.
+int vp9_set_two_pass_chunk(VP9_COMP *cpi, int first_frame, int num_frames);
+
 int vp9_set_internal_size(VP9_COMP *cpi, VPX_SCALING_MODE horiz_mode,
                           VPX_SCALING_MODE vert_mode);
 
@@ -8,6 +8,8 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <limits.h>
+
 #include "vp9/common/vp9_thread_common.h"
 #include "vp9/encoder/vp9_bitstream.h"
 #include "vp9/encoder/vp9_encodeframe.h"
@@ -15,7 +17,9 @@
 #include "vp9/encoder/vp9_ethread.h"
 #include "vp9/encoder/vp9_firstpass.h"
 #include "vp9/encoder/vp9_multi_thread.h"
+#include "vp9/encoder/vp9_task_pool.h"
 #include "vp9/encoder/vp9_temporal_filter.h"
+#include "vp9/encoder/vp9_tpl_model.h"
 #include "vpx_dsp/vpx_dsp_common.h"
 #include "vpx_util/vpx_pthread.h"
 
@@ -54,6 +58,9 @@ static int enc_worker_hook(void *arg1, void *unused) {
     int tile_col = t % tile_cols;
 
     vp9_encode_tile(cpi, thread_data->td, tile_row, tile_col);
+    if (cpi->pack_tiles_early) {
+      vp9_bitstream_pack_tile(cpi, &thread_data->td->mb.e_mbd, tile_col);
+    }
   }
 
   return 1;
@@ -80,7 +87,6 @@ static int get_max_tile_cols(VP9_COMP *cpi) {
 
 static void create_enc_workers(VP9_COMP *cpi, int num_workers) {
   VP9_COMMON *const cm = &cpi->common;
-  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
   int i;
   // While using SVC, we need to allocate threads according to the highest
   // resolution. When row based multithreading is enabled, it is OK to
@@ -95,19 +101,13 @@ static void create_enc_workers(VP9_COMP *cpi, int num_workers) {
   vp9_bitstream_encode_tiles_buffer_dealloc(cpi);
   vp9_encode_free_mt_data(cpi);
 
-  CHECK_MEM_ERROR(&cm->error, cpi->workers,
-                  vpx_malloc(num_workers * sizeof(*cpi->workers)));
-
   CHECK_MEM_ERROR(&cm->error, cpi->tile_thr_data,
                   vpx_calloc(num_workers, sizeof(*cpi->tile_thr_data)));
 
   for (i = 0; i < num_workers; i++) {
-    VPxWorker *const worker = &cpi->workers[i];
     EncWorkerData *thread_data = &cpi->tile_thr_data[i];
 
     ++cpi->num_workers;
-    winterface->init(worker);
-    worker->thread_name = "vpx enc worker";
 
     if (i < num_workers - 1) {
       thread_data->cpi = cpi;
@@ -125,73 +125,58 @@ static void create_enc_workers(VP9_COMP *cpi, int num_workers) {
       // Allocate frame counters in thread data.
       CHECK_MEM_ERROR(&cm->error, thread_data->td->counts,
                       vpx_calloc(1, sizeof(*thread_data->td->counts)));
-
-      // Create threads
-      if (!winterface->reset(worker))
-        vpx_internal_error(&cm->error, VPX_CODEC_ERROR,
-                           "Tile encoder thread creation failed");
     } else {
       // Main thread acts as a worker and uses the thread data in cpi.
       thread_data->cpi = cpi;
       thread_data->td = &cpi->td;
     }
-    winterface->sync(worker);
   }
+
+  // The thread waiting for the tasks runs them too.
+  vp9_task_pool_init(&cpi->task_pool, &cm->error, num_workers - 1);
 }
 
+// Runs hook(&cpi->tile_thr_data[i], data2) for each of the first num_workers
+// thread data.
 static void launch_enc_workers(VP9_COMP *cpi, VPxWorkerHook hook, void *data2,
                                int num_workers) {
-  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
   int i;
 
+  vp9_task_group_init(&cpi->stage_tasks, NULL);
   for (i = 0; i < num_workers; i++) {
-    VPxWorker *const worker = &cpi->workers[i];
-    worker->hook = hook;
-    worker->data1 = &cpi->tile_thr_data[i];
-    worker->data2 = data2;
-  }
-
-  // Encode a frame
-  for (i = 0; i < num_workers; i++) {
-    VPxWorker *const worker = &cpi->workers[i];
-    EncWorkerData *const thread_data = (EncWorkerData *)worker->data1;
+    EncWorkerData *const thread_data = &cpi->tile_thr_data[i];
 
     // Set the starting tile for each thread.
     thread_data->start = i;
 
-    if (i == cpi->num_workers - 1)
-      winterface->execute(worker);
-    else
-      winterface->launch(worker);
+    vp9_task_pool_add(&cpi->task_pool, &cpi->stage_tasks, hook, thread_data,
+                      data2);
   }
 
   // Encoding ends.
-  for (i = 0; i < num_workers; i++) {
-    VPxWorker *const worker = &cpi->workers[i];
-    winterface->sync(worker);
-  }
+  vp9_task_pool_wait(&cpi->task_pool, &cpi->stage_tasks);
 }
 
 void vp9_encode_free_mt_data(struct VP9_COMP *cpi) {
   int t;
-  for (t = 0; t < cpi->num_workers; ++t) {
-    VPxWorker *const worker = &cpi->workers[t];
-    EncWorkerData *const thread_data = &cpi->tile_thr_data[t];
-
-    // Deallocate allocated threads.
-    vpx_get_worker_interface()->end(worker);
 
-    // Deallocate allocated thread data.
-    if (t < cpi->num_workers - 1) {
-      vpx_free(thread_data->td->counts);
-      vp9_free_pc_tree(thread_data->td);
-      vpx_free(thread_data->td);
-    }
+#if !CONFIG_REALTIME_ONLY
+  vp9_temporal_filter_cancel_next(cpi);
+  vpx_free(cpi->arnr_next.td);
+  cpi->arnr_next.td = NULL;
+  cpi->arnr_next.num_td = 0;
+#endif
+  vp9_task_pool_free(&cpi->task_pool);
+
+  // Deallocate allocated thread data.
+  for (t = 0; t < cpi->num_workers - 1; ++t) {
+    EncWorkerData *const thread_data = &cpi->tile_thr_data[t];
+    vpx_free(thread_data->td->counts);
+    vp9_free_pc_tree(thread_data->td);
+    vpx_free(thread_data->td);
   }
   vpx_free(cpi->tile_thr_data);
   cpi->tile_thr_data = NULL;
-  vpx_free(cpi->workers);
-  cpi->workers = NULL;
   cpi->num_workers = 0;
 }
 
@@ -205,6 +190,8 @@ void vp9_encode_tiles_mt(VP9_COMP *cpi) {
 
   create_enc_workers(cpi, num_workers);
 
+  vp9_bitstream_setup_packed_tiles(cpi);
+
   for (i = 0; i < num_workers; i++) {
     EncWorkerData *const thread_data = &cpi->tile_thr_data[i];
 
@@ -239,8 +226,7 @@ void vp9_encode_tiles_mt(VP9_COMP *cpi) {
   launch_enc_workers(cpi, enc_worker_hook, NULL, num_workers);
 
   for (i = 0; i < num_workers; i++) {
-    VPxWorker *const worker = &cpi->workers[i];
-    EncWorkerData *const thread_data = (EncWorkerData *)worker->data1;
+    EncWorkerData *const thread_data = &cpi->tile_thr_data[i];
 
     // Accumulate counters.
     if (i < cpi->num_workers - 1) {
@@ -311,6 +297,12 @@ void vp9_row_mt_sync_mem_alloc(VP9RowMTSync *row_mt_sync, VP9_COMMON *cm,
         pthread_cond_init(&row_mt_sync->cond[i], NULL);
       }
     }
+
+    CHECK_MEM_ERROR(&cm->error, row_mt_sync->num_waiting,
+                    vpx_malloc(sizeof(*row_mt_sync->num_waiting) * rows));
+    for (i = 0; i < rows; ++i) {
+      vpx_atomic_init(&row_mt_sync->num_waiting[i], 0);
+    }
   }
 #endif  // CONFIG_MULTITHREAD
 
@@ -339,6 +331,7 @@ void vp9_row_mt_sync_mem_dealloc(VP9RowMTSync *row_mt_sync) {
       }
       vpx_free(row_mt_sync->cond);
     }
+    vpx_free(row_mt_sync->num_waiting);
 #endif  // CONFIG_MULTITHREAD
     vpx_free(row_mt_sync->cur_col);
     // clear the structure as the source of this call may be dynamic change
@@ -353,12 +346,23 @@ void vp9_row_mt_sync_read(VP9RowMTSync *const row_mt_sync, int r, int c) {
   const int nsync = row_mt_sync->sync_range;
 
   if (r && !(c & (nsync - 1))) {
+    const int kMaxSpins = 4000;
+    const vpx_atomic_int *const cur_col = &row_mt_sync->cur_col[r - 1];
     pthread_mutex_t *const mutex = &row_mt_sync->mutex[r - 1];
-    pthread_mutex_lock(mutex);
+    int i;
+
+    // The row above is usually ahead already or close behind, so it is polled
+    // before sleeping on its condition.
+    for (i = 0; i < kMaxSpins; ++i) {
+      if (c <= vpx_atomic_load_acquire(cur_col) - nsync + 1) return;
+    }
 
-    while (c > row_mt_sync->cur_col[r - 1] - nsync + 1) {
+    pthread_mutex_lock(mutex);
+    vpx_atomic_fetch_add(&row_mt_sync->num_waiting[r - 1], 1);
+    while (c > vpx_atomic_load_acquire(cur_col) - nsync + 1) {
       pthread_cond_wait(&row_mt_sync->cond[r - 1], mutex);
     }
+    vpx_atomic_fetch_add(&row_mt_sync->num_waiting[r - 1], -1);
     pthread_mutex_unlock(mutex);
   }
 #else
@@ -391,12 +395,14 @@ void vp9_row_mt_sync_write(VP9RowMTSync *const row_mt_sync, int r, int c,
   }
 
   if (sig) {
-    pthread_mutex_lock(&row_mt_sync->mutex[r]);
-
-    row_mt_sync->cur_col[r] = cur;
-
-    pthread_cond_signal(&row_mt_sync->cond[r]);
-    pthread_mutex_unlock(&row_mt_sync->mutex[r]);
+    vpx_atomic_store_release(&row_mt_sync->cur_col[r], cur);
+    // The read-modify-write orders the store before the check, so a thread
+    // that is about to sleep either sees the new column or is seen here.
+    if (vpx_atomic_fetch_add(&row_mt_sync->num_waiting[r], 0) > 0) {
+      pthread_mutex_lock(&row_mt_sync->mutex[r]);
+      pthread_cond_signal(&row_mt_sync->cond[r]);
+      pthread_mutex_unlock(&row_mt_sync->mutex[r]);
+    }
   }
 #else
   (void)row_mt_sync;
@@ -584,8 +590,82 @@ void vp9_temporal_filter_row_mt(VP9_COMP *cpi) {
   launch_enc_workers(cpi, temporal_filter_worker_hook, multi_thread_ctxt,
                      num_workers);
 }
+
+static int temporal_filter_rows_hook(void *arg1, void *arg2) {
+  VP9_COMP *const cpi = (VP9_COMP *)arg1;
+  ThreadData *const td = (ThreadData *)arg2;
+  ARNRNextFilter *const next = &cpi->arnr_next;
+  const YV12_BUFFER_CONFIG *const f =
+      next->data.frames[next->data.alt_ref_index];
+  const int mb_cols = (f->y_crop_width + BW - 1) >> BW_LOG2;
+  const int mb_row = vpx_atomic_fetch_add(&next->next_row, 1);
+
+  if (mb_row < next->num_rows) {
+    vp9_temporal_filter_iterate_row_c(cpi, td, mb_row, 0, mb_cols);
+    // Take the next row once the tasks queued meanwhile, those of the frame
+    // being coded, have started.
+    if (mb_row + 1 < next->num_rows) {
+      vp9_task_pool_add(&cpi->task_pool, &next->tasks,
+                        temporal_filter_rows_hook, cpi, td);
+    }
+  }
+  return 1;
+}
+
+void vp9_temporal_filter_rows_start(VP9_COMP *cpi) {
+  VP9_COMMON *const cm = &cpi->common;
+  ARNRNextFilter *const next = &cpi->arnr_next;
+  const int num_tasks = cpi->num_workers - 1;
+  int i;
+
+  assert(num_tasks > 0);
+  if (next->num_td != num_tasks) {
+    vpx_free(next->td);
+    next->num_td = 0;
+    CHECK_MEM_ERROR(&cm->error, next->td,
+                    vpx_memalign(32, num_tasks * sizeof(*next->td)));
+    memset(next->td, 0, num_tasks * sizeof(*next->td));
+    next->num_td = num_tasks;
+  }
+
+  vpx_atomic_init(&next->next_row, 0);
+  vp9_task_group_init(&next->tasks, NULL);
+  for (i = 0; i < num_tasks; ++i) {
+    next->td[i].mb = next->x;
+    vp9_task_pool_add(&cpi->task_pool, &next->tasks, temporal_filter_rows_hook,
+                      cpi, &next->td[i]);
+  }
+}
 #endif  // !CONFIG_REALTIME_ONLY
 
+static int tpl_worker_hook(void *arg1, void *arg2) {
+  EncWorkerData *const thread_data = (EncWorkerData *)arg1;
+  vp9_tpl_estimate_rows(thread_data->cpi, thread_data->td,
+                        (TplEstimateJobs *)arg2);
+  return 1;
+}
+
+void vp9_tpl_row_mt(VP9_COMP *cpi, TplEstimateJobs *jobs) {
+  // Use as many threads as the frames are encoded with, so that they are not
+  // recreated for it.
+  const int num_workers = cpi->row_mt ? VPXMAX(cpi->oxcf.max_threads, 1)
+                                      : VPXMAX(cpi->num_workers, 1);
+  int i;
+
+  create_enc_workers(cpi, num_workers);
+
+  for (i = 0; i < cpi->num_workers; i++) {
+    EncWorkerData *const thread_data = &cpi->tile_thr_data[i];
+
+    // Before estimating the frames, copy the thread data from cpi.
+    if (thread_data->td != &cpi->td) {
+      thread_data->td->mb = cpi->td.mb;
+    }
+  }
+
+  launch_enc_workers(cpi, tpl_worker_hook, jobs, cpi->num_workers);
+}
+
 static int enc_row_mt_worker_hook(void *arg1, void *arg2) {
   EncWorkerData *const thread_data = (EncWorkerData *)arg1;
   MultiThreadHandle *multi_thread_ctxt = (MultiThreadHandle *)arg2;
@@ -615,6 +695,13 @@ static int enc_row_mt_worker_hook(void *arg1, void *arg2) {
       mi_row = proc_job->vert_unit_row_num * MI_BLOCK_SIZE;
 
       vp9_encode_sb_row(cpi, thread_data->td, tile_row, tile_col, mi_row);
+
+      // The tile is packed by the thread encoding its last row.
+      if (cpi->pack_tiles_early &&
+          vpx_atomic_fetch_add(&cpi->packed_tiles[tile_col].rows_left, -1) ==
+              1) {
+        vp9_bitstream_pack_tile(cpi, &thread_data->td->mb.e_mbd, tile_col);
+      }
     }
   }
   return 1;
@@ -646,6 +733,8 @@ void vp9_encode_tiles_row_mt(VP9_COMP *cpi) {
 
   vp9_multi_thread_tile_init(cpi);
 
+  vp9_bitstream_setup_packed_tiles(cpi);
+
   for (i = 0; i < num_workers; i++) {
     EncWorkerData *thread_data;
     thread_data = &cpi->tile_thr_data[i];
@@ -681,8 +770,7 @@ void vp9_encode_tiles_row_mt(VP9_COMP *cpi) {
                      num_workers);
 
   for (i = 0; i < num_workers; i++) {
-    VPxWorker *const worker = &cpi->workers[i];
-    EncWorkerData *const thread_data = (EncWorkerData *)worker->data1;
+    EncWorkerData *const thread_data = &cpi->tile_thr_data[i];
 
     // Accumulate counters.
     if (i < cpi->num_workers - 1) {
@@ -691,3 +779,82 @@ void vp9_encode_tiles_row_mt(VP9_COMP *cpi) {
     }
   }
 }
+
+static int loop_filter_row_task(void *arg1, void *arg2) {
+  vp9_loopfilter_job((LFWorkerData *)arg2, (VP9LfSync *)arg1);
+  return 1;
+}
+
+// Queues the filtering of the superblock rows from 'start_mi_row' to
+// 'end_mi_row', one in every 'sb_row_step'.
+static void loop_filter_rows_tasks(VP9_COMP *cpi, YV12_BUFFER_CONFIG *frame,
+                                   int frame_filter_level, int y_only,
+                                   int start_mi_row, int end_mi_row,
+                                   int sb_row_step, VP9TaskGroup *group) {
+  VP9_COMMON *const cm = &cpi->common;
+  VP9LfSync *const lf_sync = &cpi->lf_row_sync;
+  const int sb_rows = mi_cols_aligned_to_sb(cm->mi_rows) >> MI_BLOCK_SIZE_LOG2;
+  int mi_row, i;
+
+  vp9_loop_filter_frame_init(cm, frame_filter_level);
+
+  // Each superblock row is filtered by a task with its own LFWorkerData.
+  // Tasks start in order, so a row only waits for rows that are being
+  // filtered.
+  if (!lf_sync->sync_range || sb_rows != lf_sync->rows ||
+      sb_rows > lf_sync->num_workers) {
+    vp9_loop_filter_dealloc(lf_sync);
+    vp9_loop_filter_alloc(lf_sync, cm, sb_rows, cm->width, sb_rows);
+  }
+  // The rows that are not filtered are left as they are.
+  for (i = 0; i < sb_rows; ++i) {
+    vpx_atomic_init(&lf_sync->cur_sb_col[i], INT_MAX);
+  }
+  for (mi_row = start_mi_row; mi_row < end_mi_row;
+       mi_row += sb_row_step * MI_BLOCK_SIZE) {
+    vpx_atomic_init(&lf_sync->cur_sb_col[mi_row >> MI_BLOCK_SIZE_LOG2], -1);
+  }
+
+  for (mi_row = start_mi_row; mi_row < end_mi_row;
+       mi_row += sb_row_step * MI_BLOCK_SIZE) {
+    LFWorkerData *const lf_data =
+        &lf_sync->lfdata[mi_row >> MI_BLOCK_SIZE_LOG2];
+    vp9_loop_filter_data_reset(lf_data, frame, cm, cpi->td.mb.e_mbd.plane);
+    lf_data->start = mi_row;
+    lf_data->stop = VPXMIN(mi_row + MI_BLOCK_SIZE, end_mi_row);
+    lf_data->y_only = y_only;
+    vp9_task_pool_add(&cpi->task_pool, group, loop_filter_row_task, lf_sync,
+                      lf_data);
+  }
+}
+
+void vp9_loop_filter_frame_tasks(VP9_COMP *cpi, YV12_BUFFER_CONFIG *frame,
+                                 int frame_filter_level, int y_only,
+                                 int partial_frame, VP9TaskGroup *group) {
+  const VP9_COMMON *const cm = &cpi->common;
+  int start_mi_row, end_mi_row;
+
+  if (!frame_filter_level) return;
+
+  start_mi_row = 0;
+  end_mi_row = cm->mi_rows;
+  if (partial_frame && cm->mi_rows > 8) {
+    start_mi_row = cm->mi_rows >> 1;
+    start_mi_row &= 0xfffffff8;
+    end_mi_row = start_mi_row + VPXMAX(cm->mi_rows / 8, 8);
+  }
+  loop_filter_rows_tasks(cpi, frame, frame_filter_level, y_only, start_mi_row,
+                         end_mi_row, 1, group);
+}
+
+void vp9_loop_filter_sampled_rows_tasks(VP9_COMP *cpi,
+                                        YV12_BUFFER_CONFIG *frame,
+                                        int frame_filter_level, int y_only,
+                                        int first_sb_row, int sb_row_step,
+                                        VP9TaskGroup *group) {
+  if (!frame_filter_level) return;
+  assert(sb_row_step > 1);
+  loop_filter_rows_tasks(cpi, frame, frame_filter_level, y_only,
+                         first_sb_row * MI_BLOCK_SIZE, cpi->common.mi_rows,
+                         sb_row_step, group);
+}
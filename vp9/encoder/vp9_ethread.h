@@ -11,6 +11,8 @@
 #ifndef VPX_VP9_ENCODER_VP9_ETHREAD_H_
 #define VPX_VP9_ENCODER_VP9_ETHREAD_H_
 
+#include "vpx_scale/yv12config.h"
+#include "vpx_util/vpx_atomics.h"
 #include "vpx_util/vpx_pthread.h"
 
 #ifdef __cplusplus
@@ -23,6 +25,8 @@ extern "C" {
 
 struct VP9_COMP;
 struct ThreadData;
+struct TplEstimateJobs;
+struct VP9TaskGroup;
 
 typedef struct EncWorkerData {
   struct VP9_COMP *cpi;
@@ -37,9 +41,11 @@ typedef struct VP9RowMTSyncData {
 #if CONFIG_MULTITHREAD
   pthread_mutex_t *mutex;
   pthread_cond_t *cond;
+  // Number of threads sleeping on the condition of each row.
+  vpx_atomic_int *num_waiting;
 #endif
   // Allocate memory to store the sb/mb block index in each row.
-  int *cur_col;
+  vpx_atomic_int *cur_col;
   int sync_range;
   int rows;
 } VP9RowMTSync;
@@ -72,6 +78,30 @@ void vp9_row_mt_sync_mem_dealloc(VP9RowMTSync *row_mt_sync);
 
 void vp9_temporal_filter_row_mt(struct VP9_COMP *cpi);
 
+// Queues the filtering of the rows of the frame set up in cpi->arnr_next on
+// the threads of cpi->task_pool, to be waited for with its 'tasks'.
+void vp9_temporal_filter_rows_start(struct VP9_COMP *cpi);
+
+// Runs vp9_tpl_estimate_rows() on the encoder threads until 'jobs' are done.
+void vp9_tpl_row_mt(struct VP9_COMP *cpi, struct TplEstimateJobs *jobs);
+
+// Queues the loop filtering of 'frame' on cpi->task_pool as tasks of 'group',
+// with the same arguments as vp9_loop_filter_frame(). The frame is filtered
+// once the tasks are done.
+void vp9_loop_filter_frame_tasks(struct VP9_COMP *cpi,
+                                 YV12_BUFFER_CONFIG *frame,
+                                 int frame_filter_level, int y_only,
+                                 int partial_frame, struct VP9TaskGroup *group);
+
+// Like vp9_loop_filter_frame_tasks(), but only filters the superblock rows
+// 'first_sb_row' + k * 'sb_row_step'. Each is filtered as if the rows around
+// it were not, so 'sb_row_step' must be more than 1.
+void vp9_loop_filter_sampled_rows_tasks(struct VP9_COMP *cpi,
+                                        YV12_BUFFER_CONFIG *frame,
+                                        int frame_filter_level, int y_only,
+                                        int first_sb_row, int sb_row_step,
+                                        struct VP9TaskGroup *group);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
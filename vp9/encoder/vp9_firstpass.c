@@ -250,13 +250,13 @@ static double calculate_active_area(const FRAME_INFO *frame_info,
 // Get the average weighted error for the clip (or corpus)
 static double get_distribution_av_err(VP9_COMP *cpi, TWO_PASS *const twopass) {
   const double av_weight =
-      twopass->total_stats.weight / twopass->total_stats.count;
+      twopass->sequence_stats.weight / twopass->sequence_stats.count;
 
   if (cpi->oxcf.vbr_corpus_complexity)
     return av_weight * twopass->mean_mod_score;
   else
-    return (twopass->total_stats.coded_error * av_weight) /
-           twopass->total_stats.count;
+    return (twopass->sequence_stats.coded_error * av_weight) /
+           twopass->sequence_stats.count;
 }
 
 #define ACT_AREA_CORRECTION 0.5
@@ -339,6 +339,8 @@ void vp9_end_first_pass(VP9_COMP *cpi) {
   cpi->twopass.first_pass_done = 1;
   vpx_free(cpi->twopass.fp_mb_float_stats);
   cpi->twopass.fp_mb_float_stats = NULL;
+  vpx_free(cpi->twopass.fp_mb_mvs);
+  cpi->twopass.fp_mb_mvs = NULL;
 }
 
 static vpx_variance_fn_t get_block_variance_fn(BLOCK_SIZE bsize) {
@@ -970,6 +972,8 @@ void vp9_first_pass_encode_tile_mb_row(VP9_COMP *cpi, ThreadData *td,
     if (mb_col == mb_col_start) {
       last_nonzero_mv = *first_top_mv;
     }
+    if (cpi->twopass.fp_mb_mvs != NULL)
+      cpi->twopass.fp_mb_mvs[mb_index].as_int = INVALID_MV;
 
     // Adjust to the next column of MBs.
     x->plane[0].src.buf = cpi->Source->y_buffer +
@@ -1292,6 +1296,8 @@ void vp9_first_pass_encode_tile_mb_row(VP9_COMP *cpi, ThreadData *td,
         ++(fp_acc_data->intercount);
 
         *best_ref_mv = mv;
+        if (cpi->twopass.fp_mb_mvs != NULL)
+          cpi->twopass.fp_mb_mvs[mb_index].as_mv = mv;
 
         if (!is_zero_mv(&mv)) {
           ++(fp_acc_data->mvcount);
@@ -1448,6 +1454,11 @@ void vp9_first_pass(VP9_COMP *cpi, const struct lookahead_entry *source) {
         &cm->error, cpi->twopass.fp_mb_float_stats,
         vpx_calloc(cm->MBs * sizeof(*cpi->twopass.fp_mb_float_stats), 1));
 
+  // Spatial layers differ in size and do not export their motion.
+  if (!cpi->use_svc && cpi->twopass.fp_mb_mvs == NULL)
+    CHECK_MEM_ERROR(&cm->error, cpi->twopass.fp_mb_mvs,
+                    vpx_malloc(cm->MBs * sizeof(*cpi->twopass.fp_mb_mvs)));
+
   {
     FIRSTPASS_STATS fps;
     TileDataEnc *first_tile_col;
@@ -1671,6 +1682,7 @@ void vp9_init_second_pass(VP9_COMP *cpi) {
   FIRSTPASS_STATS *stats;
 
   zero_stats(&twopass->total_stats);
+  zero_stats(&twopass->sequence_stats);
   zero_stats(&twopass->total_left_stats);
 
   if (!twopass->stats_in_end) return;
@@ -1678,6 +1690,7 @@ void vp9_init_second_pass(VP9_COMP *cpi) {
   stats = &twopass->total_stats;
 
   *stats = *twopass->stats_in_end;
+  twopass->sequence_stats = *stats;
   twopass->total_left_stats = *stats;
 
   // Scan the first pass file and calculate a modified score for each
@@ -1774,6 +1787,92 @@ void vp9_init_second_pass(VP9_COMP *cpi) {
   twopass->arnr_strength_adjustment = 0;
 }
 
+void vp9_init_second_pass_chunk(VP9_COMP *cpi, int first_frame,
+                                int num_frames) {
+  TWO_PASS *const twopass = &cpi->twopass;
+  const FIRSTPASS_STATS *const start = twopass->stats_in_start + first_frame;
+  const FIRSTPASS_STATS *s;
+  const double av_err = get_distribution_av_err(cpi, twopass);
+  double chunk_score = 0.0;
+
+  assert(twopass->stats_in == twopass->stats_in_start);
+  assert(first_frame >= 0 && num_frames > 0);
+  assert(start + num_frames <= twopass->stats_in_end);
+
+  zero_stats(&twopass->total_stats);
+  for (s = start; s < start + num_frames; ++s) {
+    accumulate_stats(&twopass->total_stats, s);
+    chunk_score +=
+        calculate_norm_frame_score(cpi, twopass, &cpi->oxcf, s, av_err);
+  }
+  twopass->total_left_stats = twopass->total_stats;
+
+  // The frame scores are normalized over the whole sequence, so the chunk
+  // gets the bits that a full encode would assign to its key frame groups.
+  if (twopass->normalized_score_left > 0.0) {
+    twopass->bits_left = (int64_t)((double)twopass->bits_left * chunk_score /
+                                   twopass->normalized_score_left);
+  } else {
+    twopass->bits_left = (int64_t)((double)twopass->bits_left *
+                                   twopass->total_stats.duration /
+                                   twopass->sequence_stats.duration);
+  }
+  twopass->normalized_score_left = chunk_score;
+
+  twopass->stats_in_start = start;
+  twopass->stats_in = start;
+  twopass->stats_in_end = start + num_frames;
+  fps_init_first_pass_info(&twopass->first_pass_info, start, num_frames);
+
+  if (twopass->mb_mvs_in != NULL) {
+    if (first_frame + num_frames <= twopass->mb_mvs_in_frames) {
+      twopass->mb_mvs_in += (size_t)first_frame * twopass->mb_mvs_in_rows *
+                            twopass->mb_mvs_in_cols;
+      twopass->mb_mvs_in_frames = num_frames;
+    } else {
+      twopass->mb_mvs_in = NULL;
+      twopass->mb_mvs_in_frames = 0;
+    }
+  }
+}
+
+// First pass motion is only extrapolated this many frames.
+#define MAX_FP_MV_REF_DISTANCE 16
+
+int vp9_get_first_pass_mv(const VP9_COMP *cpi, int frame_index,
+                          int ref_frame_index, int mi_row, int mi_col,
+                          BLOCK_SIZE bsize, MV *mv) {
+  const VP9_COMMON *const cm = &cpi->common;
+  const TWO_PASS *const twopass = &cpi->twopass;
+  const int distance = frame_index - ref_frame_index;
+  int mb_row, mb_col;
+  int_mv fp_mv;
+
+  // The first pass ran at the configured size, so resized frames can't use
+  // its motion field.
+  if (twopass->mb_mvs_in == NULL || cm->mb_rows != twopass->mb_mvs_in_rows ||
+      cm->mb_cols != twopass->mb_mvs_in_cols)
+    return 0;
+  if (frame_index < 0 || frame_index >= twopass->mb_mvs_in_frames ||
+      distance == 0 || abs(distance) > MAX_FP_MV_REF_DISTANCE)
+    return 0;
+
+  mb_row = VPXMIN((mi_row + (num_8x8_blocks_high_lookup[bsize] >> 1)) >> 1,
+                  cm->mb_rows - 1);
+  mb_col = VPXMIN((mi_col + (num_8x8_blocks_wide_lookup[bsize] >> 1)) >> 1,
+                  cm->mb_cols - 1);
+  fp_mv = twopass->mb_mvs_in[((size_t)frame_index * cm->mb_rows + mb_row) *
+                                 cm->mb_cols +
+                             mb_col];
+  if (fp_mv.as_int == INVALID_MV) return 0;
+
+  // The first pass searched against the previous frame, so assume the motion
+  // is steady over the distance to the reference.
+  mv->row = (int16_t)clamp(fp_mv.as_mv.row * distance, MV_LOW + 1, MV_UPP - 1);
+  mv->col = (int16_t)clamp(fp_mv.as_mv.col * distance, MV_LOW + 1, MV_UPP - 1);
+  return 1;
+}
+
 /* This function considers how the quality of prediction may be deteriorating
  * with distance. It compares the coded error for the last frame and the
  * second reference frame (usually two frames old) and also applies a factor
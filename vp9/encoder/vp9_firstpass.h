@@ -139,6 +139,9 @@ typedef struct {
   unsigned int section_intra_rating;
   unsigned int key_frame_section_intra_rating;
   FIRSTPASS_STATS total_stats;
+  // Totals of the whole sequence, which set how its bits are distributed.
+  // Same as total_stats unless only a chunk of it is encoded.
+  FIRSTPASS_STATS sequence_stats;
   FIRSTPASS_STATS this_frame_stats;
   const FIRSTPASS_STATS *stats_in;
   const FIRSTPASS_STATS *stats_in_start;
@@ -154,6 +157,17 @@ typedef struct {
 
   FP_MB_FLOAT_STATS *fp_mb_float_stats;
 
+  // First pass motion of the current frame against the last frame, one
+  // vector per 16x16 macroblock, INVALID_MV where intra coding won.
+  int_mv *fp_mb_mvs;
+
+  // First pass motion fields of the frames to encode, in display order, or
+  // NULL when the application did not provide them.
+  const int_mv *mb_mvs_in;
+  int mb_mvs_in_frames;
+  int mb_mvs_in_rows;
+  int mb_mvs_in_cols;
+
   // An indication of the content type of the current frame
   FRAME_CONTENT_TYPE fr_content_type;
 
@@ -214,7 +228,20 @@ void vp9_first_pass_encode_tile_mb_row(struct VP9_COMP *cpi,
                                        MV *best_ref_mv, int mb_row);
 
 void vp9_init_second_pass(struct VP9_COMP *cpi);
+// Restricts an initialized second pass to the 'num_frames' frames of its
+// stats from 'first_frame', before anything is encoded. The chunk gets the
+// share of the bits that the whole sequence would give it, so that chunks
+// encoded separately add up to the target of the sequence.
+void vp9_init_second_pass_chunk(struct VP9_COMP *cpi, int first_frame,
+                                int num_frames);
 void vp9_rc_get_second_pass_params(struct VP9_COMP *cpi);
+
+// Looks up the first pass motion of the macroblock at the centre of the block
+// at (mi_row, mi_col) in the frame shown at frame_index, and scales it to the
+// reference shown at ref_frame_index. Returns 0 if there is none to use.
+int vp9_get_first_pass_mv(const struct VP9_COMP *cpi, int frame_index,
+                          int ref_frame_index, int mi_row, int mi_col,
+                          BLOCK_SIZE bsize, MV *mv);
 void vp9_init_vizier_params(TWO_PASS *const twopass, int screen_area);
 
 // Post encode update of the rate control parameters for 2-pass
@@ -25,22 +25,11 @@ typedef struct {
   int tile_row_id;        // tile col id within a tile
 } JobNode;
 
-// Job queue element parameters
+// Job queue element parameters. The jobs of a tile column are stored in row
+// order and taken in that order.
 typedef struct {
-  // Pointer to the next link in the job queue
-  void *next;
-
   // Job information context of the module
   JobNode job_info;
 } JobQueue;
 
-// Job queue handle
-typedef struct {
-  // Pointer to the next link in the job queue
-  void *next;
-
-  // Counter to store the number of jobs picked up for processing
-  int num_jobs_acquired;
-} JobQueueHandle;
-
 #endif  // VPX_VP9_ENCODER_VP9_JOB_QUEUE_H_
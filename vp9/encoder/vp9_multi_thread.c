@@ -10,7 +10,6 @@
 
 #include <assert.h>
 
-#include "vpx_util/vpx_pthread.h"
 #include "vp9/encoder/vp9_encoder.h"
 #include "vp9/encoder/vp9_ethread.h"
 #include "vp9/encoder/vp9_multi_thread.h"
@@ -18,38 +17,18 @@
 
 void *vp9_enc_grp_get_next_job(MultiThreadHandle *multi_thread_ctxt,
                                int tile_id) {
-  RowMTInfo *row_mt_info;
-  JobQueueHandle *job_queue_hdl = NULL;
-  void *next = NULL;
-  JobNode *job_info = NULL;
-#if CONFIG_MULTITHREAD
-  pthread_mutex_t *mutex_handle = NULL;
-#endif
-
-  row_mt_info = (RowMTInfo *)(&multi_thread_ctxt->row_mt_info[tile_id]);
-  job_queue_hdl = (JobQueueHandle *)&row_mt_info->job_queue_hdl;
-#if CONFIG_MULTITHREAD
-  mutex_handle = &row_mt_info->job_mutex;
-#endif
+  RowMTInfo *const row_mt_info = &multi_thread_ctxt->row_mt_info[tile_id];
+  const int jobs_per_tile_col = multi_thread_ctxt->jobs_per_tile_col;
+  int job;
 
-// lock the mutex for queue access
-#if CONFIG_MULTITHREAD
-  pthread_mutex_lock(mutex_handle);
-#endif
-  next = job_queue_hdl->next;
-  if (next != NULL) {
-    JobQueue *job_queue = (JobQueue *)next;
-    job_info = &job_queue->job_info;
-    // Update the next job in the queue
-    job_queue_hdl->next = job_queue->next;
-    job_queue_hdl->num_jobs_acquired++;
+  // Checked first so that the index stops growing once the tile is done.
+  if (vpx_atomic_load_acquire(&row_mt_info->next_job) >= jobs_per_tile_col) {
+    return NULL;
   }
-
-#if CONFIG_MULTITHREAD
-  pthread_mutex_unlock(mutex_handle);
-#endif
-
-  return job_info;
+  job = vpx_atomic_fetch_add(&row_mt_info->next_job, 1);
+  if (job >= jobs_per_tile_col) return NULL;
+  return &multi_thread_ctxt->job_queue[tile_id * jobs_per_tile_col + job]
+              .job_info;
 }
 
 void vp9_row_mt_alloc_rd_thresh(VP9_COMP *const cpi,
@@ -96,14 +75,6 @@ void vp9_row_mt_mem_alloc(VP9_COMP *cpi) {
   CHECK_MEM_ERROR(&cm->error, multi_thread_ctxt->job_queue,
                   (JobQueue *)vpx_memalign(32, total_jobs * sizeof(JobQueue)));
 
-#if CONFIG_MULTITHREAD
-  // Create mutex for each tile
-  for (tile_col = 0; tile_col < tile_cols; tile_col++) {
-    RowMTInfo *row_mt_info = &multi_thread_ctxt->row_mt_info[tile_col];
-    pthread_mutex_init(&row_mt_info->job_mutex, NULL);
-  }
-#endif
-
   // Allocate memory for row based multi-threading
   for (tile_col = 0; tile_col < tile_cols; tile_col++) {
     TileDataEnc *this_tile = &cpi->tile_data[tile_col];
@@ -141,15 +112,6 @@ void vp9_row_mt_mem_dealloc(VP9_COMP *cpi) {
     multi_thread_ctxt->job_queue = NULL;
   }
 
-#if CONFIG_MULTITHREAD
-  // Destroy mutex for each tile
-  for (tile_col = 0; tile_col < multi_thread_ctxt->allocated_tile_cols;
-       tile_col++) {
-    RowMTInfo *row_mt_info = &multi_thread_ctxt->row_mt_info[tile_col];
-    pthread_mutex_destroy(&row_mt_info->job_mutex);
-  }
-#endif
-
   // Free row based multi-threading sync memory
   for (tile_col = 0; tile_col < multi_thread_ctxt->allocated_tile_cols;
        tile_col++) {
@@ -187,10 +149,12 @@ void vp9_multi_thread_tile_init(VP9_COMP *cpi) {
   for (i = 0; i < tile_cols; i++) {
     TileDataEnc *this_tile = &cpi->tile_data[i];
     int jobs_per_tile_col = cpi->oxcf.pass == 1 ? cm->mb_rows : sb_rows;
+    int row;
 
     // Initialize cur_col to -1 for all rows.
-    memset(this_tile->row_mt_sync.cur_col, -1,
-           sizeof(*this_tile->row_mt_sync.cur_col) * jobs_per_tile_col);
+    for (row = 0; row < jobs_per_tile_col; ++row) {
+      vpx_atomic_init(&this_tile->row_mt_sync.cur_col[row], -1);
+    }
     vp9_zero(this_tile->fp_data);
     this_tile->fp_data.image_data_start_row = INVALID_ROW;
   }
@@ -210,29 +174,9 @@ void vp9_assign_tile_to_thread(MultiThreadHandle *multi_thread_ctxt,
 
 int vp9_get_job_queue_status(MultiThreadHandle *multi_thread_ctxt,
                              int cur_tile_id) {
-  RowMTInfo *row_mt_info;
-  JobQueueHandle *job_queue_hndl;
-#if CONFIG_MULTITHREAD
-  pthread_mutex_t *mutex;
-#endif
-  int num_jobs_remaining;
-
-  row_mt_info = &multi_thread_ctxt->row_mt_info[cur_tile_id];
-  job_queue_hndl = &row_mt_info->job_queue_hdl;
-#if CONFIG_MULTITHREAD
-  mutex = &row_mt_info->job_mutex;
-#endif
-
-#if CONFIG_MULTITHREAD
-  pthread_mutex_lock(mutex);
-#endif
-  num_jobs_remaining =
-      multi_thread_ctxt->jobs_per_tile_col - job_queue_hndl->num_jobs_acquired;
-#if CONFIG_MULTITHREAD
-  pthread_mutex_unlock(mutex);
-#endif
-
-  return (num_jobs_remaining);
+  const int next_job = vpx_atomic_load_acquire(
+      &multi_thread_ctxt->row_mt_info[cur_tile_id].next_job);
+  return VPXMAX(multi_thread_ctxt->jobs_per_tile_col - next_job, 0);
 }
 
 void vp9_prepare_job_queue(VP9_COMP *cpi, JOB_TYPE job_type) {
@@ -262,23 +206,17 @@ void vp9_prepare_job_queue(VP9_COMP *cpi, JOB_TYPE job_type) {
   // Job queue preparation
   for (tile_col = 0; tile_col < tile_cols; tile_col++) {
     RowMTInfo *tile_ctxt = &multi_thread_ctxt->row_mt_info[tile_col];
-    JobQueue *job_queue_curr, *job_queue_temp;
     int tile_row = 0;
 
-    tile_ctxt->job_queue_hdl.next = (void *)job_queue;
-    tile_ctxt->job_queue_hdl.num_jobs_acquired = 0;
-
-    job_queue_curr = job_queue;
-    job_queue_temp = job_queue;
+    vpx_atomic_init(&tile_ctxt->next_job, 0);
 
     // loop over all the vertical rows
     for (job_row_num = 0, jobs_per_tile = 0; job_row_num < jobs_per_tile_col;
          job_row_num++, jobs_per_tile++) {
-      job_queue_curr->job_info.vert_unit_row_num = job_row_num;
-      job_queue_curr->job_info.tile_col_id = tile_col;
-      job_queue_curr->job_info.tile_row_id = tile_row;
-      job_queue_curr->next = (void *)(job_queue_temp + 1);
-      job_queue_curr = ++job_queue_temp;
+      JobNode *const job_info = &job_queue[job_row_num].job_info;
+      job_info->vert_unit_row_num = job_row_num;
+      job_info->tile_col_id = tile_col;
+      job_info->tile_row_id = tile_row;
 
       if (ENCODE_JOB == job_type) {
         if (jobs_per_tile >=
@@ -289,10 +227,6 @@ void vp9_prepare_job_queue(VP9_COMP *cpi, JOB_TYPE job_type) {
       }
     }
 
-    // Set the last pointer to NULL
-    job_queue_curr += -1;
-    job_queue_curr->next = (void *)NULL;
-
     // Move to the next tile
     job_queue += jobs_per_tile_col;
   }
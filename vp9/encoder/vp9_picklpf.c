@@ -43,40 +43,172 @@ static int get_max_filter_level(const VP9_COMP *cpi) {
   }
 }
 
-static int64_t try_filter_frame(const YV12_BUFFER_CONFIG *sd,
-                                VP9_COMP *const cpi, int filt_level,
-                                int partial_frame) {
+// LPF_PICK_FROM_SAMPLED_ROWS tries the superblock rows
+// LPF_SAMPLED_ROW_STEP / 2 + k * LPF_SAMPLED_ROW_STEP.
+#define LPF_SAMPLED_ROW_STEP 4
+
+// The superblock rows of a trial, which are measured and then restored in
+// bands: band i has the rows first_sb_row + (i + k * num_bands) * sb_row_step.
+typedef struct {
+  const YV12_BUFFER_CONFIG *sd;
+  YV12_BUFFER_CONFIG *frame;
+  const YV12_BUFFER_CONFIG *unfiltered;
+  int sb_rows;
+  int first_sb_row;
+  int sb_row_step;
+  int num_bands;
+} LpfTrialRows;
+
+typedef struct {
+  int index;
+  int64_t sse;
+} LpfTrialBand;
+
+static void copy_y_rows(const YV12_BUFFER_CONFIG *src, YV12_BUFFER_CONFIG *dst,
+                        int row, int num_rows) {
+  int i;
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (src->flags & YV12_FLAG_HIGHBITDEPTH) {
+    const uint16_t *src16 =
+        CONVERT_TO_SHORTPTR(src->y_buffer) + row * src->y_stride;
+    uint16_t *dst16 = CONVERT_TO_SHORTPTR(dst->y_buffer) + row * dst->y_stride;
+    for (i = 0; i < num_rows; ++i) {
+      memcpy(dst16, src16, src->y_width * sizeof(*src16));
+      src16 += src->y_stride;
+      dst16 += dst->y_stride;
+    }
+    return;
+  }
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+  for (i = 0; i < num_rows; ++i) {
+    memcpy(dst->y_buffer + (row + i) * dst->y_stride,
+           src->y_buffer + (row + i) * src->y_stride, src->y_width);
+  }
+}
+
+// Measures the error of the filtered rows of a band and re-instates them
+// unfiltered.
+static int measure_trial_band(void *arg1, void *arg2) {
+  const LpfTrialRows *const rows = (const LpfTrialRows *)arg1;
+  LpfTrialBand *const band = (LpfTrialBand *)arg2;
+  YV12_BUFFER_CONFIG *const frame = rows->frame;
+  // Filtering a superblock row changes up to 8 pixel rows above it, which are
+  // part of the row above unless that one is skipped.
+  const int margin = rows->sb_row_step > 1 ? 8 : 0;
+  int sb_row;
+
+  band->sse = 0;
+  for (sb_row = rows->first_sb_row + band->index * rows->sb_row_step;
+       sb_row < rows->sb_rows; sb_row += rows->num_bands * rows->sb_row_step) {
+    const int top = VPXMAX(sb_row * 64 - margin, 0);
+    const int bottom = VPXMIN((sb_row + 1) * 64, frame->y_height);
+    const int crop_bottom = VPXMIN(bottom, frame->y_crop_height);
+    if (crop_bottom > top) {
+#if CONFIG_VP9_HIGHBITDEPTH
+      if (frame->flags & YV12_FLAG_HIGHBITDEPTH) {
+        band->sse +=
+            vpx_highbd_get_y_sse_rows(rows->sd, frame, top, crop_bottom - top);
+      } else {
+        band->sse += vpx_get_y_sse_rows(rows->sd, frame, top, crop_bottom - top);
+      }
+#else
+      band->sse += vpx_get_y_sse_rows(rows->sd, frame, top, crop_bottom - top);
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+    }
+    copy_y_rows(rows->unfiltered, frame, top, bottom - top);
+  }
+  return 1;
+}
+
+static void filter_sampled_rows(VP9_COMP *const cpi, int filt_level) {
   VP9_COMMON *const cm = &cpi->common;
-  int64_t filt_err;
+  const int mi_row_step = LPF_SAMPLED_ROW_STEP * MI_BLOCK_SIZE;
+  int mi_row, mi_col;
+
+  if (!filt_level) return;
 
-  vp9_build_mask_frame(cm, filt_level, partial_frame);
+  vp9_loop_filter_frame_init(cm, filt_level);
+  for (mi_row = mi_row_step / 2; mi_row < cm->mi_rows; mi_row += mi_row_step) {
+    for (mi_col = 0; mi_col < cm->mi_cols; mi_col += MI_BLOCK_SIZE) {
+      vp9_setup_mask(cm, mi_row, mi_col);
+    }
+  }
 
-  if (cpi->num_workers > 1)
-    vp9_loop_filter_frame_mt(cm->frame_to_show, cm, cpi->td.mb.e_mbd.plane,
-                             filt_level, 1, partial_frame, cpi->workers,
-                             cpi->num_workers, &cpi->lf_row_sync);
-  else
-    vp9_loop_filter_frame(cm->frame_to_show, cm, &cpi->td.mb.e_mbd, filt_level,
-                          1, partial_frame);
+  if (cpi->num_workers > 1) {
+    vp9_task_group_init(&cpi->stage_tasks, NULL);
+    vp9_loop_filter_sampled_rows_tasks(
+        cpi, cm->frame_to_show, filt_level, 1, LPF_SAMPLED_ROW_STEP / 2,
+        LPF_SAMPLED_ROW_STEP, &cpi->stage_tasks);
+    vp9_task_pool_wait(&cpi->task_pool, &cpi->stage_tasks);
+  } else {
+    LFWorkerData lf_data;
+    vp9_loop_filter_data_reset(&lf_data, cm->frame_to_show, cm,
+                               cpi->td.mb.e_mbd.plane);
+    lf_data.y_only = 1;
+    for (mi_row = mi_row_step / 2; mi_row < cm->mi_rows;
+         mi_row += mi_row_step) {
+      lf_data.start = mi_row;
+      lf_data.stop = VPXMIN(mi_row + MI_BLOCK_SIZE, cm->mi_rows);
+      vp9_loop_filter_worker(&lf_data, NULL);
+    }
+  }
+}
 
-#if CONFIG_VP9_HIGHBITDEPTH
-  if (cm->use_highbitdepth) {
-    filt_err = vpx_highbd_get_y_sse(sd, cm->frame_to_show);
+static int64_t try_filter_frame(const YV12_BUFFER_CONFIG *sd,
+                                VP9_COMP *const cpi, int filt_level,
+                                LPF_PICK_METHOD method) {
+  VP9_COMMON *const cm = &cpi->common;
+  LpfTrialRows rows;
+  LpfTrialBand bands[MAX_NUM_THREADS];
+  int64_t filt_err = 0;
+  int i;
+
+  rows.sd = sd;
+  rows.frame = cm->frame_to_show;
+  rows.unfiltered = &cpi->last_frame_uf;
+  rows.sb_rows = mi_cols_aligned_to_sb(cm->mi_rows) >> MI_BLOCK_SIZE_LOG2;
+  rows.first_sb_row = 0;
+  rows.sb_row_step = 1;
+  rows.num_bands = clamp(cpi->num_workers, 1, MAX_NUM_THREADS);
+
+  if (method == LPF_PICK_FROM_SAMPLED_ROWS) {
+    rows.first_sb_row = LPF_SAMPLED_ROW_STEP / 2;
+    rows.sb_row_step = LPF_SAMPLED_ROW_STEP;
+    filter_sampled_rows(cpi, filt_level);
   } else {
-    filt_err = vpx_get_y_sse(sd, cm->frame_to_show);
+    const int partial_frame = method == LPF_PICK_FROM_SUBIMAGE;
+    vp9_build_mask_frame(cm, filt_level, partial_frame);
+    if (cpi->num_workers > 1) {
+      vp9_task_group_init(&cpi->stage_tasks, NULL);
+      vp9_loop_filter_frame_tasks(cpi, cm->frame_to_show, filt_level, 1,
+                                  partial_frame, &cpi->stage_tasks);
+      vp9_task_pool_wait(&cpi->task_pool, &cpi->stage_tasks);
+    } else {
+      vp9_loop_filter_frame(cm->frame_to_show, cm, &cpi->td.mb.e_mbd,
+                            filt_level, 1, partial_frame);
+    }
   }
-#else
-  filt_err = vpx_get_y_sse(sd, cm->frame_to_show);
-#endif  // CONFIG_VP9_HIGHBITDEPTH
 
-  // Re-instate the unfiltered frame
-  vpx_yv12_copy_y(&cpi->last_frame_uf, cm->frame_to_show);
+  // Measure the error and re-instate the unfiltered frame.
+  if (rows.num_bands > 1) {
+    vp9_task_group_init(&cpi->stage_tasks, NULL);
+    for (i = 0; i < rows.num_bands; ++i) {
+      bands[i].index = i;
+      vp9_task_pool_add(&cpi->task_pool, &cpi->stage_tasks, measure_trial_band,
+                        &rows, &bands[i]);
+    }
+    vp9_task_pool_wait(&cpi->task_pool, &cpi->stage_tasks);
+  } else {
+    bands[0].index = 0;
+    measure_trial_band(&rows, &bands[0]);
+  }
+  for (i = 0; i < rows.num_bands; ++i) filt_err += bands[i].sse;
 
   return filt_err;
 }
 
 static int search_filter_level(const YV12_BUFFER_CONFIG *sd, VP9_COMP *cpi,
-                               int partial_frame) {
+                               LPF_PICK_METHOD method) {
   const VP9_COMMON *const cm = &cpi->common;
   const struct loopfilter *const lf = &cm->lf;
   const int min_filter_level = 0;
@@ -99,7 +231,7 @@ static int search_filter_level(const YV12_BUFFER_CONFIG *sd, VP9_COMP *cpi,
   //  Make a copy of the unfiltered / processed recon buffer
   vpx_yv12_copy_y(cm->frame_to_show, &cpi->last_frame_uf);
 
-  best_err = try_filter_frame(sd, cpi, filt_mid, partial_frame);
+  best_err = try_filter_frame(sd, cpi, filt_mid, method);
   filt_best = filt_mid;
   ss_err[filt_mid] = best_err;
 
@@ -119,7 +251,7 @@ static int search_filter_level(const YV12_BUFFER_CONFIG *sd, VP9_COMP *cpi,
     if (filt_direction <= 0 && filt_low != filt_mid) {
       // Get Low filter error score
       if (ss_err[filt_low] < 0) {
-        ss_err[filt_low] = try_filter_frame(sd, cpi, filt_low, partial_frame);
+        ss_err[filt_low] = try_filter_frame(sd, cpi, filt_low, method);
       }
       // If value is close to the best so far then bias towards a lower loop
       // filter value.
@@ -134,7 +266,7 @@ static int search_filter_level(const YV12_BUFFER_CONFIG *sd, VP9_COMP *cpi,
     // Now look at filt_high
     if (filt_direction >= 0 && filt_high != filt_mid) {
       if (ss_err[filt_high] < 0) {
-        ss_err[filt_high] = try_filter_frame(sd, cpi, filt_high, partial_frame);
+        ss_err[filt_high] = try_filter_frame(sd, cpi, filt_high, method);
       }
       // Was it better than the previous best?
       if (ss_err[filt_high] < (best_err - bias)) {
@@ -197,7 +329,11 @@ void vp9_pick_filter_level(const YV12_BUFFER_CONFIG *sd, VP9_COMP *cpi,
     if (cm->frame_type == KEY_FRAME) filt_guess -= 4;
     lf->filter_level = clamp(filt_guess, min_filter_level, max_filter_level);
   } else {
-    lf->filter_level =
-        search_filter_level(sd, cpi, method == LPF_PICK_FROM_SUBIMAGE);
+    // Too few superblock rows to sample.
+    if (method == LPF_PICK_FROM_SAMPLED_ROWS &&
+        cm->mi_rows < 2 * LPF_SAMPLED_ROW_STEP * MI_BLOCK_SIZE) {
+      method = LPF_PICK_FROM_FULL_IMAGE;
+    }
+    lf->filter_level = search_filter_level(sd, cpi, method);
   }
 }
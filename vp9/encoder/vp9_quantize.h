@@ -44,6 +44,11 @@ void vp9_frame_init_quantizer(struct VP9_COMP *cpi);
 
 void vp9_init_plane_quantizers(struct VP9_COMP *cpi, MACROBLOCK *x);
 
+// Like vp9_init_plane_quantizers(), for a frame coded at 'base_qindex' instead
+// of the current one.
+void vp9_init_plane_quantizers_qindex(struct VP9_COMP *cpi, MACROBLOCK *x,
+                                      int base_qindex);
+
 void vp9_init_quantizer(struct VP9_COMP *cpi);
 
 void vp9_set_quantizer(struct VP9_COMP *cm, int q);
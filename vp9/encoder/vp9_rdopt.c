@@ -43,6 +43,7 @@
 #include "vp9/encoder/vp9_ratectrl.h"
 #include "vp9/encoder/vp9_rd.h"
 #include "vp9/encoder/vp9_rdopt.h"
+#include "vp9/encoder/vp9_tpl_model.h"
 
 #define LAST_FRAME_MODE_MASK \
   ((1 << GOLDEN_FRAME) | (1 << ALTREF_FRAME) | (1 << INTRA_FRAME))
@@ -2595,7 +2596,12 @@ static void single_motion_search(VP9_COMP *cpi, MACROBLOCK *x, BLOCK_SIZE bsize,
   assert(pw * ph == lambda << 2);
 #else   // CONFIG_NON_GREEDY_MV
   int sadpb = x->sadperbit16;
+  MV tpl_mv;
+  const int has_tpl_mv =
+      cpi->sf.mv.use_tpl_mv && !getenv("NOTPLMV") &&
+      vp9_get_tpl_mv(cpi, ref, mi_row, mi_col, bsize, &tpl_mv);
 #endif  // CONFIG_NON_GREEDY_MV
+  int tpl_mv_agrees = 0;
 
   pred_mv[0] = x->mbmi_ext->ref_mvs[ref][0].as_mv;
   pred_mv[1] = x->mbmi_ext->ref_mvs[ref][1].as_mv;
@@ -2666,6 +2672,32 @@ static void single_motion_search(VP9_COMP *cpi, MACROBLOCK *x, BLOCK_SIZE bsize,
   mvp_full.col >>= 3;
   mvp_full.row >>= 3;
 
+#if !CONFIG_NON_GREEDY_MV
+  if (has_tpl_mv) {
+    const struct buf_2d *const src = &x->plane[0].src;
+    const struct buf_2d *const pre = &xd->plane[0].pre[0];
+    MV tpl_mv_full = { tpl_mv.row >> 3, tpl_mv.col >> 3 };
+    clamp_mv(&tpl_mv_full, x->mv_limits.col_min, x->mv_limits.col_max,
+             x->mv_limits.row_min, x->mv_limits.row_max);
+    if (abs(tpl_mv_full.row - mvp_full.row) <= 1 &&
+        abs(tpl_mv_full.col - mvp_full.col) <= 1) {
+      // The tpl model found the same motion on the source frames, so only
+      // refine around it.
+      tpl_mv_agrees = 1;
+      step_param = VPXMAX(step_param, MAX_MVSEARCH_STEPS - 3);
+    } else if (cpi->fn_ptr[bsize].sdf(
+                   src->buf, src->stride,
+                   &pre->buf[tpl_mv_full.row * pre->stride + tpl_mv_full.col],
+                   pre->stride) <
+               cpi->fn_ptr[bsize].sdf(
+                   src->buf, src->stride,
+                   &pre->buf[mvp_full.row * pre->stride + mvp_full.col],
+                   pre->stride)) {
+      mvp_full = tpl_mv_full;
+    }
+  }
+#endif  // !CONFIG_NON_GREEDY_MV
+
 #if CONFIG_NON_GREEDY_MV
   bestsme = vp9_full_pixel_diamond_new(cpi, x, bsize, &mvp_full, step_param,
                                        lambda, 1, nb_full_mvs, nb_full_mv_num,
@@ -2676,7 +2708,7 @@ static void single_motion_search(VP9_COMP *cpi, MACROBLOCK *x, BLOCK_SIZE bsize,
       cond_cost_list(cpi, cost_list), &ref_mv, &tmp_mv->as_mv, INT_MAX, 1);
 #endif  // CONFIG_NON_GREEDY_MV
 
-  if (cpi->sf.enhanced_full_pixel_motion_search) {
+  if (cpi->sf.enhanced_full_pixel_motion_search && !tpl_mv_agrees) {
     int i;
     for (i = 0; i < 3; ++i) {
       int this_me;
@@ -232,6 +232,7 @@ static void set_good_speed_feature_framesize_independent(VP9_COMP *cpi,
   sf->less_rectangular_check = 1;
   sf->mv.auto_mv_step_size = 1;
   sf->mv.use_downsampled_sad = 1;
+  sf->mv.use_tpl_mv = 1;
   sf->prune_ref_frame_for_rect_partitions = 1;
   sf->temporal_filter_search_method = NSTEP;
   sf->tx_size_search_breakout = 1;
@@ -353,6 +354,8 @@ static void set_good_speed_feature_framesize_independent(VP9_COMP *cpi,
     }
 
     sf->use_accurate_subpel_search = USE_2_TAPS;
+    sf->lpf_pick = boosted ? LPF_PICK_FROM_FULL_IMAGE
+                           : LPF_PICK_FROM_SAMPLED_ROWS;
   }
 
   if (speed >= 3) {
@@ -938,6 +941,7 @@ void vp9_set_speed_features_framesize_independent(VP9_COMP *cpi, int speed) {
   sf->mv.auto_mv_step_size = 0;
   sf->mv.fullpel_search_step_param = 6;
   sf->mv.use_downsampled_sad = 0;
+  sf->mv.use_tpl_mv = 0;
   sf->comp_inter_joint_search_iter_level = 0;
   sf->tx_size_search_method = USE_FULL_RD;
   sf->use_lp32x32fdct = 0;
@@ -104,6 +104,8 @@ typedef enum {
   LPF_PICK_FROM_FULL_IMAGE,
   // Try a small portion of the image with different values.
   LPF_PICK_FROM_SUBIMAGE,
+  // Try one superblock row in every few with different values.
+  LPF_PICK_FROM_SAMPLED_ROWS,
   // Estimate the level based on quantizer and frame type
   LPF_PICK_FROM_Q,
   // Pick 0 to disable LPF if LPF was enabled last frame
@@ -214,6 +216,11 @@ typedef struct MV_SPEED_FEATURES {
   // Whether to downsample the rows in sad calculation during motion search.
   // This is only active when there are at least 8 rows.
   int use_downsampled_sad;
+
+  // Whether to start the full pel motion search from the motion the tpl model
+  // found for the block, and to only refine around it when it agrees with the
+  // predicted motion.
+  int use_tpl_mv;
 } MV_SPEED_FEATURES;
 
 typedef struct PARTITION_SEARCH_BREAKOUT_THR {
@@ -0,0 +1,238 @@
+/*
+ *  Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "vpx_dsp/vpx_dsp_common.h"
+#include "vpx_mem/vpx_mem.h"
+
+#include "vp9/encoder/vp9_task_pool.h"
+
+static INLINE void pool_lock(VP9TaskPool *pool) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(&pool->mutex);
+#else
+  (void)pool;
+#endif
+}
+
+static INLINE void pool_unlock(VP9TaskPool *pool) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_unlock(&pool->mutex);
+#else
+  (void)pool;
+#endif
+}
+
+// Takes the oldest queued task that is ready into 'task'. Returns 0 if there
+// is none. Must be called with the lock held.
+static int take_task(VP9TaskPool *pool, VP9Task *task) {
+  int i;
+  for (i = pool->first_task; i < pool->num_tasks; ++i) {
+    VP9Task *const queued = &pool->tasks[i];
+    const VP9TaskGroup *const depends_on =
+        queued->hook != NULL ? queued->group->depends_on : NULL;
+    if (queued->hook == NULL ||
+        (depends_on != NULL && depends_on->num_pending > 0)) {
+      continue;
+    }
+    *task = *queued;
+    queued->hook = NULL;
+    while (pool->first_task < pool->num_tasks &&
+           pool->tasks[pool->first_task].hook == NULL) {
+      ++pool->first_task;
+    }
+    if (pool->first_task == pool->num_tasks) {
+      pool->first_task = 0;
+      pool->num_tasks = 0;
+    }
+    return 1;
+  }
+  return 0;
+}
+
+// Runs 'task' without the lock, which must be held when called.
+static void run_task(VP9TaskPool *pool, const VP9Task *task) {
+  VP9TaskGroup *const group = task->group;
+  int ok;
+  pool_unlock(pool);
+  ok = task->hook(task->data1, task->data2);
+  pool_lock(pool);
+  group->had_error |= !ok;
+  if (--group->num_pending == 0) {
+#if CONFIG_MULTITHREAD
+    // The tasks of the groups depending on this one may start now.
+    pthread_cond_broadcast(&pool->task_cond);
+    pthread_cond_broadcast(&pool->done_cond);
+#endif
+  }
+}
+
+#if CONFIG_MULTITHREAD
+static int task_pool_thread_hook(void *arg1, void *unused) {
+  VP9TaskPool *const pool = (VP9TaskPool *)arg1;
+  VP9Task task;
+  (void)unused;
+
+  pool_lock(pool);
+  while (!pool->shutdown) {
+    if (take_task(pool, &task)) {
+      run_task(pool, &task);
+    } else {
+      pthread_cond_wait(&pool->task_cond, &pool->mutex);
+    }
+  }
+  pool_unlock(pool);
+  return 1;
+}
+#endif  // CONFIG_MULTITHREAD
+
+void vp9_task_pool_init(VP9TaskPool *pool,
+                        struct vpx_internal_error_info *error,
+                        int num_threads) {
+  assert(!pool->active);
+  memset(pool, 0, sizeof(*pool));
+  pool->error = error;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_init(&pool->mutex, NULL);
+  pthread_cond_init(&pool->task_cond, NULL);
+  pthread_cond_init(&pool->done_cond, NULL);
+  pool->active = 1;
+
+  if (num_threads > 0) {
+    const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+    int i;
+
+    CHECK_MEM_ERROR(error, pool->workers,
+                    vpx_calloc(num_threads, sizeof(*pool->workers)));
+    for (i = 0; i < num_threads; ++i) {
+      VPxWorker *const worker = &pool->workers[i];
+      winterface->init(worker);
+      worker->thread_name = "vpx enc worker";
+      ++pool->num_threads;
+      if (!winterface->reset(worker)) {
+        vpx_internal_error(error, VPX_CODEC_ERROR,
+                           "Tile encoder thread creation failed");
+      }
+      worker->hook = task_pool_thread_hook;
+      worker->data1 = pool;
+      worker->data2 = NULL;
+      winterface->launch(worker);
+    }
+  }
+#else
+  // Without threads the worker interface runs hooks as they are launched, so
+  // all tasks are run by vp9_task_pool_wait().
+  (void)num_threads;
+  pool->active = 1;
+#endif  // CONFIG_MULTITHREAD
+}
+
+void vp9_task_pool_free(VP9TaskPool *pool) {
+  int i;
+  if (!pool->active) return;
+
+  pool_lock(pool);
+  for (i = pool->first_task; i < pool->num_tasks; ++i) {
+    VP9Task *const task = &pool->tasks[i];
+    if (task->hook != NULL) {
+      task->group->had_error = 1;
+      --task->group->num_pending;
+    }
+  }
+  pool->first_task = 0;
+  pool->num_tasks = 0;
+  pool->shutdown = 1;
+#if CONFIG_MULTITHREAD
+  pthread_cond_broadcast(&pool->task_cond);
+#endif
+  pool_unlock(pool);
+
+  for (i = 0; i < pool->num_threads; ++i) {
+    vpx_get_worker_interface()->end(&pool->workers[i]);
+  }
+  vpx_free(pool->workers);
+  vpx_free(pool->tasks);
+#if CONFIG_MULTITHREAD
+  pthread_mutex_destroy(&pool->mutex);
+  pthread_cond_destroy(&pool->task_cond);
+  pthread_cond_destroy(&pool->done_cond);
+#endif
+  memset(pool, 0, sizeof(*pool));
+}
+
+void vp9_task_group_init(VP9TaskGroup *group, VP9TaskGroup *depends_on) {
+  assert(group->num_pending == 0);
+  assert(depends_on != group);
+  group->had_error = 0;
+  group->depends_on = depends_on;
+}
+
+void vp9_task_pool_add(VP9TaskPool *pool, VP9TaskGroup *group,
+                       VPxWorkerHook hook, void *data1, void *data2) {
+  VP9Task *task;
+  assert(pool->active);
+
+  pool_lock(pool);
+  if (pool->num_tasks == pool->tasks_size) {
+    const int tasks_size = VPXMAX(2 * pool->tasks_size, 16);
+    VP9Task *const tasks =
+        (VP9Task *)vpx_malloc(tasks_size * sizeof(*pool->tasks));
+    if (tasks == NULL) {
+      pool_unlock(pool);
+      vpx_internal_error(pool->error, VPX_CODEC_MEM_ERROR,
+                         "Failed to allocate encoder tasks");
+    }
+    if (pool->num_tasks > 0) {
+      memcpy(tasks, pool->tasks, pool->num_tasks * sizeof(*pool->tasks));
+    }
+    vpx_free(pool->tasks);
+    pool->tasks = tasks;
+    pool->tasks_size = tasks_size;
+  }
+  task = &pool->tasks[pool->num_tasks++];
+  task->hook = hook;
+  task->data1 = data1;
+  task->data2 = data2;
+  task->group = group;
+  ++group->num_pending;
+#if CONFIG_MULTITHREAD
+  pthread_cond_signal(&pool->task_cond);
+#endif
+  pool_unlock(pool);
+}
+
+int vp9_task_pool_wait(VP9TaskPool *pool, VP9TaskGroup *group) {
+  VP9Task task;
+  int had_error;
+  if (!pool->active) {
+    assert(group->num_pending == 0);
+    return !group->had_error;
+  }
+
+  pool_lock(pool);
+  while (group->num_pending > 0) {
+    if (take_task(pool, &task)) {
+      run_task(pool, &task);
+    } else {
+#if CONFIG_MULTITHREAD
+      pthread_cond_wait(&pool->done_cond, &pool->mutex);
+#else
+      // All tasks are queued until they are run here.
+      assert(0);
+      break;
+#endif
+    }
+  }
+  had_error = group->had_error;
+  pool_unlock(pool);
+  return !had_error;
+}
@@ -0,0 +1,98 @@
+/*
+ *  Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef VPX_VP9_ENCODER_VP9_TASK_POOL_H_
+#define VPX_VP9_ENCODER_VP9_TASK_POOL_H_
+
+#include "./vpx_config.h"
+#include "vpx/internal/vpx_codec_internal.h"
+#include "vpx_util/vpx_pthread.h"
+#include "vpx_util/vpx_thread.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Tasks that are waited for together. A group can depend on another one, in
+// which case its tasks only start once all those of the other group are done.
+typedef struct VP9TaskGroup {
+  // Tasks of the group that are queued or running.
+  int num_pending;
+  // Set if a task of the group returned 0.
+  int had_error;
+  struct VP9TaskGroup *depends_on;
+} VP9TaskGroup;
+
+typedef struct VP9Task {
+  VPxWorkerHook hook;  // NULL once the task has been taken
+  void *data1;
+  void *data2;
+  VP9TaskGroup *group;
+} VP9Task;
+
+// Persistent threads that run the tasks of every multi-threaded stage of the
+// encoder, oldest first. Tasks of a group that depends on an unfinished group
+// are skipped until it is done. A task may wait for work of tasks queued
+// before it, as those have been started, but not for later ones.
+//
+// The threads wait between tasks instead of being launched and synced for
+// each stage, and a stage can be queued behind another without the caller
+// waiting for the first one. The caller of vp9_task_pool_wait() runs queued
+// tasks too, so a pool without threads runs them all there.
+typedef struct VP9TaskPool {
+  // Set between vp9_task_pool_init() and vp9_task_pool_free().
+  int active;
+  VPxWorker *workers;
+  int num_threads;
+  struct vpx_internal_error_info *error;
+
+  // Queued tasks are in [first_task, num_tasks).
+  VP9Task *tasks;
+  int tasks_size;
+  int first_task;
+  int num_tasks;
+  int shutdown;
+
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t mutex;
+  // Signaled when tasks are queued or become ready.
+  pthread_cond_t task_cond;
+  // Signaled when a group is done.
+  pthread_cond_t done_cond;
+#endif
+} VP9TaskPool;
+
+// Starts 'num_threads' threads. Errors are reported to 'error'.
+void vp9_task_pool_init(VP9TaskPool *pool,
+                        struct vpx_internal_error_info *error,
+                        int num_threads);
+
+// Stops the threads once their current tasks are done. Tasks that have not
+// started are dropped and flagged as errors in their groups.
+void vp9_task_pool_free(VP9TaskPool *pool);
+
+// Must not be called while the group has pending tasks. The tasks of 'group'
+// do not start while 'depends_on' has pending tasks, so those must be queued
+// first.
+void vp9_task_group_init(VP9TaskGroup *group, VP9TaskGroup *depends_on);
+
+// Queues hook(data1, data2) as a task of 'group'.
+void vp9_task_pool_add(VP9TaskPool *pool, VP9TaskGroup *group,
+                       VPxWorkerHook hook, void *data1, void *data2);
+
+// Runs queued tasks until those of 'group' are done. Returns 0 if one of them
+// failed.
+int vp9_task_pool_wait(VP9TaskPool *pool, VP9TaskGroup *group);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // VPX_VP9_ENCODER_VP9_TASK_POOL_H_
@@ -837,7 +837,7 @@ static uint32_t temporal_filter_find_matching_mb_c(
   // calculation. The start full mv and the search result are stored in
   // ref_mv.
   bestsme = cpi->find_fractional_mv_step(
-      x, ref_mv, &best_ref_mv1, cpi->common.allow_high_precision_mv,
+      x, ref_mv, &best_ref_mv1, cpi->arnr_filter_data.allow_high_precision_mv,
       x->errorperbit, &cpi->fn_ptr[TF_BLOCK], 0, mv_sf->subpel_search_level,
       cond_cost_list(cpi, cost_list), NULL, NULL, &distortion, &sse, NULL, BW,
       BH, USE_8_TAPS_SHARP);
@@ -865,10 +865,11 @@ static uint32_t temporal_filter_find_matching_mb_c(
       x->mv_limits = tmp_mv_limits;
 
       blk_bestsme[k] = cpi->find_fractional_mv_step(
-          x, &blk_mvs[k], &best_ref_mv1, cpi->common.allow_high_precision_mv,
-          x->errorperbit, &cpi->fn_ptr[TF_SUB_BLOCK], 0,
-          mv_sf->subpel_search_level, cond_cost_list(cpi, cost_list), NULL,
-          NULL, &distortion, &sse, NULL, SUB_BW, SUB_BH, USE_8_TAPS_SHARP);
+          x, &blk_mvs[k], &best_ref_mv1,
+          cpi->arnr_filter_data.allow_high_precision_mv, x->errorperbit,
+          &cpi->fn_ptr[TF_SUB_BLOCK], 0, mv_sf->subpel_search_level,
+          cond_cost_list(cpi, cost_list), NULL, NULL, &distortion, &sse, NULL,
+          SUB_BW, SUB_BH, USE_8_TAPS_SHARP);
       k++;
     }
   }
@@ -1343,7 +1344,11 @@ static void adjust_arnr_filter(VP9_COMP *cpi, int distance, int group_boost,
   *arnr_strength = strength;
 }
 
-void vp9_temporal_filter(VP9_COMP *cpi, int distance) {
+// Sets up cpi->arnr_filter_data to filter the frame 'distance' frames ahead in
+// the lookahead into 'dst'.
+static void temporal_filter_setup_frames(VP9_COMP *cpi, int distance,
+                                         int allow_high_precision_mv,
+                                         YV12_BUFFER_CONFIG *dst) {
   VP9_COMMON *const cm = &cpi->common;
   RATE_CONTROL *const rc = &cpi->rc;
   MACROBLOCKD *const xd = &cpi->td.mb.e_mbd;
@@ -1356,7 +1361,6 @@ void vp9_temporal_filter(VP9_COMP *cpi, int distance) {
   int frames_to_blur_forward;
   struct scale_factors *sf = &arnr_filter_data->sf;
   YV12_BUFFER_CONFIG **frames = arnr_filter_data->frames;
-  int rdmult;
 
   // Apply context specific adjustments to the arnr filter parameters.
   adjust_arnr_filter(cpi, distance, rc->gfu_boost, &frames_to_blur,
@@ -1367,7 +1371,8 @@ void vp9_temporal_filter(VP9_COMP *cpi, int distance) {
   arnr_filter_data->strength = strength;
   arnr_filter_data->frame_count = frames_to_blur;
   arnr_filter_data->alt_ref_index = frames_to_blur_backward;
-  arnr_filter_data->dst = &cpi->tf_buffer;
+  arnr_filter_data->allow_high_precision_mv = allow_high_precision_mv;
+  arnr_filter_data->dst = dst;
 
   // Setup frame pointers, NULL indicates frame not included in filter.
   for (frame = 0; frame < frames_to_blur; ++frame) {
@@ -1377,11 +1382,6 @@ void vp9_temporal_filter(VP9_COMP *cpi, int distance) {
     frames[frames_to_blur - 1 - frame] = &buf->img;
   }
 
-  YV12_BUFFER_CONFIG *f = frames[arnr_filter_data->alt_ref_index];
-  xd->cur_buf = f;
-  xd->plane[1].subsampling_y = f->subsampling_y;
-  xd->plane[1].subsampling_x = f->subsampling_x;
-
   if (frames_to_blur > 0) {
     // Setup scaling factors. Scaling on each of the arnr frames is not
     // supported.
@@ -1440,14 +1440,141 @@ void vp9_temporal_filter(VP9_COMP *cpi, int distance) {
 #endif  // CONFIG_VP9_HIGHBITDEPTH
     }
   }
+}
+
+// Sets up the motion search of 'x' for the frames of cpi->arnr_filter_data.
+static void temporal_filter_setup_search(VP9_COMP *cpi, MACROBLOCK *x,
+                                         const YV12_BUFFER_CONFIG *f) {
+  MACROBLOCKD *const xd = &x->e_mbd;
+  int rdmult;
+
+  xd->cur_buf = f;
+  xd->plane[1].subsampling_y = f->subsampling_y;
+  xd->plane[1].subsampling_x = f->subsampling_x;
+
+  if (cpi->arnr_filter_data.allow_high_precision_mv) {
+    x->mvcost = x->nmvcost_hp;
+    x->mvsadcost = x->nmvsadcost_hp;
+  } else {
+    x->mvcost = x->nmvcost;
+    x->mvsadcost = x->nmvsadcost;
+  }
 
   // Initialize errorperbit and sabperbit.
   rdmult = vp9_compute_rd_mult_based_on_qindex(cpi, ARNR_FILT_QINDEX);
-  set_error_per_bit(&cpi->td.mb, rdmult);
-  vp9_initialize_me_consts(cpi, &cpi->td.mb, ARNR_FILT_QINDEX);
+  set_error_per_bit(x, rdmult);
+  vp9_initialize_me_consts(cpi, x, ARNR_FILT_QINDEX);
+}
+
+// Returns 1 if the filtering started by vp9_temporal_filter_start_next() was
+// set up as cpi->arnr_filter_data and cpi->td.mb are now for 'distance'.
+static int next_filter_matches(const VP9_COMP *cpi, int distance) {
+  const ARNRNextFilter *const next = &cpi->arnr_next;
+  const ARNRFilterData *const data = &cpi->arnr_filter_data;
+  const MACROBLOCK *const x = &cpi->td.mb;
+  int frame;
+
+  if (next->distance != distance || next->data.strength != data->strength ||
+      next->data.frame_count != data->frame_count ||
+      next->data.alt_ref_index != data->alt_ref_index ||
+      next->data.allow_high_precision_mv != data->allow_high_precision_mv ||
+      next->x.errorperbit != x->errorperbit ||
+      next->x.sadperbit16 != x->sadperbit16 ||
+      next->x.sadperbit4 != x->sadperbit4) {
+    return 0;
+  }
+  for (frame = 0; frame < data->frame_count; ++frame) {
+    if (next->data.frames[frame] != data->frames[frame]) return 0;
+  }
+  return 1;
+}
+
+void vp9_temporal_filter(VP9_COMP *cpi, int distance) {
+  ARNRNextFilter *const next = &cpi->arnr_next;
+  const ARNRFilterData *const arnr_filter_data = &cpi->arnr_filter_data;
+
+  temporal_filter_setup_frames(cpi, distance,
+                               cpi->common.allow_high_precision_mv,
+                               &cpi->tf_buffer);
+  temporal_filter_setup_search(
+      cpi, &cpi->td.mb, arnr_filter_data->frames[arnr_filter_data->alt_ref_index]);
+
+  if (next->done && next_filter_matches(cpi, distance)) {
+    // The frame was filtered while the previous one was coded.
+    const YV12_BUFFER_CONFIG tf_buffer = cpi->tf_buffer;
+    cpi->tf_buffer = next->buffer;
+    next->buffer = tf_buffer;
+    next->done = 0;
+    return;
+  }
+  next->done = 0;
 
   if (!cpi->row_mt)
     temporal_filter_iterate_c(cpi);
   else
     vp9_temporal_filter_row_mt(cpi);
 }
+
+void vp9_temporal_filter_start_next(VP9_COMP *cpi, int distance,
+                                    int allow_high_precision_mv) {
+  VP9_COMMON *const cm = &cpi->common;
+  ARNRNextFilter *const next = &cpi->arnr_next;
+  const ARNRFilterData *const arnr_filter_data = &cpi->arnr_filter_data;
+  const int refresh_golden_frame = cpi->refresh_golden_frame;
+  const int refresh_alt_ref_frame = cpi->refresh_alt_ref_frame;
+  const YV12_BUFFER_CONFIG *f;
+  int i;
+
+  assert(!next->pending && !cpi->use_svc);
+  next->done = 0;
+
+  // The frames up to the ARF must be in the lookahead, and are checked for a
+  // forced key frame as vp9_get_compressed_data() does.
+  for (i = 0; i <= distance; ++i) {
+    const struct lookahead_entry *const e =
+        vp9_lookahead_peek(cpi->lookahead, i);
+    if (e == NULL || e->flags == VPX_EFLAG_FORCE_KF) return;
+  }
+
+  if (vpx_realloc_frame_buffer(&next->buffer, cpi->tf_buffer.y_crop_width,
+                               cpi->tf_buffer.y_crop_height, cm->subsampling_x,
+                               cm->subsampling_y,
+#if CONFIG_VP9_HIGHBITDEPTH
+                               cm->use_highbitdepth,
+#endif
+                               VP9_ENC_BORDER_IN_PIXELS, cm->byte_alignment,
+                               NULL, NULL, NULL))
+    vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
+                       "Failed to allocate temporal filter buffer");
+
+  temporal_filter_setup_frames(cpi, distance, allow_high_precision_mv,
+                               &next->buffer);
+  f = arnr_filter_data->frames[arnr_filter_data->alt_ref_index];
+
+  // The rate multiplier is computed with the reference updates the next frame
+  // starts from.
+  cpi->refresh_golden_frame = 0;
+  cpi->refresh_alt_ref_frame = 0;
+  next->x = cpi->td.mb;
+  temporal_filter_setup_search(cpi, &next->x, f);
+  cpi->refresh_golden_frame = refresh_golden_frame;
+  cpi->refresh_alt_ref_frame = refresh_alt_ref_frame;
+
+  next->distance = distance;
+  next->data = *arnr_filter_data;
+  next->num_rows = (f->y_crop_height + BH - 1) >> BH_LOG2;
+  next->pending = 1;
+  vp9_temporal_filter_rows_start(cpi);
+}
+
+void vp9_temporal_filter_wait_next(VP9_COMP *cpi) {
+  ARNRNextFilter *const next = &cpi->arnr_next;
+  next->done =
+      next->pending && vp9_task_pool_wait(&cpi->task_pool, &next->tasks);
+  next->pending = 0;
+}
+
+void vp9_temporal_filter_cancel_next(VP9_COMP *cpi) {
+  vp9_temporal_filter_wait_next(cpi);
+  cpi->arnr_next.done = 0;
+}
@@ -60,6 +60,20 @@ DECLARE_ALIGNED(256, static const InterpKernel12,
 void vp9_temporal_filter_init(void);
 void vp9_temporal_filter(struct VP9_COMP *cpi, int distance);
 
+// Starts filtering the ARF 'distance' frames ahead in the lookahead on the
+// encoder threads, as vp9_temporal_filter() would once the current frame is
+// coded. vp9_temporal_filter() then uses the result if its parameters turn
+// out the same.
+void vp9_temporal_filter_start_next(struct VP9_COMP *cpi, int distance,
+                                    int allow_high_precision_mv);
+
+// Waits for the filtering started by vp9_temporal_filter_start_next(), if
+// any, for use by the current vp9_get_compressed_data() call.
+void vp9_temporal_filter_wait_next(struct VP9_COMP *cpi);
+
+// Like vp9_temporal_filter_wait_next(), but drops the result.
+void vp9_temporal_filter_cancel_next(struct VP9_COMP *cpi);
+
 void vp9_temporal_filter_iterate_row_c(struct VP9_COMP *cpi,
                                        struct ThreadData *td, int mb_row,
                                        int mb_col_start, int mb_col_end);
@@ -18,6 +18,7 @@
 #include "vp9/common/vp9_reconintra.h"
 #include "vp9/common/vp9_scan.h"
 #include "vp9/encoder/vp9_encoder.h"
+#include "vp9/encoder/vp9_ethread.h"
 #include "vp9/encoder/vp9_ext_ratectrl.h"
 #include "vp9/encoder/vp9_firstpass.h"
 #include "vp9/encoder/vp9_ratectrl.h"
@@ -26,6 +27,21 @@
 #include "vpx/vpx_codec.h"
 #include "vpx/vpx_ext_ratectrl.h"
 
+// Returns the display order of the frame being encoded.
+static int get_source_frame_index(const VP9_COMP *cpi) {
+  const GF_GROUP *const gf_group = &cpi->twopass.gf_group;
+  return cpi->common.current_video_frame +
+         gf_group->arf_src_offset[gf_group->index];
+}
+
+// Returns the display order of the frame held by reference ref_frame.
+static int get_ref_frame_index(const VP9_COMP *cpi,
+                               MV_REFERENCE_FRAME ref_frame) {
+  const RefCntBuffer *const buf =
+      get_ref_cnt_buffer(&cpi->common, get_ref_frame_buf_idx(cpi, ref_frame));
+  return buf != NULL ? buf->frame_index : -1;
+}
+
 static int init_gop_frames_rc(VP9_COMP *cpi, GF_PICTURE *gf_picture,
                               const GF_GROUP *gf_group, int *tpl_group_frames) {
   VP9_COMMON *cm = &cpi->common;
@@ -81,6 +97,10 @@ static int init_gop_frames_rc(VP9_COMP *cpi, GF_PICTURE *gf_picture,
           &cm->buffer_pool
                ->frame_bufs[cm->ref_frame_map[gf_group->update_ref_idx[0]]]
                .buf;
+      gf_picture[0].frame_index =
+          cm->buffer_pool
+              ->frame_bufs[cm->ref_frame_map[gf_group->update_ref_idx[0]]]
+              .frame_index;
       ref_table[gf_group->update_ref_idx[0]] = 0;
 
       for (i = 0; i < 3; ++i) gf_picture[0].ref_frame[i] = -REFS_PER_FRAME;
@@ -90,6 +110,8 @@ static int init_gop_frames_rc(VP9_COMP *cpi, GF_PICTURE *gf_picture,
         if (cm->ref_frame_map[i] != -1) {
           gf_picture[-i].frame =
               &cm->buffer_pool->frame_bufs[cm->ref_frame_map[i]].buf;
+          gf_picture[-i].frame_index =
+              cm->buffer_pool->frame_bufs[cm->ref_frame_map[i]].frame_index;
           ref_table[i] = -i;
         } else {
           ref_table[i] = -REFS_PER_FRAME;
@@ -103,6 +125,7 @@ static int init_gop_frames_rc(VP9_COMP *cpi, GF_PICTURE *gf_picture,
 
     // Initialize base layer ARF frame
     gf_picture[1].frame = cpi->Source;
+    gf_picture[1].frame_index = get_source_frame_index(cpi);
     for (i = 0; i < 3; ++i) gf_picture[1].ref_frame[i] = ref_table[i];
     gf_picture[1].update_type = gf_group->update_type[1];
     ref_table[gf_group->update_ref_idx[1]] = 1;
@@ -114,6 +137,7 @@ static int init_gop_frames_rc(VP9_COMP *cpi, GF_PICTURE *gf_picture,
       // This is the only frame in ref buffer. We need it to be on
       // gf_picture[0].
       gf_picture[0].frame = cpi->Source;
+      gf_picture[0].frame_index = get_source_frame_index(cpi);
       for (i = 0; i < 3; ++i) gf_picture[0].ref_frame[i] = -REFS_PER_FRAME;
       gf_picture[0].update_type = gf_group->update_type[0];
 
@@ -125,6 +149,8 @@ static int init_gop_frames_rc(VP9_COMP *cpi, GF_PICTURE *gf_picture,
         if (cm->ref_frame_map[i] != -1) {
           gf_picture[-i].frame =
               &cm->buffer_pool->frame_bufs[cm->ref_frame_map[i]].buf;
+          gf_picture[-i].frame_index =
+              cm->buffer_pool->frame_bufs[cm->ref_frame_map[i]].frame_index;
           ref_table[i] = -i;
         } else {
           ref_table[i] = -REFS_PER_FRAME;
@@ -157,6 +183,7 @@ static int init_gop_frames_rc(VP9_COMP *cpi, GF_PICTURE *gf_picture,
     if (buf == NULL) break;
 
     gf_picture[frame_idx].frame = &buf->img;
+    gf_picture[frame_idx].frame_index = buf->show_idx;
     for (i = 0; i < 3; ++i) {
       gf_picture[frame_idx].ref_frame[i] = ref_table[i];
     }
@@ -201,6 +228,7 @@ static int init_gop_frames_rc(VP9_COMP *cpi, GF_PICTURE *gf_picture,
     cpi->tpl_stats[frame_idx].base_qindex = pframe_qindex;
 
     gf_picture[frame_idx].frame = &buf->img;
+    gf_picture[frame_idx].frame_index = buf->show_idx;
     gf_picture[frame_idx].ref_frame[0] = gf_picture[lst_index].ref_frame[0];
     gf_picture[frame_idx].ref_frame[1] = gf_picture[lst_index].ref_frame[1];
     gf_picture[frame_idx].ref_frame[2] = gf_picture[lst_index].ref_frame[2];
@@ -283,16 +311,20 @@ static int init_gop_frames(VP9_COMP *cpi, GF_PICTURE *gf_picture,
 
   // Initialize Golden reference frame.
   gf_picture[0].frame = get_ref_frame_buffer(cpi, GOLDEN_FRAME);
+  gf_picture[0].frame_index = get_ref_frame_index(cpi, GOLDEN_FRAME);
   for (i = 0; i < 3; ++i) gf_picture[0].ref_frame[i] = -REFS_PER_FRAME;
   gf_picture[0].update_type = gf_group->update_type[0];
   gld_index = 0;
   ++*tpl_group_frames;
 
   gf_picture[-1].frame = get_ref_frame_buffer(cpi, LAST_FRAME);
+  gf_picture[-1].frame_index = get_ref_frame_index(cpi, LAST_FRAME);
   gf_picture[-2].frame = get_ref_frame_buffer(cpi, ALTREF_FRAME);
+  gf_picture[-2].frame_index = get_ref_frame_index(cpi, ALTREF_FRAME);
 
   // Initialize base layer ARF frame
   gf_picture[1].frame = cpi->Source;
+  gf_picture[1].frame_index = get_source_frame_index(cpi);
   gf_picture[1].ref_frame[0] = gld_index;
   gf_picture[1].ref_frame[1] = lst_index;
   gf_picture[1].ref_frame[2] = alt_index;
@@ -309,6 +341,7 @@ static int init_gop_frames(VP9_COMP *cpi, GF_PICTURE *gf_picture,
     if (buf == NULL) break;
 
     gf_picture[frame_idx].frame = &buf->img;
+    gf_picture[frame_idx].frame_index = buf->show_idx;
     gf_picture[frame_idx].ref_frame[0] = gld_index;
     gf_picture[frame_idx].ref_frame[1] = lst_index;
     gf_picture[frame_idx].ref_frame[2] = alt_index;
@@ -356,6 +389,7 @@ static int init_gop_frames(VP9_COMP *cpi, GF_PICTURE *gf_picture,
     cpi->tpl_stats[frame_idx].base_qindex = pframe_qindex;
 
     gf_picture[frame_idx].frame = &buf->img;
+    gf_picture[frame_idx].frame_index = buf->show_idx;
     gf_picture[frame_idx].ref_frame[0] = gld_index;
     gf_picture[frame_idx].ref_frame[1] = lst_index;
     gf_picture[frame_idx].ref_frame[2] = alt_index;
@@ -492,11 +526,16 @@ static uint32_t sub_pixel_motion_search(VP9_COMP *cpi, ThreadData *td,
 }
 
 #else  // CONFIG_NON_GREEDY_MV
+// Steps the search skips when it starts from the first pass motion.
+#define FP_MV_STEP_PARAM_OFFSET 1
+
+// fp_mv, if not NULL, is the first pass motion of the block. The search starts
+// from it instead of from zero motion when it predicts better.
 static uint32_t motion_compensated_prediction(VP9_COMP *cpi, ThreadData *td,
                                               uint8_t *cur_frame_buf,
                                               uint8_t *ref_frame_buf,
                                               int stride, BLOCK_SIZE bsize,
-                                              MV *mv) {
+                                              const MV *fp_mv, MV *mv) {
   MACROBLOCK *const x = &td->mb;
   MACROBLOCKD *const xd = &x->e_mbd;
   MV_SPEED_FEATURES *const mv_sf = &cpi->sf.mv;
@@ -526,6 +565,21 @@ static uint32_t motion_compensated_prediction(VP9_COMP *cpi, ThreadData *td,
 
   vp9_set_mv_search_range(&x->mv_limits, &best_ref_mv1);
 
+  if (fp_mv != NULL) {
+    const vp9_variance_fn_ptr_t *const fn_ptr = &cpi->fn_ptr[bsize];
+    MV fp_mv_full = { fp_mv->row >> 3, fp_mv->col >> 3 };
+    clamp_mv(&fp_mv_full, x->mv_limits.col_min, x->mv_limits.col_max,
+             x->mv_limits.row_min, x->mv_limits.row_max);
+    if (fn_ptr->sdf(cur_frame_buf, stride,
+                    ref_frame_buf + fp_mv_full.row * stride + fp_mv_full.col,
+                    stride) < fn_ptr->sdf(cur_frame_buf, stride, ref_frame_buf,
+                                          stride)) {
+      best_ref_mv1_full = fp_mv_full;
+      step_param = VPXMIN(step_param + FP_MV_STEP_PARAM_OFFSET,
+                          MAX_MVSEARCH_STEPS - 2);
+    }
+  }
+
   vp9_full_pixel_search(cpi, x, bsize, &best_ref_mv1_full, step_param,
                         search_method, sadpb, cond_cost_list(cpi, cost_list),
                         &best_ref_mv1, mv, 0, 0);
@@ -795,17 +849,20 @@ static int rate_estimator(const tran_low_t *qcoeff, int eob, TX_SIZE tx_size) {
   return (rate_cost << VP9_PROB_COST_SHIFT);
 }
 
-static void mode_estimation(VP9_COMP *cpi, MACROBLOCK *x, MACROBLOCKD *xd,
-                            struct scale_factors *sf, GF_PICTURE *gf_picture,
-                            int frame_idx, TplDepFrame *tpl_frame,
-                            int16_t *src_diff, tran_low_t *coeff,
-                            tran_low_t *qcoeff, tran_low_t *dqcoeff, int mi_row,
-                            int mi_col, BLOCK_SIZE bsize, TX_SIZE tx_size,
-                            YV12_BUFFER_CONFIG *ref_frame[], uint8_t *predictor,
-                            int64_t *recon_error, int64_t *rate_cost,
-                            int64_t *sse, int *ref_frame_idx) {
+static void mode_estimation(VP9_COMP *cpi, ThreadData *td,
+                            const struct scale_factors *sf,
+                            GF_PICTURE *gf_picture, int frame_idx,
+                            TplDepFrame *tpl_frame, int16_t *src_diff,
+                            tran_low_t *coeff, tran_low_t *qcoeff,
+                            tran_low_t *dqcoeff, int mi_row, int mi_col,
+                            BLOCK_SIZE bsize, TX_SIZE tx_size,
+                            YV12_BUFFER_CONFIG *const ref_frame[],
+                            uint8_t *predictor, int64_t *recon_error,
+                            int64_t *rate_cost, int64_t *sse,
+                            int *ref_frame_idx) {
   VP9_COMMON *cm = &cpi->common;
-  ThreadData *td = &cpi->td;
+  MACROBLOCK *const x = &td->mb;
+  MACROBLOCKD *const xd = &x->e_mbd;
 
   const int bw = 4 << b_width_log2_lookup[bsize];
   const int bh = 4 << b_height_log2_lookup[bsize];
@@ -882,6 +939,7 @@ static void mode_estimation(VP9_COMP *cpi, MACROBLOCK *x, MACROBLOCKD *xd,
 #if CONFIG_NON_GREEDY_MV
     MotionField *motion_field;
 #endif
+    tpl_stats->ref_mv[rf_idx].as_int = INVALID_MV;
     if (ref_frame[rf_idx] == NULL) continue;
 
 #if CONFIG_NON_GREEDY_MV
@@ -890,9 +948,23 @@ static void mode_estimation(VP9_COMP *cpi, MACROBLOCK *x, MACROBLOCKD *xd,
         &cpi->motion_field_info, frame_idx, rf_idx, bsize);
     mv = vp9_motion_field_mi_get_mv(motion_field, mi_row, mi_col);
 #else
-    motion_compensated_prediction(cpi, td, xd->cur_buf->y_buffer + mb_y_offset,
-                                  ref_frame[rf_idx]->y_buffer + mb_y_offset,
-                                  xd->cur_buf->y_stride, bsize, &mv.as_mv);
+    {
+      MV fp_mv;
+      int has_fp_mv = 0;
+#if !CONFIG_REALTIME_ONLY
+      if (cpi->twopass.mb_mvs_in != NULL) {
+        const GF_PICTURE *const ref_picture =
+            &gf_picture[gf_picture[frame_idx].ref_frame[rf_idx]];
+        has_fp_mv = vp9_get_first_pass_mv(
+            cpi, gf_picture[frame_idx].frame_index, ref_picture->frame_index,
+            mi_row, mi_col, bsize, &fp_mv);
+      }
+#endif  // !CONFIG_REALTIME_ONLY
+      motion_compensated_prediction(
+          cpi, td, xd->cur_buf->y_buffer + mb_y_offset,
+          ref_frame[rf_idx]->y_buffer + mb_y_offset, xd->cur_buf->y_stride,
+          bsize, has_fp_mv ? &fp_mv : NULL, &mv.as_mv);
+    }
 #endif
 
 #if CONFIG_VP9_HIGHBITDEPTH
@@ -930,6 +1002,7 @@ static void mode_estimation(VP9_COMP *cpi, MACROBLOCK *x, MACROBLOCKD *xd,
     inter_cost = vpx_satd(coeff, pix_num);
 #endif
 
+    tpl_stats->ref_mv[rf_idx].as_int = mv.as_int;
     if (inter_cost < best_inter_cost) {
       uint16_t eob = 0;
       best_rf_idx = rf_idx;
@@ -1364,62 +1437,46 @@ static void build_motion_field(
 }
 #endif  // CONFIG_NON_GREEDY_MV
 
-static void mc_flow_dispenser(VP9_COMP *cpi, GF_PICTURE *gf_picture,
-                              int frame_idx, BLOCK_SIZE bsize) {
+// Sets up the estimation of the blocks of frame 'frame_idx' into 'frame', and
+// cpi->td for it.
+static void mc_flow_dispenser_init(VP9_COMP *cpi, GF_PICTURE *gf_picture,
+                                   int frame_idx, BLOCK_SIZE bsize,
+                                   TplEstimateFrame *frame) {
   TplDepFrame *tpl_frame = &cpi->tpl_stats[frame_idx];
   VpxTplFrameStats *tpl_frame_stats_before_propagation =
       &cpi->tpl_gop_stats.frame_stats_list[frame_idx];
   YV12_BUFFER_CONFIG *this_frame = gf_picture[frame_idx].frame;
-  YV12_BUFFER_CONFIG *ref_frame[MAX_INTER_REF_FRAMES] = { NULL, NULL, NULL };
 
   VP9_COMMON *cm = &cpi->common;
-  struct scale_factors sf;
   int rdmult, idx;
   ThreadData *td = &cpi->td;
   MACROBLOCK *x = &td->mb;
   MACROBLOCKD *xd = &x->e_mbd;
-  int mi_row, mi_col;
-
-#if CONFIG_VP9_HIGHBITDEPTH
-  DECLARE_ALIGNED(16, uint16_t, predictor16[32 * 32 * 3]);
-  DECLARE_ALIGNED(16, uint8_t, predictor8[32 * 32 * 3]);
-  uint8_t *predictor;
-#else
-  DECLARE_ALIGNED(16, uint8_t, predictor[32 * 32 * 3]);
-#endif
-  DECLARE_ALIGNED(16, int16_t, src_diff[32 * 32]);
-  DECLARE_ALIGNED(16, tran_low_t, coeff[32 * 32]);
-  DECLARE_ALIGNED(16, tran_low_t, qcoeff[32 * 32]);
-  DECLARE_ALIGNED(16, tran_low_t, dqcoeff[32 * 32]);
-
-  const TX_SIZE tx_size = max_txsize_lookup[bsize];
-  const int mi_height = num_8x8_blocks_high_lookup[bsize];
-  const int mi_width = num_8x8_blocks_wide_lookup[bsize];
 
+  frame->frame_idx = frame_idx;
   tpl_frame_stats_before_propagation->frame_width = cm->width;
   tpl_frame_stats_before_propagation->frame_height = cm->height;
   // Setup scaling factor
 #if CONFIG_VP9_HIGHBITDEPTH
   vp9_setup_scale_factors_for_frame(
-      &sf, this_frame->y_crop_width, this_frame->y_crop_height,
+      &frame->sf, this_frame->y_crop_width, this_frame->y_crop_height,
       this_frame->y_crop_width, this_frame->y_crop_height,
       cpi->common.use_highbitdepth);
-
-  if (xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH)
-    predictor = CONVERT_TO_BYTEPTR(predictor16);
-  else
-    predictor = predictor8;
 #else
   vp9_setup_scale_factors_for_frame(
-      &sf, this_frame->y_crop_width, this_frame->y_crop_height,
+      &frame->sf, this_frame->y_crop_width, this_frame->y_crop_height,
       this_frame->y_crop_width, this_frame->y_crop_height);
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 
   // Prepare reference frame pointers. If any reference frame slot is
   // unavailable, the pointer will be set to Null.
+  tpl_frame->frame_index = gf_picture[frame_idx].frame_index;
   for (idx = 0; idx < MAX_INTER_REF_FRAMES; ++idx) {
     int rf_idx = gf_picture[frame_idx].ref_frame[idx];
-    if (rf_idx != -REFS_PER_FRAME) ref_frame[idx] = gf_picture[rf_idx].frame;
+    frame->ref_frame[idx] =
+        (rf_idx != -REFS_PER_FRAME) ? gf_picture[rf_idx].frame : NULL;
+    tpl_frame->ref_frame_index[idx] =
+        frame->ref_frame[idx] != NULL ? gf_picture[rf_idx].frame_index : -1;
   }
 
   xd->mi = cm->mi_grid_visible;
@@ -1443,7 +1500,7 @@ static void mc_flow_dispenser(VP9_COMP *cpi, GF_PICTURE *gf_picture,
     for (square_block_idx = 0; square_block_idx < SQUARE_BLOCK_SIZES;
          ++square_block_idx) {
       BLOCK_SIZE square_bsize = square_block_idx_to_bsize(square_block_idx);
-      build_motion_field(cpi, frame_idx, ref_frame, square_bsize);
+      build_motion_field(cpi, frame_idx, frame->ref_frame, square_bsize);
     }
     for (rf_idx = 0; rf_idx < MAX_INTER_REF_FRAMES; ++rf_idx) {
       int ref_frame_idx = gf_picture[frame_idx].ref_frame[rf_idx];
@@ -1455,28 +1512,98 @@ static void mc_flow_dispenser(VP9_COMP *cpi, GF_PICTURE *gf_picture,
       }
     }
   }
+#else
+  (void)bsize;
 #endif  // CONFIG_NON_GREEDY_MV
+}
+
+void vp9_tpl_estimate_rows(VP9_COMP *cpi, ThreadData *td,
+                           TplEstimateJobs *jobs) {
+  const VP9_COMMON *const cm = &cpi->common;
+  MACROBLOCK *const x = &td->mb;
+  MACROBLOCKD *const xd = &x->e_mbd;
+  const BLOCK_SIZE bsize = jobs->bsize;
+  const TX_SIZE tx_size = max_txsize_lookup[bsize];
+  const int mi_height = num_8x8_blocks_high_lookup[bsize];
+  const int mi_width = num_8x8_blocks_wide_lookup[bsize];
+  const int num_jobs = jobs->num_frames * jobs->rows_per_frame;
+  // mode_estimation() writes the mode of each block to a MODE_INFO of this
+  // thread.
+  MODE_INFO mi = *cm->mi;
+  MODE_INFO *mi_ptr = &mi;
+  const TplEstimateFrame *frame = NULL;
+  int job;
+
+#if CONFIG_VP9_HIGHBITDEPTH
+  DECLARE_ALIGNED(16, uint16_t, predictor16[32 * 32 * 3]);
+  DECLARE_ALIGNED(16, uint8_t, predictor8[32 * 32 * 3]);
+  uint8_t *predictor;
+#else
+  DECLARE_ALIGNED(16, uint8_t, predictor[32 * 32 * 3]);
+#endif
+  DECLARE_ALIGNED(16, int16_t, src_diff[32 * 32]);
+  DECLARE_ALIGNED(16, tran_low_t, coeff[32 * 32]);
+  DECLARE_ALIGNED(16, tran_low_t, qcoeff[32 * 32]);
+  DECLARE_ALIGNED(16, tran_low_t, dqcoeff[32 * 32]);
+
+  xd->mi = &mi_ptr;
+
+  // Jobs are the block rows of jobs->frames in order.
+  while ((job = vpx_atomic_fetch_add(&jobs->next_job, 1)) < num_jobs) {
+    const int mi_row = (job % jobs->rows_per_frame) * mi_height;
+    TplDepFrame *tpl_frame;
+    VpxTplFrameStats *tpl_frame_stats_before_propagation;
+    int mi_col;
+
+    if (frame != &jobs->frames[job / jobs->rows_per_frame]) {
+      frame = &jobs->frames[job / jobs->rows_per_frame];
+      xd->cur_buf = jobs->gf_picture[frame->frame_idx].frame;
+      vp9_init_plane_quantizers_qindex(
+          cpi, x, cpi->tpl_stats[frame->frame_idx].base_qindex);
+    }
+    tpl_frame = &cpi->tpl_stats[frame->frame_idx];
+    tpl_frame_stats_before_propagation =
+        &cpi->tpl_gop_stats.frame_stats_list[frame->frame_idx];
+#if CONFIG_VP9_HIGHBITDEPTH
+    if (xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH)
+      predictor = CONVERT_TO_BYTEPTR(predictor16);
+    else
+      predictor = predictor8;
+#endif
 
-  for (mi_row = 0; mi_row < cm->mi_rows; mi_row += mi_height) {
     for (mi_col = 0; mi_col < cm->mi_cols; mi_col += mi_width) {
       int64_t recon_error = 0;
       int64_t rate_cost = 0;
       int64_t sse = 0;
       // Ref frame index in the ref frame buffer.
       int ref_frame_idx = -1;
-      mode_estimation(cpi, x, xd, &sf, gf_picture, frame_idx, tpl_frame,
-                      src_diff, coeff, qcoeff, dqcoeff, mi_row, mi_col, bsize,
-                      tx_size, ref_frame, predictor, &recon_error, &rate_cost,
-                      &sse, &ref_frame_idx);
-      // Motion flow dependency dispenser.
-      tpl_model_store(tpl_frame->tpl_stats_ptr, mi_row, mi_col, bsize,
-                      tpl_frame->stride);
+      mode_estimation(cpi, td, &frame->sf, jobs->gf_picture, frame->frame_idx,
+                      tpl_frame, src_diff, coeff, qcoeff, dqcoeff, mi_row,
+                      mi_col, bsize, tx_size, frame->ref_frame, predictor,
+                      &recon_error, &rate_cost, &sse, &ref_frame_idx);
 
       tpl_store_before_propagation(
           tpl_frame_stats_before_propagation->block_stats_list,
           tpl_frame->tpl_stats_ptr, mi_row, mi_col, bsize, tpl_frame->stride,
           recon_error, sse, rate_cost, ref_frame_idx, tpl_frame->mi_rows,
           tpl_frame->mi_cols);
+    }
+  }
+}
+
+// Motion flow dependency dispenser, once the blocks of frame 'frame_idx' are
+// estimated and those of the frames referencing it are dispensed.
+static void mc_flow_dispenser(VP9_COMP *cpi, int frame_idx, BLOCK_SIZE bsize) {
+  TplDepFrame *tpl_frame = &cpi->tpl_stats[frame_idx];
+  VP9_COMMON *cm = &cpi->common;
+  const int mi_height = num_8x8_blocks_high_lookup[bsize];
+  const int mi_width = num_8x8_blocks_wide_lookup[bsize];
+  int mi_row, mi_col;
+
+  for (mi_row = 0; mi_row < cm->mi_rows; mi_row += mi_height) {
+    for (mi_col = 0; mi_col < cm->mi_cols; mi_col += mi_width) {
+      tpl_model_store(tpl_frame->tpl_stats_ptr, mi_row, mi_col, bsize,
+                      tpl_frame->stride);
 
       tpl_model_update(cpi->tpl_stats, tpl_frame->tpl_stats_ptr, mi_row, mi_col,
                        bsize);
@@ -1785,9 +1912,16 @@ void vp9_setup_tpl_stats(VP9_COMP *cpi) {
   GF_PICTURE gf_picture_buf[MAX_ARF_GOP_SIZE + REFS_PER_FRAME];
   GF_PICTURE *gf_picture = &gf_picture_buf[REFS_PER_FRAME];
   const GF_GROUP *gf_group = &cpi->twopass.gf_group;
+  VP9_COMMON *const cm = &cpi->common;
+  MACROBLOCKD *const xd = &cpi->td.mb.e_mbd;
+  const int send_tpl_gop_stats =
+      cpi->ext_ratectrl.ready &&
+      cpi->ext_ratectrl.funcs.send_tpl_gop_stats != NULL;
+  TplEstimateJobs jobs;
   int tpl_group_frames = 0;
   int frame_idx;
   int extended_frame_count;
+  int i;
   cpi->tpl_bsize = BLOCK_32X32;
 
   memset(gf_picture_buf, 0, sizeof(gf_picture_buf));
@@ -1800,18 +1934,46 @@ void vp9_setup_tpl_stats(VP9_COMP *cpi) {
                                     cpi->tpl_stats, tpl_group_frames,
                                     cpi->common.width, cpi->common.height);
 
-  // Backward propagation from tpl_group_frames to 1.
+  // Backward propagation from tpl_group_frames to 1, and intra search on the
+  // key frame for the external rate control.
+  assert(tpl_group_frames <= MAX_ARF_GOP_SIZE);
+  jobs.gf_picture = gf_picture;
+  jobs.bsize = cpi->tpl_bsize;
+  jobs.num_frames = 0;
+  jobs.rows_per_frame =
+      (cm->mi_rows + num_8x8_blocks_high_lookup[jobs.bsize] - 1) /
+      num_8x8_blocks_high_lookup[jobs.bsize];
+  vpx_atomic_init(&jobs.next_job, 0);
   for (frame_idx = tpl_group_frames - 1; frame_idx > 0; --frame_idx) {
     if (gf_picture[frame_idx].update_type == USE_BUF_FRAME) continue;
-    mc_flow_dispenser(cpi, gf_picture, frame_idx, cpi->tpl_bsize);
+    mc_flow_dispenser_init(cpi, gf_picture, frame_idx, cpi->tpl_bsize,
+                           &jobs.frames[jobs.num_frames++]);
+  }
+  if (send_tpl_gop_stats && gf_group->update_type[0] != OVERLAY_UPDATE) {
+    mc_flow_dispenser_init(cpi, gf_picture, 0, cpi->tpl_bsize,
+                           &jobs.frames[jobs.num_frames++]);
   }
 
-  if (cpi->ext_ratectrl.ready &&
-      cpi->ext_ratectrl.funcs.send_tpl_gop_stats != NULL) {
-    // Intra search on key frame
-    if (gf_group->update_type[0] != OVERLAY_UPDATE) {
-      mc_flow_dispenser(cpi, gf_picture, 0, cpi->tpl_bsize);
-    }
+  // The blocks of all frames are estimated independently, and only then are
+  // their dependencies propagated in order.
+  if (cpi->row_mt || cpi->num_workers > 1) {
+    vp9_tpl_row_mt(cpi, &jobs);
+  } else {
+    vp9_tpl_estimate_rows(cpi, &cpi->td, &jobs);
+  }
+  for (i = 0; i < jobs.num_frames; ++i) {
+    mc_flow_dispenser(cpi, jobs.frames[i].frame_idx, cpi->tpl_bsize);
+  }
+
+  // Leave cpi->td set up for the last frame, as if it had estimated it.
+  if (jobs.num_frames > 0) {
+    xd->mi = cm->mi_grid_visible;
+    xd->mi[0] = cm->mi;
+    xd->cur_buf = gf_picture[jobs.frames[jobs.num_frames - 1].frame_idx].frame;
+    vp9_frame_init_quantizer(cpi);
+  }
+
+  if (send_tpl_gop_stats) {
     // TPL stats has extra frames from next GOP. Trim those extra frames for
     // Qmode.
     trim_tpl_stats(&cpi->common.error, &cpi->tpl_gop_stats,
@@ -1837,3 +1999,38 @@ void vp9_setup_tpl_stats(VP9_COMP *cpi) {
   }
 #endif  // CONFIG_RATE_CTRL
 }
+
+int vp9_get_tpl_mv(const VP9_COMP *cpi, MV_REFERENCE_FRAME ref_frame,
+                   int mi_row, int mi_col, BLOCK_SIZE bsize, MV *mv) {
+  const VP9_COMMON *const cm = &cpi->common;
+  const TplDepFrame *tpl_frame;
+  const RefCntBuffer *ref_buf;
+  const TplDepStats *tpl_stats;
+  int rf_idx;
+
+  if (cpi->twopass.gf_group.index >= MAX_ARF_GOP_SIZE) return 0;
+  tpl_frame = &cpi->tpl_stats[cpi->twopass.gf_group.index];
+  // The stats may be left from another group of frames, or from before a
+  // resize.
+  if (!tpl_frame->is_valid || tpl_frame->mi_rows != cm->mi_rows ||
+      tpl_frame->mi_cols != cm->mi_cols ||
+      tpl_frame->frame_index !=
+          cm->buffer_pool->frame_bufs[cm->new_fb_idx].frame_index)
+    return 0;
+
+  ref_buf = get_ref_cnt_buffer(cm, get_ref_frame_buf_idx(cpi, ref_frame));
+  if (ref_buf == NULL) return 0;
+  for (rf_idx = 0; rf_idx < MAX_INTER_REF_FRAMES; ++rf_idx) {
+    if (tpl_frame->ref_frame_index[rf_idx] == ref_buf->frame_index) break;
+  }
+  if (rf_idx == MAX_INTER_REF_FRAMES) return 0;
+
+  mi_row = VPXMIN(mi_row + (num_8x8_blocks_high_lookup[bsize] >> 1),
+                  cm->mi_rows - 1);
+  mi_col = VPXMIN(mi_col + (num_8x8_blocks_wide_lookup[bsize] >> 1),
+                  cm->mi_cols - 1);
+  tpl_stats = &tpl_frame->tpl_stats_ptr[mi_row * tpl_frame->stride + mi_col];
+  if (tpl_stats->ref_mv[rf_idx].as_int == INVALID_MV) return 0;
+  *mv = tpl_stats->ref_mv[rf_idx].as_mv;
+  return 1;
+}
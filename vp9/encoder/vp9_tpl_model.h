@@ -11,6 +11,8 @@
 #ifndef VPX_VP9_ENCODER_VP9_TPL_MODEL_H_
 #define VPX_VP9_ENCODER_VP9_TPL_MODEL_H_
 
+#include "vpx_util/vpx_atomics.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -26,13 +28,44 @@ typedef struct GF_PICTURE {
   YV12_BUFFER_CONFIG *frame;
   int ref_frame[3];
   FRAME_UPDATE_TYPE update_type;
+  int frame_index;  // Display order of the frame.
 } GF_PICTURE;
 
+// A frame of the GOP whose blocks are estimated by vp9_tpl_estimate_rows().
+typedef struct TplEstimateFrame {
+  int frame_idx;
+  YV12_BUFFER_CONFIG *ref_frame[MAX_INTER_REF_FRAMES];
+  struct scale_factors sf;
+} TplEstimateFrame;
+
+// The block rows of 'frames', handed out in order to the threads running
+// vp9_tpl_estimate_rows(). The blocks do not depend on each other: the
+// dependencies between the frames are propagated once they are all estimated.
+typedef struct TplEstimateJobs {
+  GF_PICTURE *gf_picture;
+  BLOCK_SIZE bsize;
+  TplEstimateFrame frames[MAX_ARF_GOP_SIZE];
+  int num_frames;
+  int rows_per_frame;
+  vpx_atomic_int next_job;
+} TplEstimateJobs;
+
 void vp9_init_tpl_buffer(VP9_COMP *cpi);
 void vp9_setup_tpl_stats(VP9_COMP *cpi);
 void vp9_free_tpl_buffer(VP9_COMP *cpi);
 void vp9_estimate_tpl_qp_gop(VP9_COMP *cpi);
 
+// Looks up the motion the tpl model found for the block at (mi_row, mi_col) of
+// the frame being encoded against ref_frame. Returns 0 if the model did not
+// search this frame against that reference.
+int vp9_get_tpl_mv(const VP9_COMP *cpi, MV_REFERENCE_FRAME ref_frame,
+                   int mi_row, int mi_col, BLOCK_SIZE bsize, MV *mv);
+
+// Estimates the blocks of the rows taken from 'jobs' until there are none left,
+// using 'td'.
+void vp9_tpl_estimate_rows(VP9_COMP *cpi, ThreadData *td,
+                           TplEstimateJobs *jobs);
+
 void vp9_wht_fwd_txfm(int16_t *src_diff, int bw, tran_low_t *coeff,
                       TX_SIZE tx_size);
 #if CONFIG_VP9_HIGHBITDEPTH
@@ -69,6 +69,7 @@ typedef struct vp9_extracfg {
   unsigned int row_mt;
   unsigned int motion_vector_unit_test;
   int delta_q_uv;
+  unsigned int pipelined_packing;
 } vp9_extracfg;
 
 static struct vp9_extracfg default_extra_cfg = {
@@ -109,6 +110,7 @@ static struct vp9_extracfg default_extra_cfg = {
   0,                     // row_mt
   0,                     // motion_vector_unit_test
   0,                     // delta_q_uv
+  0,                     // pipelined_packing
 };
 
 struct vpx_codec_alg_priv {
@@ -277,6 +279,7 @@ static vpx_codec_err_t validate_config(vpx_codec_alg_priv_t *ctx,
         "or kf_max_dist instead.");
 
   RANGE_CHECK(extra_cfg, row_mt, 0, 1);
+  RANGE_CHECK(extra_cfg, pipelined_packing, 0, 1);
   RANGE_CHECK(extra_cfg, motion_vector_unit_test, 0, 2);
   RANGE_CHECK(extra_cfg, enable_auto_alt_ref, 0, MAX_ARF_LAYERS);
   RANGE_CHECK(extra_cfg, cpu_used, -9, 9);
@@ -343,6 +346,17 @@ static vpx_codec_err_t validate_config(vpx_codec_alg_priv_t *ctx,
       if ((int)(stats->count + 0.5) != n_packets - 1)
         ERROR("rc_twopass_stats_in missing EOS stats packet");
     }
+
+    if (cfg->rc_firstpass_mb_stats_in.buf != NULL) {
+      const size_t mb_packet_sz =
+          ((cfg->g_w + 15) >> 4) * ((cfg->g_h + 15) >> 4) * sizeof(int_mv);
+
+      if (cfg->ss_number_layers > 1 || cfg->ts_number_layers > 1)
+        ERROR("rc_firstpass_mb_stats_in is not supported with layers.");
+
+      if (cfg->rc_firstpass_mb_stats_in.sz != mb_packet_sz * (n_packets - 1))
+        ERROR("rc_firstpass_mb_stats_in does not match rc_twopass_stats_in.");
+    }
   }
 #endif  // !CONFIG_REALTIME_ONLY
 
@@ -599,6 +613,7 @@ static vpx_codec_err_t set_encoder_config(
   oxcf->sharpness = extra_cfg->sharpness;
 
   vp9_set_first_pass_stats(oxcf, &cfg->rc_twopass_stats_in);
+  oxcf->firstpass_mb_stats_in = cfg->rc_firstpass_mb_stats_in;
 
   oxcf->color_space = extra_cfg->color_space;
   oxcf->color_range = extra_cfg->color_range;
@@ -648,6 +663,8 @@ static vpx_codec_err_t set_encoder_config(
 
   oxcf->delta_q_uv = extra_cfg->delta_q_uv;
 
+  oxcf->pipelined_packing = extra_cfg->pipelined_packing;
+
   for (sl = 0; sl < oxcf->ss_number_layers; ++sl) {
     for (tl = 0; tl < oxcf->ts_number_layers; ++tl) {
       const int layer = sl * oxcf->ts_number_layers + tl;
@@ -1100,6 +1117,25 @@ static vpx_codec_err_t ctrl_set_row_mt(vpx_codec_alg_priv_t *ctx,
   return update_extra_cfg(ctx, &extra_cfg);
 }
 
+static vpx_codec_err_t ctrl_set_pipelined_packing(vpx_codec_alg_priv_t *ctx,
+                                                  va_list args) {
+  struct vp9_extracfg extra_cfg = ctx->extra_cfg;
+  extra_cfg.pipelined_packing = CAST(VP9E_SET_PIPELINED_PACKING, args);
+  return update_extra_cfg(ctx, &extra_cfg);
+}
+
+static vpx_codec_err_t ctrl_set_two_pass_chunk(vpx_codec_alg_priv_t *ctx,
+                                               va_list args) {
+  vpx_twopass_chunk_t *const chunk = va_arg(args, vpx_twopass_chunk_t *);
+
+  if (chunk) {
+    if (!vp9_set_two_pass_chunk(ctx->cpi, chunk->first_frame,
+                                chunk->num_frames))
+      return VPX_CODEC_OK;
+  }
+  return VPX_CODEC_INVALID_PARAM;
+}
+
 static vpx_codec_err_t ctrl_set_rtc_external_ratectrl(vpx_codec_alg_priv_t *ctx,
                                                       va_list args) {
   VP9_COMP *const cpi = ctx->cpi;
@@ -1327,6 +1363,17 @@ get_first_pass_stats_pkt(FIRSTPASS_STATS *stats) {
   pkt.data.twopass_stats.sz = sizeof(*stats);
   return pkt;
 }
+
+static INLINE vpx_codec_cx_pkt_t get_first_pass_mb_stats_pkt(VP9_COMP *cpi) {
+  // Like the stats packet, this points at the encoder's copy of the motion
+  // field, which stays valid until the next frame is encoded.
+  vpx_codec_cx_pkt_t pkt;
+  pkt.kind = VPX_CODEC_FPMB_STATS_PKT;
+  pkt.data.firstpass_mb_stats.buf = cpi->twopass.fp_mb_mvs;
+  pkt.data.firstpass_mb_stats.sz =
+      cpi->common.MBs * sizeof(*cpi->twopass.fp_mb_mvs);
+  return pkt;
+}
 #endif
 
 const size_t kMinCompressedSize = 8192;
@@ -1514,6 +1561,8 @@ static vpx_codec_err_t encoder_encode(vpx_codec_alg_priv_t *ctx,
         assert(ret == 0);
         fps_pkt = get_first_pass_stats_pkt(&cpi->twopass.this_frame_stats);
         vpx_codec_pkt_list_add(&ctx->pkt_list.head, &fps_pkt);
+        fps_pkt = get_first_pass_mb_stats_pkt(cpi);
+        vpx_codec_pkt_list_add(&ctx->pkt_list.head, &fps_pkt);
       } else {
         if (!cpi->twopass.first_pass_done) {
           vpx_codec_cx_pkt_t fps_pkt;
@@ -2160,6 +2209,8 @@ static vpx_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
   { VP9E_SET_RTC_EXTERNAL_RATECTRL, ctrl_set_rtc_external_ratectrl },
   { VP9E_SET_EXTERNAL_RATE_CONTROL, ctrl_set_external_rate_control },
   { VP9E_SET_QUANTIZER_ONE_PASS, ctrl_set_quantizer_one_pass },
+  { VP9E_SET_PIPELINED_PACKING, ctrl_set_pipelined_packing },
+  { VP9E_SET_TWO_PASS_CHUNK, ctrl_set_two_pass_chunk },
 
   // Getters
   { VP8E_GET_LAST_QUANTIZER, ctrl_get_quantizer },
@@ -2490,6 +2541,7 @@ void vp9_dump_encoder_config(const VP9EncoderConfig *oxcf, FILE *fp) {
   DUMP_STRUCT_VALUE(fp, oxcf, row_mt);
   DUMP_STRUCT_VALUE(fp, oxcf, motion_vector_unit_test);
   DUMP_STRUCT_VALUE(fp, oxcf, delta_q_uv);
+  DUMP_STRUCT_VALUE(fp, oxcf, pipelined_packing);
   DUMP_STRUCT_VALUE(fp, oxcf, use_simple_encode_api);
 }
 
@@ -8,6 +8,7 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -55,8 +56,39 @@ static vpx_codec_err_t decoder_init(vpx_codec_ctx_t *ctx,
   return VPX_CODEC_OK;
 }
 
+static void free_buffer_pool(BufferPool *pool) {
+  if (pool == NULL) return;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_destroy(&pool->pool_mutex);
+  pthread_cond_destroy(&pool->pool_cond);
+#endif
+  vpx_free(pool);
+}
+
+static void free_frame_workers(vpx_codec_alg_priv_t *ctx) {
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  int i;
+
+  for (i = 0; i < ctx->num_frame_workers; ++i) {
+    VPxWorker *const worker = &ctx->frame_workers[i];
+    FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
+    winterface->end(worker);
+    if (frame_worker_data != NULL) {
+      vp9_decoder_remove(frame_worker_data->pbi);
+      vpx_free(frame_worker_data->scratch_buffer);
+      vpx_free(frame_worker_data);
+    }
+  }
+  vpx_free(ctx->frame_workers);
+  ctx->frame_workers = NULL;
+  ctx->num_frame_workers = 0;
+  ctx->pbi = NULL;
+}
+
 static vpx_codec_err_t decoder_destroy(vpx_codec_alg_priv_t *ctx) {
-  if (ctx->pbi != NULL) {
+  if (ctx->frame_workers != NULL) {
+    free_frame_workers(ctx);
+  } else if (ctx->pbi != NULL) {
     vp9_decoder_remove(ctx->pbi);
   }
 
@@ -65,7 +97,7 @@ static vpx_codec_err_t decoder_destroy(vpx_codec_alg_priv_t *ctx) {
     vp9_free_internal_frame_buffers(&ctx->buffer_pool->int_frame_buffers);
   }
 
-  vpx_free(ctx->buffer_pool);
+  free_buffer_pool(ctx->buffer_pool);
   vpx_free(ctx);
   return VPX_CODEC_OK;
 }
@@ -200,13 +232,29 @@ static vpx_codec_err_t update_error_state(
   return error->error_code;
 }
 
+static void init_decoder_common(vpx_codec_alg_priv_t *ctx, VP9Decoder *pbi) {
+  VP9_COMMON *const cm = &pbi->common;
+
+  cm->new_fb_idx = INVALID_IDX;
+  cm->byte_alignment = ctx->byte_alignment;
+  cm->skip_loop_filter = ctx->skip_loop_filter || ctx->keyframe_only > 1;
+  pbi->collect_stats = ctx->collect_stats;
+}
+
 static vpx_codec_err_t init_buffer_callbacks(vpx_codec_alg_priv_t *ctx) {
   VP9_COMMON *const cm = &ctx->pbi->common;
   BufferPool *const pool = cm->buffer_pool;
 
-  cm->new_fb_idx = INVALID_IDX;
-  cm->byte_alignment = ctx->byte_alignment;
-  cm->skip_loop_filter = ctx->skip_loop_filter;
+  if (ctx->frame_workers != NULL) {
+    int i;
+    for (i = 0; i < ctx->num_frame_workers; ++i) {
+      const FrameWorkerData *const frame_worker_data =
+          (const FrameWorkerData *)ctx->frame_workers[i].data1;
+      init_decoder_common(ctx, frame_worker_data->pbi);
+    }
+  } else {
+    init_decoder_common(ctx, ctx->pbi);
+  }
 
   if (ctx->get_ext_fb_cb != NULL && ctx->release_ext_fb_cb != NULL) {
     pool->get_fb_cb = ctx->get_ext_fb_cb;
@@ -254,27 +302,174 @@ static void set_ppflags(const vpx_codec_alg_priv_t *ctx, vp9_ppflags_t *flags) {
       ERROR(#memb " out of range [" #lo ".." #hi "]");                   \
   } while (0)
 
+static int frame_worker_hook(void *arg1, void *arg2) {
+  FrameWorkerData *const frame_worker_data = (FrameWorkerData *)arg1;
+  VP9Decoder *const pbi = frame_worker_data->pbi;
+  VP9_COMMON *const cm = &pbi->common;
+  BufferPool *const pool = cm->buffer_pool;
+  RefCntBuffer *const frame_bufs = pool->frame_bufs;
+  const uint8_t *data = frame_worker_data->data;
+  (void)arg2;
+
+  frame_worker_data->result =
+      vp9_receive_compressed_data(pbi, frame_worker_data->data_size, &data);
+  frame_worker_data->data_end = data;
+
+  lock_buffer_pool(pool);
+  frame_worker_data->output_fb_idx = -1;
+  if (frame_worker_data->result != 0) {
+    pbi->cur_buf->buf.corrupted = 1;
+  } else {
+    if (cm->show_frame && frame_worker_data->last_in_chunk) {
+      // Keep the frame until it has been output.
+      frame_worker_data->output_fb_idx = cm->new_fb_idx;
+      ++frame_bufs[cm->new_fb_idx].ref_count;
+    }
+    // Drop the hold swap_frame_buffers() left on the decoded frame.
+    decrease_ref_count(cm->new_fb_idx, frame_bufs, pool);
+  }
+
+  // Release the buffer assigned to this frame if nothing refers to it.
+  if (pbi->cur_buf->ref_count == 0 && !pbi->cur_buf->released &&
+      pbi->cur_buf->raw_frame_buffer.priv != NULL) {
+    pool->release_fb_cb(pool->cb_priv, &pbi->cur_buf->raw_frame_buffer);
+    pbi->cur_buf->released = 1;
+  }
+
+  if (pbi->hold_prev_frame_buf) {
+    decrease_ref_count((int)(cm->prev_frame - frame_bufs), frame_bufs, pool);
+    pbi->hold_prev_frame_buf = 0;
+  }
+  unlock_buffer_pool(pool);
+
+  // Unblock the frames that wait on this one, also when it failed.
+  vp9_frameworker_broadcast(pool, pbi->cur_buf, INT_MAX);
+  vp9_frameworker_signal_context_ready(pbi);
+
+  // Errors are reported through frame_worker_data->result.
+  return 1;
+}
+
+static vpx_codec_err_t init_frame_workers(vpx_codec_alg_priv_t *ctx) {
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  const int num_workers =
+      VPXMAX(1, VPXMIN((int)ctx->cfg.threads, MAX_FRAME_WORKERS));
+  int i;
+
+  ctx->frame_workers =
+      (VPxWorker *)vpx_calloc(num_workers, sizeof(*ctx->frame_workers));
+  if (ctx->frame_workers == NULL) {
+    set_error_detail(ctx, "Failed to allocate frame workers");
+    return VPX_CODEC_MEM_ERROR;
+  }
+
+  for (i = 0; i < num_workers; ++i) {
+    VPxWorker *const worker = &ctx->frame_workers[i];
+    FrameWorkerData *frame_worker_data;
+
+    winterface->init(worker);
+    worker->thread_name = "vpx frame worker";
+    ++ctx->num_frame_workers;
+
+    frame_worker_data =
+        (FrameWorkerData *)vpx_calloc(1, sizeof(*frame_worker_data));
+    if (frame_worker_data == NULL) {
+      set_error_detail(ctx, "Failed to allocate frame worker data");
+      return VPX_CODEC_MEM_ERROR;
+    }
+    worker->data1 = frame_worker_data;
+    worker->hook = frame_worker_hook;
+
+    frame_worker_data->pbi = vp9_decoder_create(ctx->buffer_pool);
+    if (frame_worker_data->pbi == NULL) {
+      set_error_detail(ctx, "Failed to allocate decoder");
+      return VPX_CODEC_MEM_ERROR;
+    }
+    // Each frame is decoded by a single thread.
+    frame_worker_data->pbi->max_threads = 1;
+    frame_worker_data->pbi->inv_tile_order = ctx->invert_tile_order;
+    frame_worker_data->pbi->frame_parallel_decode = 1;
+    frame_worker_data->pbi->frame_context_ready = 1;
+
+    if (!winterface->reset(worker)) {
+      set_error_detail(ctx, "Frame worker thread creation failed");
+      return VPX_CODEC_ERROR;
+    }
+  }
+
+  for (i = 0; i < FRAME_BUFFERS; ++i)
+    ctx->buffer_pool->frame_bufs[i].row = INT_MAX;
+
+  ctx->next_submit_worker_id = 0;
+  ctx->last_submit_worker_id = -1;
+  ctx->next_output_worker_id = 0;
+  ctx->num_busy_workers = 0;
+  ctx->output_fb_idx = -1;
+  ctx->pbi = ((FrameWorkerData *)ctx->frame_workers[0].data1)->pbi;
+  return VPX_CODEC_OK;
+}
+
 static vpx_codec_err_t init_decoder(vpx_codec_alg_priv_t *ctx) {
   vpx_codec_err_t res;
   ctx->last_show_frame = -1;
   ctx->need_resync = 1;
   ctx->flushed = 0;
 
+  RANGE_CHECK(ctx, frame_parallel_decode, 0, 1);
+
   ctx->buffer_pool = (BufferPool *)vpx_calloc(1, sizeof(BufferPool));
   if (ctx->buffer_pool == NULL) return VPX_CODEC_MEM_ERROR;
+#if CONFIG_MULTITHREAD
+  if (pthread_mutex_init(&ctx->buffer_pool->pool_mutex, NULL)) {
+    vpx_free(ctx->buffer_pool);
+    ctx->buffer_pool = NULL;
+    set_error_detail(ctx, "Failed to allocate buffer pool mutex");
+    return VPX_CODEC_MEM_ERROR;
+  }
+  if (pthread_cond_init(&ctx->buffer_pool->pool_cond, NULL)) {
+    pthread_mutex_destroy(&ctx->buffer_pool->pool_mutex);
+    vpx_free(ctx->buffer_pool);
+    ctx->buffer_pool = NULL;
+    set_error_detail(ctx, "Failed to allocate buffer pool cond");
+    return VPX_CODEC_MEM_ERROR;
+  }
+#endif
+
+  if (ctx->frame_parallel_decode) {
+    res = init_frame_workers(ctx);
+    if (res != VPX_CODEC_OK) {
+      free_frame_workers(ctx);
+      free_buffer_pool(ctx->buffer_pool);
+      ctx->buffer_pool = NULL;
+      return res;
+    }
+    res = init_buffer_callbacks(ctx);
+    if (res != VPX_CODEC_OK) {
+      free_frame_workers(ctx);
+      free_buffer_pool(ctx->buffer_pool);
+      ctx->buffer_pool = NULL;
+    }
+    return res;
+  }
 
   ctx->pbi = vp9_decoder_create(ctx->buffer_pool);
   if (ctx->pbi == NULL) {
-    vpx_free(ctx->buffer_pool);
+    free_buffer_pool(ctx->buffer_pool);
     ctx->buffer_pool = NULL;
     set_error_detail(ctx, "Failed to allocate decoder");
     return VPX_CODEC_MEM_ERROR;
   }
   ctx->pbi->max_threads = ctx->cfg.threads;
   ctx->pbi->inv_tile_order = ctx->invert_tile_order;
+  // MFQE postprocessing reads the mode info at the position of each block.
+  ctx->pbi->compact_mi = !(ctx->base.init_flags & VPX_CODEC_USE_POSTPROC);
 
   RANGE_CHECK(ctx, row_mt, 0, 1);
-  ctx->pbi->row_mt = ctx->row_mt;
+  // Tile and loop filter threads wait for each other, which could deadlock
+  // when the pool runs out of threads. Row-based jobs only wait for jobs that
+  // have already started.
+  ctx->pbi->row_mt = ctx->row_mt || ctx->thread_pool.submit != NULL;
+  ctx->pbi->thread_pool = ctx->thread_pool;
 
   RANGE_CHECK(ctx, lpf_opt, 0, 1);
   ctx->pbi->lpf_mt_opt = ctx->lpf_opt;
@@ -286,7 +481,7 @@ static vpx_codec_err_t init_decoder(vpx_codec_alg_priv_t *ctx) {
 
   res = init_buffer_callbacks(ctx);
   if (res != VPX_CODEC_OK) {
-    vpx_free(ctx->buffer_pool);
+    free_buffer_pool(ctx->buffer_pool);
     ctx->buffer_pool = NULL;
     vp9_decoder_remove(ctx->pbi);
     ctx->pbi = NULL;
@@ -302,28 +497,66 @@ static INLINE void check_resync(vpx_codec_alg_priv_t *const ctx,
     ctx->need_resync = 0;
 }
 
-static vpx_codec_err_t decode_one(vpx_codec_alg_priv_t *ctx,
-                                  const uint8_t **data, unsigned int data_sz,
-                                  void *user_priv) {
+static vpx_codec_err_t peek_first_frame(vpx_codec_alg_priv_t *ctx,
+                                        const uint8_t *data,
+                                        unsigned int data_sz) {
   // Determine the stream parameters. Note that we rely on peek_si to
   // validate that we have a buffer that does not wrap around the top
   // of the heap.
   if (!ctx->si.h) {
     int is_intra_only = 0;
     const vpx_codec_err_t res =
-        decoder_peek_si_internal(*data, data_sz, &ctx->si, &is_intra_only,
+        decoder_peek_si_internal(data, data_sz, &ctx->si, &is_intra_only,
                                  ctx->decrypt_cb, ctx->decrypt_state);
     if (res != VPX_CODEC_OK) return res;
 
     if (!ctx->si.is_kf && !is_intra_only) return VPX_CODEC_ERROR;
   }
+  return VPX_CODEC_OK;
+}
+
+// Passes the rows of the frame being decoded that are final to the put_slice
+// callback.
+static void put_slice_rows(void *priv, const YV12_BUFFER_CONFIG *buf,
+                           int start, int end) {
+  vpx_codec_alg_priv_t *const ctx = (vpx_codec_alg_priv_t *)priv;
+  const vpx_codec_priv_cb_pair_t *const cb = &ctx->base.dec.put_slice_cb;
+  vpx_image_t img;
+  vpx_image_rect_t valid, update;
+  yuvconfig2image(&img, buf, ctx->user_priv);
+  valid.x = 0;
+  valid.y = 0;
+  valid.w = img.d_w;
+  valid.h = end;
+  update = valid;
+  update.y = start;
+  update.h = end - start;
+  cb->u.put_slice(cb->user_priv, &img, &valid, &update);
+}
+
+// Slices are reported for the frame returned by decoder_get_frame(), the last
+// one of a superframe, unless it is postprocessed after decoding.
+static vpx_codec_err_t decode_one(vpx_codec_alg_priv_t *ctx,
+                                  const uint8_t **data, unsigned int data_sz,
+                                  void *user_priv, int output_frame) {
+  const vpx_codec_err_t res = peek_first_frame(ctx, *data, data_sz);
+  if (res != VPX_CODEC_OK) return res;
 
   ctx->user_priv = user_priv;
+  ctx->pbi->rows_ready_cb =
+      (output_frame && ctx->base.dec.put_slice_cb.u.put_slice != NULL &&
+       !(ctx->base.init_flags & VPX_CODEC_USE_POSTPROC))
+          ? put_slice_rows
+          : NULL;
+  ctx->pbi->rows_ready_priv = ctx;
 
   // Set these even if already initialized.  The caller may have changed the
   // decrypt config between frames.
   ctx->pbi->decrypt_cb = ctx->decrypt_cb;
   ctx->pbi->decrypt_state = ctx->decrypt_state;
+  ctx->pbi->decode_rect = ctx->decode_rect;
+  ctx->pbi->output_width = ctx->output_size[0];
+  ctx->pbi->output_height = ctx->output_size[1];
 
   if (vp9_receive_compressed_data(ctx->pbi, data_sz, data)) {
     ctx->pbi->cur_buf->buf.corrupted = 1;
@@ -337,6 +570,209 @@ static vpx_codec_err_t decode_one(vpx_codec_alg_priv_t *ctx,
   return VPX_CODEC_OK;
 }
 
+static void release_frame_buffer(vpx_codec_alg_priv_t *ctx, int fb_idx) {
+  BufferPool *const pool = ctx->buffer_pool;
+  lock_buffer_pool(pool);
+  decrease_ref_count(fb_idx, pool->frame_bufs, pool);
+  unlock_buffer_pool(pool);
+}
+
+static void add_decode_stats(vpx_decode_stats_t *dst,
+                             const vpx_decode_stats_t *src) {
+  int i;
+  dst->frame_us += src->frame_us;
+  dst->header_us += src->header_us;
+  dst->parse_us += src->parse_us;
+  dst->recon_us += src->recon_us;
+  dst->loop_filter_us += src->loop_filter_us;
+  dst->postproc_us += src->postproc_us;
+  dst->frame_wait_us += src->frame_wait_us;
+  for (i = 0; i < src->num_workers; ++i) {
+    dst->worker_busy_us[i] += src->worker_busy_us[i];
+    dst->worker_idle_us[i] += src->worker_idle_us[i];
+  }
+  dst->num_workers = VPXMAX(dst->num_workers, src->num_workers);
+}
+
+// Waits for the oldest frame in flight and queues its output, if any.
+static void sync_frame_worker(vpx_codec_alg_priv_t *ctx) {
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  VPxWorker *const worker = &ctx->frame_workers[ctx->next_output_worker_id];
+  FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
+  VP9Decoder *const pbi = frame_worker_data->pbi;
+  const uint8_t *data;
+  const uint8_t *data_end;
+
+  assert(ctx->num_busy_workers > 0);
+  winterface->sync(worker);
+  data = frame_worker_data->data_end;
+  data_end = frame_worker_data->data + frame_worker_data->data_size;
+  ctx->next_output_worker_id =
+      (ctx->next_output_worker_id + 1) % ctx->num_frame_workers;
+  --ctx->num_busy_workers;
+  ctx->pbi = pbi;
+  // The worker may start on another frame before the stats are read.
+  add_decode_stats(&ctx->frame_worker_stats, &pbi->stats);
+
+  // Each frame worker decodes exactly one frame, so apart from padding the
+  // whole chunk must have been consumed.
+  if (frame_worker_data->result == 0) {
+    while (data < data_end && *data == 0) ++data;
+    if (data < data_end) {
+      vpx_internal_error(&pbi->common.error, VPX_CODEC_UNSUP_BITSTREAM,
+                         "Frame parallel decoding requires one frame per "
+                         "chunk; use a superframe index");
+      frame_worker_data->result = -1;
+    }
+  }
+
+  if (frame_worker_data->result != 0) {
+    const struct vpx_internal_error_info *const error = &pbi->common.error;
+    // Report the first failure from the next decode call. The worker may be
+    // reused before then, so keep a copy of the message.
+    if (ctx->frame_worker_error == VPX_CODEC_OK) {
+      ctx->frame_worker_error =
+          error->error_code != VPX_CODEC_OK ? error->error_code
+                                            : VPX_CODEC_CORRUPT_FRAME;
+      snprintf(ctx->frame_worker_error_detail,
+               sizeof(ctx->frame_worker_error_detail), "%s",
+               error->has_detail ? error->detail : "Failed to decode frame");
+    }
+    ctx->need_resync = 1;
+    ctx->resync_pending = 1;
+  } else {
+    check_resync(ctx, pbi);
+  }
+
+  if (frame_worker_data->output_fb_idx >= 0) {
+    if (ctx->need_resync) {
+      release_frame_buffer(ctx, frame_worker_data->output_fb_idx);
+    } else {
+      cache_frame *entry;
+      if (ctx->num_cache_frames == FRAME_CACHE_SIZE) {
+        // The application is not retrieving frames; drop the oldest.
+        release_frame_buffer(ctx,
+                             ctx->frame_cache[ctx->frame_cache_read].fb_idx);
+        ctx->frame_cache_read = (ctx->frame_cache_read + 1) % FRAME_CACHE_SIZE;
+        --ctx->num_cache_frames;
+      }
+      entry = &ctx->frame_cache[(ctx->frame_cache_read +
+                                 ctx->num_cache_frames) %
+                                FRAME_CACHE_SIZE];
+      entry->fb_idx = frame_worker_data->output_fb_idx;
+      entry->user_priv = frame_worker_data->user_priv;
+      ++ctx->num_cache_frames;
+    }
+    frame_worker_data->output_fb_idx = -1;
+  }
+}
+
+static vpx_codec_err_t decode_one_frame_parallel(vpx_codec_alg_priv_t *ctx,
+                                                 const uint8_t **data,
+                                                 unsigned int data_sz,
+                                                 void *user_priv,
+                                                 int last_in_chunk) {
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  VPxWorker *const worker = &ctx->frame_workers[ctx->next_submit_worker_id];
+  FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
+  VP9Decoder *const pbi = frame_worker_data->pbi;
+  VP9_COMMON *const cm = &pbi->common;
+  BufferPool *const pool = ctx->buffer_pool;
+  int new_fb_idx;
+  vpx_codec_err_t res = peek_first_frame(ctx, *data, data_sz);
+  if (res != VPX_CODEC_OK) return res;
+
+  // The worker taking this frame must be idle.
+  if (ctx->num_busy_workers == ctx->num_frame_workers) sync_frame_worker(ctx);
+
+  if (frame_worker_data->scratch_buffer_size < data_sz) {
+    vpx_free(frame_worker_data->scratch_buffer);
+    frame_worker_data->scratch_buffer = (uint8_t *)vpx_malloc(data_sz);
+    if (frame_worker_data->scratch_buffer == NULL) {
+      frame_worker_data->scratch_buffer_size = 0;
+      set_error_detail(ctx, "Failed to allocate frame data");
+      return VPX_CODEC_MEM_ERROR;
+    }
+    frame_worker_data->scratch_buffer_size = data_sz;
+  }
+  // Decrypt here so the decryptor is never called from several threads.
+  if (ctx->decrypt_cb) {
+    ctx->decrypt_cb(ctx->decrypt_state, *data,
+                    frame_worker_data->scratch_buffer, data_sz);
+  } else {
+    memcpy(frame_worker_data->scratch_buffer, *data, data_sz);
+  }
+
+  // Start from the state the previous frame leaves behind. This takes a
+  // reference on the previous frame, so it must precede the search for a free
+  // buffer below.
+  if (ctx->last_submit_worker_id >= 0) {
+    const FrameWorkerData *const prev_worker_data =
+        (const FrameWorkerData *)ctx->frame_workers[ctx->last_submit_worker_id]
+            .data1;
+    vp9_frameworker_copy_context(pbi, prev_worker_data->pbi);
+  }
+
+  // Find a free frame buffer, waiting for the frames in flight to release
+  // theirs if needed.
+  for (;;) {
+    lock_buffer_pool(pool);
+    new_fb_idx = get_free_fb(cm);
+    if (new_fb_idx != INVALID_IDX) pool->frame_bufs[new_fb_idx].row = -1;
+    unlock_buffer_pool(pool);
+    if (new_fb_idx != INVALID_IDX || ctx->num_busy_workers == 0) break;
+    sync_frame_worker(ctx);
+  }
+  if (new_fb_idx == INVALID_IDX) {
+    if (pbi->hold_prev_frame_buf) {
+      release_frame_buffer(ctx, (int)(cm->prev_frame - pool->frame_bufs));
+      pbi->hold_prev_frame_buf = 0;
+    }
+    set_error_detail(ctx, "Unable to find free frame buffer");
+    return VPX_CODEC_MEM_ERROR;
+  }
+
+  if (ctx->resync_pending) {
+    pbi->need_resync = 1;
+    ctx->resync_pending = 0;
+  }
+
+  cm->new_fb_idx = new_fb_idx;
+  pbi->frame_context_ready = 0;
+  pbi->decrypt_cb = NULL;
+  pbi->decrypt_state = NULL;
+  pbi->decode_rect = ctx->decode_rect;
+  frame_worker_data->data = frame_worker_data->scratch_buffer;
+  frame_worker_data->data_size = data_sz;
+  frame_worker_data->user_priv = user_priv;
+  frame_worker_data->last_in_chunk = last_in_chunk;
+  frame_worker_data->result = 0;
+  frame_worker_data->output_fb_idx = -1;
+  vp9_zero(pbi->stats);
+  winterface->launch(worker);
+
+  ctx->last_submit_worker_id = ctx->next_submit_worker_id;
+  ctx->next_submit_worker_id =
+      (ctx->next_submit_worker_id + 1) % ctx->num_frame_workers;
+  ++ctx->num_busy_workers;
+
+  *data += data_sz;
+  return VPX_CODEC_OK;
+}
+
+// Returns 1 if the frame is to be dropped because only key frames are
+// decoded. Frames that cannot be parsed are passed on to report the error.
+static int skip_non_keyframe(const vpx_codec_alg_priv_t *ctx,
+                             const uint8_t *data, unsigned int data_sz) {
+  vpx_codec_stream_info_t si;
+  if (!ctx->keyframe_only) return 0;
+  if (decoder_peek_si_internal(data, data_sz, &si, NULL, ctx->decrypt_cb,
+                               ctx->decrypt_state) != VPX_CODEC_OK) {
+    return 0;
+  }
+  return !si.is_kf;
+}
+
 static vpx_codec_err_t decoder_decode(vpx_codec_alg_priv_t *ctx,
                                       const uint8_t *data, unsigned int data_sz,
                                       void *user_priv) {
@@ -345,6 +781,12 @@ static vpx_codec_err_t decoder_decode(vpx_codec_alg_priv_t *ctx,
   uint32_t frame_sizes[8];
   int frame_count;
 
+  // Release the frame returned by the last decoder_get_frame() call.
+  if (ctx->frame_workers != NULL && ctx->output_fb_idx >= 0) {
+    release_frame_buffer(ctx, ctx->output_fb_idx);
+    ctx->output_fb_idx = -1;
+  }
+
   if (data == NULL && data_sz == 0) {
     ctx->flushed = 1;
     return VPX_CODEC_OK;
@@ -359,6 +801,13 @@ static vpx_codec_err_t decoder_decode(vpx_codec_alg_priv_t *ctx,
     if (res != VPX_CODEC_OK) return res;
   }
 
+  // The stats cover the frames of a single call.
+  if (ctx->frame_workers != NULL) {
+    vp9_zero(ctx->frame_worker_stats);
+  } else {
+    vp9_zero(ctx->pbi->stats);
+  }
+
   res = vp9_parse_superframe_index(data, data_sz, frame_sizes, &frame_count,
                                    ctx->decrypt_cb, ctx->decrypt_state);
   if (res != VPX_CODEC_OK) return res;
@@ -379,7 +828,15 @@ static vpx_codec_err_t decoder_decode(vpx_codec_alg_priv_t *ctx,
         return VPX_CODEC_CORRUPT_FRAME;
       }
 
-      res = decode_one(ctx, &data_start_copy, frame_size, user_priv);
+      if (skip_non_keyframe(ctx, data_start, frame_size)) {
+        res = VPX_CODEC_OK;
+      } else if (ctx->frame_parallel_decode) {
+        res = decode_one_frame_parallel(ctx, &data_start_copy, frame_size,
+                                        user_priv, i == frame_count - 1);
+      } else {
+        res = decode_one(ctx, &data_start_copy, frame_size, user_priv,
+                         i == frame_count - 1);
+      }
       if (res != VPX_CODEC_OK) return res;
 
       data_start += frame_size;
@@ -388,7 +845,13 @@ static vpx_codec_err_t decoder_decode(vpx_codec_alg_priv_t *ctx,
     const uint8_t *const data_end = data + data_sz;
     while (data_start < data_end) {
       const uint32_t frame_size = (uint32_t)(data_end - data_start);
-      res = decode_one(ctx, &data_start, frame_size, user_priv);
+      if (skip_non_keyframe(ctx, data_start, frame_size)) break;
+      if (ctx->frame_parallel_decode) {
+        res = decode_one_frame_parallel(ctx, &data_start, frame_size,
+                                        user_priv, 1);
+      } else {
+        res = decode_one(ctx, &data_start, frame_size, user_priv, 1);
+      }
       if (res != VPX_CODEC_OK) return res;
 
       // Account for suboptimal termination by the encoder.
@@ -401,6 +864,13 @@ static vpx_codec_err_t decoder_decode(vpx_codec_alg_priv_t *ctx,
     }
   }
 
+  // Failures of frames decoded in parallel surface with a delay.
+  if (ctx->frame_worker_error != VPX_CODEC_OK) {
+    res = ctx->frame_worker_error;
+    ctx->frame_worker_error = VPX_CODEC_OK;
+    set_error_detail(ctx, ctx->frame_worker_error_detail);
+  }
+
   return res;
 }
 
@@ -412,17 +882,47 @@ static vpx_image_t *decoder_get_frame(vpx_codec_alg_priv_t *ctx,
   // always return only 1 frame per decode call.
   (void)iter;
 
+  if (ctx->frame_workers != NULL) {
+    // Frames still in flight are only waited for once the stream is flushed.
+    if (ctx->flushed) {
+      while (ctx->num_cache_frames == 0 && ctx->num_busy_workers > 0)
+        sync_frame_worker(ctx);
+    }
+    if (ctx->num_cache_frames > 0) {
+      const cache_frame *const entry = &ctx->frame_cache[ctx->frame_cache_read];
+      RefCntBuffer *const buf = &ctx->buffer_pool->frame_bufs[entry->fb_idx];
+      ctx->frame_cache_read = (ctx->frame_cache_read + 1) % FRAME_CACHE_SIZE;
+      --ctx->num_cache_frames;
+
+      if (ctx->output_fb_idx >= 0) {
+        release_frame_buffer(ctx, ctx->output_fb_idx);
+      }
+      ctx->output_fb_idx = entry->fb_idx;
+      ctx->last_show_frame = entry->fb_idx;
+      yuvconfig2image(&ctx->img, &buf->buf, entry->user_priv);
+      ctx->img.fb_priv = buf->raw_frame_buffer.priv;
+      img = &ctx->img;
+    }
+    return img;
+  }
+
   if (ctx->pbi != NULL) {
     YV12_BUFFER_CONFIG sd;
     vp9_ppflags_t flags = { 0, 0, 0 };
-    if (ctx->base.init_flags & VPX_CODEC_USE_POSTPROC) set_ppflags(ctx, &flags);
+    if ((ctx->base.init_flags & VPX_CODEC_USE_POSTPROC) &&
+        ctx->keyframe_only < 2) {
+      set_ppflags(ctx, &flags);
+    }
     if (vp9_get_raw_frame(ctx->pbi, &sd, &flags) == 0) {
       VP9_COMMON *const cm = &ctx->pbi->common;
       RefCntBuffer *const frame_bufs = cm->buffer_pool->frame_bufs;
       ctx->last_show_frame = ctx->pbi->common.new_fb_idx;
       if (ctx->need_resync) return NULL;
       yuvconfig2image(&ctx->img, &sd, ctx->user_priv);
-      ctx->img.fb_priv = frame_bufs[cm->new_fb_idx].raw_frame_buffer.priv;
+      // A scaled frame is not held in a frame buffer of the application.
+      ctx->img.fb_priv = ctx->pbi->scale_output
+                             ? NULL
+                             : frame_bufs[cm->new_fb_idx].raw_frame_buffer.priv;
       img = &ctx->img;
       return img;
     }
@@ -451,6 +951,11 @@ static vpx_codec_err_t ctrl_set_reference(vpx_codec_alg_priv_t *ctx,
                                           va_list args) {
   vpx_ref_frame_t *const data = va_arg(args, vpx_ref_frame_t *);
 
+  if (ctx->frame_workers != NULL) {
+    set_error_detail(ctx, "Not supported in frame parallel decode");
+    return VPX_CODEC_INCAPABLE;
+  }
+
   if (data) {
     vpx_ref_frame_t *const frame = (vpx_ref_frame_t *)data;
     YV12_BUFFER_CONFIG sd;
@@ -466,6 +971,11 @@ static vpx_codec_err_t ctrl_copy_reference(vpx_codec_alg_priv_t *ctx,
                                            va_list args) {
   vpx_ref_frame_t *data = va_arg(args, vpx_ref_frame_t *);
 
+  if (ctx->frame_workers != NULL) {
+    set_error_detail(ctx, "Not supported in frame parallel decode");
+    return VPX_CODEC_INCAPABLE;
+  }
+
   if (data) {
     vpx_ref_frame_t *frame = (vpx_ref_frame_t *)data;
     YV12_BUFFER_CONFIG sd;
@@ -546,7 +1056,11 @@ static vpx_codec_err_t ctrl_get_frame_corrupted(vpx_codec_alg_priv_t *ctx,
   if (corrupted) {
     if (ctx->pbi != NULL) {
       RefCntBuffer *const frame_bufs = ctx->pbi->common.buffer_pool->frame_bufs;
-      if (ctx->pbi->common.frame_to_show == NULL) return VPX_CODEC_ERROR;
+      // In frame parallel decode ctx->pbi may not have finished a frame yet;
+      // the status is that of the last frame returned, if any.
+      if (ctx->frame_workers == NULL &&
+          ctx->pbi->common.frame_to_show == NULL)
+        return VPX_CODEC_ERROR;
       if (ctx->last_show_frame >= 0)
         *corrupted = frame_bufs[ctx->last_show_frame].buf.corrupted;
       return VPX_CODEC_OK;
@@ -576,6 +1090,17 @@ static vpx_codec_err_t ctrl_get_frame_size(vpx_codec_alg_priv_t *ctx,
   return VPX_CODEC_INVALID_PARAM;
 }
 
+static vpx_codec_err_t ctrl_get_decode_stats(vpx_codec_alg_priv_t *ctx,
+                                             va_list args) {
+  vpx_decode_stats_t *const stats = va_arg(args, vpx_decode_stats_t *);
+
+  if (stats == NULL) return VPX_CODEC_INVALID_PARAM;
+  if (ctx->pbi == NULL) return VPX_CODEC_ERROR;
+  *stats = ctx->frame_workers != NULL ? ctx->frame_worker_stats
+                                      : ctx->pbi->stats;
+  return VPX_CODEC_OK;
+}
+
 static vpx_codec_err_t ctrl_get_render_size(vpx_codec_alg_priv_t *ctx,
                                             va_list args) {
   int *const render_size = va_arg(args, int *);
@@ -639,20 +1164,68 @@ static vpx_codec_err_t ctrl_set_byte_alignment(vpx_codec_alg_priv_t *ctx,
     return VPX_CODEC_INVALID_PARAM;
 
   ctx->byte_alignment = byte_alignment;
-  if (ctx->pbi != NULL) {
+  if (ctx->frame_workers != NULL) {
+    int i;
+    for (i = 0; i < ctx->num_frame_workers; ++i) {
+      FrameWorkerData *const frame_worker_data =
+          (FrameWorkerData *)ctx->frame_workers[i].data1;
+      frame_worker_data->pbi->common.byte_alignment = byte_alignment;
+    }
+  } else if (ctx->pbi != NULL) {
     ctx->pbi->common.byte_alignment = byte_alignment;
   }
   return VPX_CODEC_OK;
 }
 
+static void update_skip_loop_filter(vpx_codec_alg_priv_t *ctx) {
+  const int skip_loop_filter =
+      ctx->skip_loop_filter || ctx->keyframe_only > 1;
+
+  if (ctx->frame_workers != NULL) {
+    int i;
+    for (i = 0; i < ctx->num_frame_workers; ++i) {
+      FrameWorkerData *const frame_worker_data =
+          (FrameWorkerData *)ctx->frame_workers[i].data1;
+      frame_worker_data->pbi->common.skip_loop_filter = skip_loop_filter;
+    }
+  } else if (ctx->pbi != NULL) {
+    ctx->pbi->common.skip_loop_filter = skip_loop_filter;
+  }
+}
+
 static vpx_codec_err_t ctrl_set_skip_loop_filter(vpx_codec_alg_priv_t *ctx,
                                                  va_list args) {
   ctx->skip_loop_filter = va_arg(args, int);
+  update_skip_loop_filter(ctx);
 
-  if (ctx->pbi != NULL) {
-    ctx->pbi->common.skip_loop_filter = ctx->skip_loop_filter;
-  }
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_set_keyframe_only(vpx_codec_alg_priv_t *ctx,
+                                              va_list args) {
+  const int keyframe_only = va_arg(args, int);
+
+  if (keyframe_only < 0 || keyframe_only > 2) return VPX_CODEC_INVALID_PARAM;
+  ctx->keyframe_only = keyframe_only;
+  update_skip_loop_filter(ctx);
+
+  return VPX_CODEC_OK;
+}
 
+static vpx_codec_err_t ctrl_set_collect_stats(vpx_codec_alg_priv_t *ctx,
+                                              va_list args) {
+  ctx->collect_stats = va_arg(args, int) != 0;
+
+  if (ctx->frame_workers != NULL) {
+    int i;
+    for (i = 0; i < ctx->num_frame_workers; ++i) {
+      FrameWorkerData *const frame_worker_data =
+          (FrameWorkerData *)ctx->frame_workers[i].data1;
+      frame_worker_data->pbi->collect_stats = ctx->collect_stats;
+    }
+  } else if (ctx->pbi != NULL) {
+    ctx->pbi->collect_stats = ctx->collect_stats;
+  }
   return VPX_CODEC_OK;
 }
 
@@ -673,6 +1246,15 @@ static vpx_codec_err_t ctrl_set_row_mt(vpx_codec_alg_priv_t *ctx,
   return VPX_CODEC_OK;
 }
 
+static vpx_codec_err_t ctrl_set_frame_mt(vpx_codec_alg_priv_t *ctx,
+                                         va_list args) {
+  // The mode is fixed once the decoder has been initialized.
+  if (ctx->pbi != NULL) return VPX_CODEC_ERROR;
+  ctx->frame_parallel_decode = va_arg(args, int);
+
+  return VPX_CODEC_OK;
+}
+
 static vpx_codec_err_t ctrl_enable_lpf_opt(vpx_codec_alg_priv_t *ctx,
                                            va_list args) {
   ctx->lpf_opt = va_arg(args, int);
@@ -680,6 +1262,51 @@ static vpx_codec_err_t ctrl_enable_lpf_opt(vpx_codec_alg_priv_t *ctx,
   return VPX_CODEC_OK;
 }
 
+static vpx_codec_err_t ctrl_set_thread_pool(vpx_codec_alg_priv_t *ctx,
+                                            va_list args) {
+  const vpx_thread_pool_t *const pool = va_arg(args, vpx_thread_pool_t *);
+
+  // The workers are bound to the pool when they are created.
+  if (ctx->pbi != NULL) return VPX_CODEC_ERROR;
+  if (pool != NULL && pool->submit == NULL) return VPX_CODEC_INVALID_PARAM;
+  if (pool != NULL) {
+    ctx->thread_pool = *pool;
+  } else {
+    vp9_zero(ctx->thread_pool);
+  }
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_set_decode_region(vpx_codec_alg_priv_t *ctx,
+                                              va_list args) {
+  const vpx_image_rect_t *const rect = va_arg(args, vpx_image_rect_t *);
+
+  if (rect != NULL) {
+    ctx->decode_rect = *rect;
+  } else {
+    memset(&ctx->decode_rect, 0, sizeof(ctx->decode_rect));
+  }
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_set_output_size(vpx_codec_alg_priv_t *ctx,
+                                            va_list args) {
+  const int *const size = va_arg(args, int *);
+
+  if (ctx->frame_parallel_decode ||
+      (ctx->base.init_flags & VPX_CODEC_USE_POSTPROC)) {
+    return VPX_CODEC_INCAPABLE;
+  }
+  if (size != NULL) {
+    if (size[0] < 0 || size[1] < 0) return VPX_CODEC_INVALID_PARAM;
+    ctx->output_size[0] = size[0];
+    ctx->output_size[1] = size[1];
+  } else {
+    ctx->output_size[0] = ctx->output_size[1] = 0;
+  }
+  return VPX_CODEC_OK;
+}
+
 static vpx_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { VP8_COPY_REFERENCE, ctrl_copy_reference },
 
@@ -693,6 +1320,12 @@ static vpx_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { VP9_DECODE_SVC_SPATIAL_LAYER, ctrl_set_spatial_layer_svc },
   { VP9D_SET_ROW_MT, ctrl_set_row_mt },
   { VP9D_SET_LOOP_FILTER_OPT, ctrl_enable_lpf_opt },
+  { VP9D_SET_FRAME_MT, ctrl_set_frame_mt },
+  { VP9D_SET_DECODE_REGION, ctrl_set_decode_region },
+  { VPXD_SET_KEYFRAME_ONLY, ctrl_set_keyframe_only },
+  { VP9D_SET_COLLECT_STATS, ctrl_set_collect_stats },
+  { VP9D_SET_THREAD_POOL, ctrl_set_thread_pool },
+  { VP9D_SET_OUTPUT_SIZE, ctrl_set_output_size },
 
   // Getters
   { VPXD_GET_LAST_QUANTIZER, ctrl_get_quantizer },
@@ -702,6 +1335,7 @@ static vpx_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { VP9D_GET_DISPLAY_SIZE, ctrl_get_render_size },
   { VP9D_GET_BIT_DEPTH, ctrl_get_bit_depth },
   { VP9D_GET_FRAME_SIZE, ctrl_get_frame_size },
+  { VP9D_GET_DECODE_STATS, ctrl_get_decode_stats },
 
   { -1, NULL },
 };
@@ -715,7 +1349,7 @@ CODEC_INTERFACE(vpx_codec_vp9_dx) = {
 #if CONFIG_VP9_HIGHBITDEPTH
   VPX_CODEC_CAP_HIGHBITDEPTH |
 #endif
-      VPX_CODEC_CAP_DECODER | VP9_CAP_POSTPROC |
+      VPX_CODEC_CAP_DECODER | VP9_CAP_POSTPROC | VPX_CODEC_CAP_PUT_SLICE |
       VPX_CODEC_CAP_EXTERNAL_FRAME_BUFFER,  // vpx_codec_caps_t
   decoder_init,                             // vpx_codec_init_fn_t
   decoder_destroy,                          // vpx_codec_destroy_fn_t
@@ -12,9 +12,19 @@
 #define VPX_VP9_VP9_DX_IFACE_H_
 
 #include "vp9/decoder/vp9_decoder.h"
+#include "vp9/decoder/vp9_dthread.h"
 
 typedef vpx_codec_stream_info_t vp9_stream_info_t;
 
+// Number of decoded frames that can wait to be output in frame-based
+// multi-threaded mode.
+#define FRAME_CACHE_SIZE MAX_FRAME_WORKERS
+
+typedef struct cache_frame {
+  int fb_idx;
+  void *user_priv;
+} cache_frame;
+
 struct vpx_codec_alg_priv {
   vpx_codec_priv_t base;
   vpx_codec_dec_cfg_t cfg;
@@ -32,6 +42,8 @@ struct vpx_codec_alg_priv {
   int last_show_frame;  // Index of last output frame.
   int byte_alignment;
   int skip_loop_filter;
+  int keyframe_only;  // 2 also skips the loop filter and postproc.
+  int collect_stats;
 
   int need_resync;  // wait for key/intra-only frame
   // BufferPool that holds all reference frames.
@@ -47,6 +59,27 @@ struct vpx_codec_alg_priv {
   int svc_spatial_layer;
   int row_mt;
   int lpf_opt;
+  vpx_thread_pool_t thread_pool;
+  vpx_image_rect_t decode_rect;
+  int output_size[2];  // Width and height set with VP9D_SET_OUTPUT_SIZE.
+
+  // Frame-based multi-threading. 'pbi' then points to the decoder of the
+  // frame worker that finished last.
+  int frame_parallel_decode;
+  VPxWorker *frame_workers;
+  int num_frame_workers;
+  int next_submit_worker_id;
+  int last_submit_worker_id;
+  int next_output_worker_id;
+  int num_busy_workers;
+  int resync_pending;  // restart the next submitted frame from a key frame.
+  vpx_codec_err_t frame_worker_error;
+  char frame_worker_error_detail[80];
+  cache_frame frame_cache[FRAME_CACHE_SIZE];
+  int frame_cache_read;
+  int num_cache_frames;
+  int output_fb_idx;  // frame buffer of the image last returned.
+  vpx_decode_stats_t frame_worker_stats;  // of the frame finished last.
 };
 
 #endif  // VPX_VP9_VP9_DX_IFACE_H_
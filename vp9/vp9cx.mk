@@ -48,6 +48,8 @@ VP9_CX_SRCS-yes += encoder/vp9_lookahead.h
 VP9_CX_SRCS-yes += encoder/vp9_mcomp.h
 VP9_CX_SRCS-yes += encoder/vp9_multi_thread.c
 VP9_CX_SRCS-yes += encoder/vp9_multi_thread.h
+VP9_CX_SRCS-yes += encoder/vp9_task_pool.c
+VP9_CX_SRCS-yes += encoder/vp9_task_pool.h
 VP9_CX_SRCS-yes += encoder/vp9_encoder.h
 VP9_CX_SRCS-yes += encoder/vp9_quantize.h
 VP9_CX_SRCS-yes += encoder/vp9_ratectrl.h
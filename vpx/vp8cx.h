@@ -776,6 +776,38 @@ enum vp8e_enc_control_id {
    *
    */
   VP9E_SET_QUANTIZER_ONE_PASS,
+
+  /*!\brief Codec control function to pack the tiles of a frame into the
+   * bitstream while the rest of the frame is encoded.
+   *
+   * 0 : off (default), 1 : on
+   *
+   * The frame level coding modes are then fixed before a frame is encoded and
+   * no forward probability updates are sent, which costs some compression.
+   * The output does not depend on the number of threads. Tiles are packed
+   * early when more than one thread is used, with one tile row and without
+   * segmentation.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_SET_PIPELINED_PACKING,
+
+  /*!\brief Codec control function to encode one chunk of a two pass encode.
+   *
+   * The second pass is given the first pass stats of the whole sequence in
+   * rc_twopass_stats_in, and only encodes the frames of the chunk, which
+   * starts with a key frame. The chunk gets the share of the bit budget that
+   * the whole sequence would give it, so that chunks of a sequence can be
+   * encoded at once by separate encoders and concatenated, and add up to the
+   * target bitrate of the sequence.
+   *
+   * Must be called before the first frame is encoded, once per encoder.
+   * Not supported with spatial or temporal layers, or with external rate
+   * control.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_SET_TWO_PASS_CHUNK,
 };
 
 /*!\brief vpx 1-D scaling mode
@@ -840,6 +872,17 @@ typedef struct vpx_roi_map {
   unsigned int static_threshold[4];
 } vpx_roi_map_t;
 
+/*!\brief  vpx two pass chunk
+ *
+ * The frames of a sequence that an encoder encodes in its second pass.
+ *
+ */
+
+typedef struct vpx_twopass_chunk {
+  int first_frame; /**< Index of the first frame in the first pass stats. */
+  int num_frames;  /**< Number of frames of the chunk. */
+} vpx_twopass_chunk_t;
+
 /*!\brief  vpx active region map
  *
  * These defines the data structures for active region map
@@ -1108,6 +1151,10 @@ VPX_CTRL_USE_TYPE(VP8E_SET_RTC_EXTERNAL_RATECTRL, int)
 #define VPX_CTRL_VP8E_SET_RTC_EXTERNAL_RATECTRL
 VPX_CTRL_USE_TYPE(VP9E_SET_QUANTIZER_ONE_PASS, int)
 #define VPX_CTRL_VP9E_SET_QUANTIZER_ONE_PASS
+VPX_CTRL_USE_TYPE(VP9E_SET_PIPELINED_PACKING, unsigned int)
+#define VPX_CTRL_VP9E_SET_PIPELINED_PACKING
+VPX_CTRL_USE_TYPE(VP9E_SET_TWO_PASS_CHUNK, vpx_twopass_chunk_t *)
+#define VPX_CTRL_VP9E_SET_TWO_PASS_CHUNK
 
 /*!\endcond */
 /*! @} - end defgroup vp8_encoder */
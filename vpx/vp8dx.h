@@ -158,6 +158,123 @@ enum vp8_dec_control_id {
    */
   VP9D_SET_LOOP_FILTER_OPT,
 
+  /*!\brief Codec control function to enable frame-based multi-threading.
+   *
+   * 0 : off, 1 : on
+   *
+   * When on, up to min(threads, 8) consecutive frames are decoded at the same
+   * time, each one waiting on the rows of its reference frames it predicts
+   * from. Decoded frames are returned with a delay of up to that many frames
+   * and must be drained by flushing the decoder at the end of the stream.
+   * Postprocessing is not applied in this mode. Must be set before the first
+   * frame is decoded.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_SET_FRAME_MT,
+
+  /*!\brief Codec control function to decode only part of the frames that are
+   * not used as a reference.
+   *
+   * The argument is a pointer to a vpx_image_rect_t in luma pixels of the
+   * decoded frame size. A NULL pointer or an empty rectangle restores full
+   * decoding, which is the default.
+   *
+   * On frames that do not update any reference buffer, only the tile columns
+   * the rectangle intersects, from the top of the frame down to the
+   * superblock row holding its bottom edge, are reconstructed and loop
+   * filtered. The rest of the output image is undefined. The loop filter is
+   * not applied across the edges of the decoded area, so pixels close to them
+   * may differ from a full decode; with the loop filter skipped (see
+   * VP9_SET_SKIP_LOOP_FILTER) the decoded area is identical.
+   *
+   * Frames that update a reference buffer are always decoded in full. The
+   * tiles outside of the decoded area are still parsed unless nothing later
+   * depends on them: the next frame may predict from their motion vectors and
+   * segmentation map, and they adapt the entropy context.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_SET_DECODE_REGION,
+
+  /*!\brief Codec control function to decode only the key frames.
+   *
+   * The argument is an int. With 1, every frame that is not a key frame is
+   * dropped after its header has been peeked at: it is neither allocated nor
+   * decoded and produces no output. With 2, key frames are in addition
+   * decoded without the loop filter and returned without postprocessing,
+   * which is faster but lowers their quality. 0 decodes all frames, which is
+   * the default.
+   *
+   * Frames decoded after the mode is turned off are only correct from the
+   * next key frame on. Decoding may start at any key frame of a stream.
+   *
+   * Supported in codecs: VP8, VP9
+   */
+  VPXD_SET_KEYFRAME_ONLY,
+
+  /*!\brief Codec control function to collect per-stage decoding times.
+   *
+   * The argument is an int, 1 to enable and 0 to disable (the default). The
+   * times can then be read with VP9D_GET_DECODE_STATS. Collecting them adds
+   * timer reads around each superblock and each multithreading job.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_SET_COLLECT_STATS,
+
+  /*!\brief Codec control function to get the per-stage decoding times,
+   * vpx_decode_stats_t* parameter.
+   *
+   * The times are summed over the frames decoded by the last call to
+   * vpx_codec_decode(), including the hidden frames of a superframe, and the
+   * postprocessing of vpx_codec_get_frame() since. With frame-based
+   * multithreading they are summed over the frames that finished decoding
+   * instead. VP9D_SET_COLLECT_STATS must have been enabled before, otherwise
+   * all times are 0.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_GET_DECODE_STATS,
+
+  /*!\brief Codec control function to run the decoder's threads as tasks of
+   * a thread pool of the application, vpx_thread_pool_t* parameter.
+   *
+   * Instead of starting up to vpx_codec_dec_cfg_t::threads - 1 threads of its
+   * own, the decoder submits its work to the pool, so that the pool bounds
+   * the number of threads of all decoders sharing it. A task that the pool
+   * has not started by the time the decoder needs its result is run by the
+   * thread calling the decoder, so decoding progresses even if all threads of
+   * the pool are busy. To that end multithreaded decoding uses the row-based
+   * mode of VP9D_SET_ROW_MT. vpx_codec_destroy() waits for all submitted tasks
+   * to have run.
+   *
+   * Must be set before the first frame is decoded. The pool is not used with
+   * VP9D_SET_FRAME_MT.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_SET_THREAD_POOL,
+
+  /*!\brief Codec control function to output the frames scaled down to a
+   * given size, int* parameter pointing to the width and height.
+   *
+   * Each shown frame is scaled with the 8-tap filter of vpx_scaled_2d() as
+   * its rows are reconstructed and filtered, instead of in a separate pass
+   * over the decoded frame, and vpx_codec_get_frame() and the put_slice
+   * callback then return the scaled frame. The frame is still decoded at its
+   * full size, which later frames predict from. Frames that are not 8-bit
+   * 4:2:0, smaller than the size in a dimension, or more than 4 times as
+   * large, and frames decoded in part with VP9D_SET_DECODE_REGION, are output
+   * at their full size. A size of 0x0 or a NULL pointer, the default, outputs
+   * all frames at full size.
+   *
+   * Not supported with VP9D_SET_FRAME_MT or VPX_CODEC_USE_POSTPROC.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9D_SET_OUTPUT_SIZE,
+
   VP8_DECODER_CTRL_ID_MAX
 };
 
@@ -179,6 +296,68 @@ typedef struct vpx_decrypt_init {
   void *decrypt_state;
 } vpx_decrypt_init;
 
+/*!\brief Task submitted to a vpx_thread_pool_t */
+typedef void (*vpx_thread_pool_task_fn_t)(void *task_arg);
+
+/*!\brief Thread pool of the application, see VP9D_SET_THREAD_POOL
+ *
+ * Defines the callback through which decoders queue their tasks.
+ */
+typedef struct vpx_thread_pool {
+  /*! Queues task(task_arg) to run on a thread of the pool and returns 0, or
+   *  returns non-zero if it cannot be queued. Decoders sharing the pool may
+   *  call it concurrently. */
+  int (*submit)(void *pool_priv, vpx_thread_pool_task_fn_t task,
+                void *task_arg);
+
+  /*! Passed to submit(). */
+  void *pool_priv;
+} vpx_thread_pool_t;
+
+/*!\brief Maximum number of workers reported in vpx_decode_stats_t. */
+#define VPX_DECODE_STATS_MAX_WORKERS 64
+
+/*!\brief Per-stage decoding times, see VP9D_GET_DECODE_STATS
+ *
+ * All times are in microseconds. Work spread over several threads is summed
+ * over them, so with multithreading the stage times can add up to more than
+ * frame_us. Unless row-based multithreading is used, blocks are reconstructed
+ * as soon as they are parsed and their reconstruction is counted in parse_us.
+ */
+typedef struct vpx_decode_stats {
+  /*! Wall time of decoding the frames. */
+  int64_t frame_us;
+
+  /*! Frame setup and parsing of the uncompressed and compressed headers. */
+  int64_t header_us;
+
+  /*! Entropy decoding of modes and coefficients. */
+  int64_t parse_us;
+
+  /*! Prediction and inverse transforms, when done separately from parsing. */
+  int64_t recon_us;
+
+  /*! Loop filtering. */
+  int64_t loop_filter_us;
+
+  /*! Postprocessing of the output frame in vpx_codec_get_frame(). */
+  int64_t postproc_us;
+
+  /*! Waiting for reference rows decoded by other frame workers, which is
+   *  also part of parse_us when it happens during prediction. */
+  int64_t frame_wait_us;
+
+  /*! Number of valid entries in worker_busy_us and worker_idle_us. Only
+   *  row-based multithreading reports workers, otherwise this is 0. */
+  int num_workers;
+
+  /*! Time each worker spent running jobs. */
+  int64_t worker_busy_us[VPX_DECODE_STATS_MAX_WORKERS];
+
+  /*! Time each worker spent waiting for a job. */
+  int64_t worker_idle_us[VPX_DECODE_STATS_MAX_WORKERS];
+} vpx_decode_stats_t;
+
 /*!\cond */
 /*!\brief VP8 decoder control function parameter type
  *
@@ -217,6 +396,20 @@ VPX_CTRL_USE_TYPE(VP9D_SET_ROW_MT, int)
 #define VPX_CTRL_VP9_DECODE_SET_ROW_MT
 VPX_CTRL_USE_TYPE(VP9D_SET_LOOP_FILTER_OPT, int)
 #define VPX_CTRL_VP9_SET_LOOP_FILTER_OPT
+VPX_CTRL_USE_TYPE(VP9D_SET_FRAME_MT, int)
+#define VPX_CTRL_VP9D_SET_FRAME_MT
+VPX_CTRL_USE_TYPE(VP9D_SET_DECODE_REGION, vpx_image_rect_t *)
+#define VPX_CTRL_VP9D_SET_DECODE_REGION
+VPX_CTRL_USE_TYPE(VPXD_SET_KEYFRAME_ONLY, int)
+#define VPX_CTRL_VPXD_SET_KEYFRAME_ONLY
+VPX_CTRL_USE_TYPE(VP9D_SET_COLLECT_STATS, int)
+#define VPX_CTRL_VP9D_SET_COLLECT_STATS
+VPX_CTRL_USE_TYPE(VP9D_GET_DECODE_STATS, vpx_decode_stats_t *)
+#define VPX_CTRL_VP9D_GET_DECODE_STATS
+VPX_CTRL_USE_TYPE(VP9D_SET_THREAD_POOL, vpx_thread_pool_t *)
+#define VPX_CTRL_VP9D_SET_THREAD_POOL
+VPX_CTRL_USE_TYPE(VP9D_SET_OUTPUT_SIZE, int *)
+#define VPX_CTRL_VP9D_SET_OUTPUT_SIZE
 
 /*!\endcond */
 /*! @} - end defgroup vp8_decoder */
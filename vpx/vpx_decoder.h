@@ -287,6 +287,15 @@ vpx_codec_err_t vpx_codec_register_put_frame_cb(vpx_codec_ctx_t *ctx,
  *
  * This callback is invoked by the decoder to notify the application of
  * the availability of partially decoded image data.
+ *
+ * The VP8 and VP9 decoders invoke it during vpx_codec_decode() as rows of
+ * the frame that will be output become final, from the top of the frame
+ * down, the last call covering the whole frame. \p valid covers the final
+ * rows, \p update the rows that became final since the previous call, both
+ * in luma pixels. The pixels of \p img outside \p valid may be incomplete.
+ * Calls are not made concurrently but may come from a decoder thread, and
+ * delay decoding until they return. Slices are not reported for frames that
+ * are postprocessed, or for VP9 frame parallel mode.
  */
 typedef void (*vpx_codec_put_slice_cb_fn_t)(void *user_priv,
                                             const vpx_image_t *img,
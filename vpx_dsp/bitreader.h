@@ -13,6 +13,7 @@
 
 #include <stddef.h>
 #include <stdio.h>
+#include <string.h>
 #include <limits.h>
 
 #include "./vpx_config.h"
@@ -20,6 +21,7 @@
 #include "vpx/vp8dx.h"
 #include "vpx/vpx_integer.h"
 #include "vpx_dsp/prob.h"
+#include "vpx_util/endian_inl.h"
 #if CONFIG_BITSTREAM_DEBUG
 #include "vpx_util/vpx_debug_util.h"
 #endif  // CONFIG_BITSTREAM_DEBUG
@@ -52,8 +54,34 @@ typedef struct {
 int vpx_reader_init(vpx_reader *r, const uint8_t *buffer, size_t size,
                     vpx_decrypt_cb decrypt_cb, void *decrypt_state);
 
+// Tops up 'value' with as many whole bytes as fit. Needed once 'count' drops
+// below 0, but may be called earlier as long as 'count' is at most
+// BD_VALUE_SIZE - 16.
 void vpx_reader_fill(vpx_reader *r);
 
+// Same as vpx_reader_fill(), with the common case of an unencrypted buffer
+// holding more than sizeof(BD_VALUE) bytes handled inline by a single load.
+// For callers that refill often, e.g. once per coefficient token.
+static INLINE void vpx_reader_fill_fast(vpx_reader *r) {
+  if (r->decrypt_cb == NULL &&
+      (size_t)(r->buffer_end - r->buffer) > sizeof(BD_VALUE)) {
+    const int shift = BD_VALUE_SIZE - CHAR_BIT - (r->count + CHAR_BIT);
+    const int bits = (shift & 0xfffffff8) + CHAR_BIT;
+    BD_VALUE big_endian_values;
+    memcpy(&big_endian_values, r->buffer, sizeof(BD_VALUE));
+#if SIZE_MAX == 0xffffffffffffffffULL
+    big_endian_values = HToBE64(big_endian_values);
+#else
+    big_endian_values = HToBE32(big_endian_values);
+#endif
+    r->value |= (big_endian_values >> (BD_VALUE_SIZE - bits)) << (shift & 0x7);
+    r->count += bits;
+    r->buffer += bits >> 3;
+  } else {
+    vpx_reader_fill(r);
+  }
+}
+
 const uint8_t *vpx_reader_find_end(vpx_reader *r);
 
 static INLINE int vpx_reader_has_error(vpx_reader *r) {
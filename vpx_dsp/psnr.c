@@ -161,6 +161,18 @@ int64_t vpx_get_y_sse(const YV12_BUFFER_CONFIG *a,
                  a->y_crop_width, a->y_crop_height);
 }
 
+int64_t vpx_get_y_sse_rows(const YV12_BUFFER_CONFIG *a,
+                           const YV12_BUFFER_CONFIG *b, int vstart,
+                           int height) {
+  assert(a->y_crop_width == b->y_crop_width);
+  assert(vstart >= 0 && vstart + height <= a->y_crop_height);
+  assert(vstart + height <= b->y_crop_height);
+
+  return get_sse(a->y_buffer + vstart * a->y_stride, a->y_stride,
+                 b->y_buffer + vstart * b->y_stride, b->y_stride,
+                 a->y_crop_width, height);
+}
+
 #if CONFIG_VP9_HIGHBITDEPTH
 int64_t vpx_highbd_get_y_sse(const YV12_BUFFER_CONFIG *a,
                              const YV12_BUFFER_CONFIG *b) {
@@ -172,6 +184,20 @@ int64_t vpx_highbd_get_y_sse(const YV12_BUFFER_CONFIG *a,
   return highbd_get_sse(a->y_buffer, a->y_stride, b->y_buffer, b->y_stride,
                         a->y_crop_width, a->y_crop_height);
 }
+
+int64_t vpx_highbd_get_y_sse_rows(const YV12_BUFFER_CONFIG *a,
+                                  const YV12_BUFFER_CONFIG *b, int vstart,
+                                  int height) {
+  assert(a->y_crop_width == b->y_crop_width);
+  assert(vstart >= 0 && vstart + height <= a->y_crop_height);
+  assert(vstart + height <= b->y_crop_height);
+  assert((a->flags & YV12_FLAG_HIGHBITDEPTH) != 0);
+  assert((b->flags & YV12_FLAG_HIGHBITDEPTH) != 0);
+
+  return highbd_get_sse(a->y_buffer + vstart * a->y_stride, a->y_stride,
+                        b->y_buffer + vstart * b->y_stride, b->y_stride,
+                        a->y_crop_width, height);
+}
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 
 #if CONFIG_VP9_HIGHBITDEPTH
@@ -34,9 +34,15 @@ typedef struct vpx_psnr_pkt PSNR_STATS;
  */
 double vpx_sse_to_psnr(double samples, double peak, double sse);
 int64_t vpx_get_y_sse(const YV12_BUFFER_CONFIG *a, const YV12_BUFFER_CONFIG *b);
+// Returns the SSE of the luma rows [vstart, vstart + height) of 'a' and 'b'.
+int64_t vpx_get_y_sse_rows(const YV12_BUFFER_CONFIG *a,
+                           const YV12_BUFFER_CONFIG *b, int vstart, int height);
 #if CONFIG_VP9_HIGHBITDEPTH
 int64_t vpx_highbd_get_y_sse(const YV12_BUFFER_CONFIG *a,
                              const YV12_BUFFER_CONFIG *b);
+int64_t vpx_highbd_get_y_sse_rows(const YV12_BUFFER_CONFIG *a,
+                                  const YV12_BUFFER_CONFIG *b, int vstart,
+                                  int height);
 void vpx_calc_highbd_psnr(const YV12_BUFFER_CONFIG *a,
                           const YV12_BUFFER_CONFIG *b, PSNR_STATS *psnr,
                           unsigned int bit_depth, unsigned int in_bit_depth);
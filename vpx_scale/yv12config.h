@@ -24,6 +24,12 @@ extern "C" {
 #define VP9INNERBORDERINPIXELS 96
 #define VP9_INTERP_EXTEND 4
 #define VP9_ENC_BORDER_IN_PIXELS 160
+// The VP9 decoder never extends the borders of its frames: inter prediction
+// builds the out-of-frame part of a reference block itself (see
+// dec_build_inter_predictors()). The border only has to hold the up to 24
+// pixels that blocks on the right and bottom edges of the frame overhang the
+// mode info grid, plus the few pixels SIMD filters read past a block, and is
+// rounded up to the 32 pixels the allocator requires.
 #define VP9_DEC_BORDER_IN_PIXELS 32
 
 typedef struct yv12_buffer_config {
@@ -38,6 +38,7 @@ extern "C" {
 #else
 // Use platform-specific asm barriers.
 #if defined(_MSC_VER)
+#include <intrin.h>
 // TODO(pbos): This assumes that newer versions of MSVC are building with the
 // default /volatile:ms (or older, where this is always true. Consider adding
 // support for using <atomic> instead of stdatomic.h when building C++11 under
@@ -99,6 +100,32 @@ static INLINE int vpx_atomic_load_acquire(const vpx_atomic_int *atomic) {
 #endif  // defined(VPX_USE_ATOMIC_BUILTINS)
 }
 
+// Adds 'value' and returns the previous value. This is a full memory barrier.
+static INLINE int vpx_atomic_fetch_add(vpx_atomic_int *atomic, int value) {
+#if defined(VPX_USE_ATOMIC_BUILTINS)
+  return __atomic_fetch_add(&atomic->value, value, __ATOMIC_SEQ_CST);
+#elif defined(_MSC_VER)
+  return (int)_InterlockedExchangeAdd((volatile long *)&atomic->value, value);
+#else
+  return __sync_fetch_and_add(&atomic->value, value);
+#endif  // defined(VPX_USE_ATOMIC_BUILTINS)
+}
+
+// Stores 'desired' if the current value is 'expected'. Returns 1 if the value
+// was replaced. This is a full memory barrier.
+static INLINE int vpx_atomic_compare_exchange(vpx_atomic_int *atomic,
+                                              int expected, int desired) {
+#if defined(VPX_USE_ATOMIC_BUILTINS)
+  return __atomic_compare_exchange_n(&atomic->value, &expected, desired, 0,
+                                     __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#elif defined(_MSC_VER)
+  return _InterlockedCompareExchange((volatile long *)&atomic->value, desired,
+                                     expected) == expected;
+#else
+  return __sync_bool_compare_and_swap(&atomic->value, expected, desired);
+#endif  // defined(VPX_USE_ATOMIC_BUILTINS)
+}
+
 #undef VPX_USE_ATOMIC_BUILTINS
 #undef vpx_atomic_memory_barrier
 
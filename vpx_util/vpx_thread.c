@@ -31,6 +31,10 @@ struct VPxWorkerImpl {
   pthread_mutex_t mutex_;
   pthread_cond_t condition_;
   pthread_t thread_;
+  // Only used with worker->submit: set while the launched hook has not been
+  // started, and the number of submitted tasks that have not run yet.
+  int pending_;
+  int num_submitted_;
 };
 
 //------------------------------------------------------------------------------
@@ -111,6 +115,70 @@ static void change_state(VPxWorker *const worker, VPxWorkerStatus new_status) {
   pthread_mutex_unlock(&worker->impl_->mutex_);
 }
 
+// Runs the hook launched last unless it has been started already. Called with
+// worker->impl_->mutex_ held.
+static void run_pending(VPxWorker *const worker) {
+  VPxWorkerImpl *const impl = worker->impl_;
+  if (impl->pending_) {
+    impl->pending_ = 0;
+    pthread_mutex_unlock(&impl->mutex_);
+    execute(worker);
+    pthread_mutex_lock(&impl->mutex_);
+    assert(worker->status_ == VPX_WORKER_STATUS_WORKING);
+    worker->status_ = VPX_WORKER_STATUS_OK;
+    pthread_cond_broadcast(&impl->condition_);
+  }
+}
+
+static void pool_task(void *arg) {
+  VPxWorker *const worker = (VPxWorker *)arg;
+  VPxWorkerImpl *const impl = worker->impl_;
+  pthread_mutex_lock(&impl->mutex_);
+  run_pending(worker);
+  // end() may free the worker as soon as the mutex is released.
+  --impl->num_submitted_;
+  pthread_cond_broadcast(&impl->condition_);
+  pthread_mutex_unlock(&impl->mutex_);
+}
+
+static void pool_sync(VPxWorker *const worker) {
+  VPxWorkerImpl *const impl = worker->impl_;
+  if (impl == NULL) return;
+  pthread_mutex_lock(&impl->mutex_);
+  run_pending(worker);
+  while (worker->status_ == VPX_WORKER_STATUS_WORKING) {
+    pthread_cond_wait(&impl->condition_, &impl->mutex_);
+  }
+  pthread_mutex_unlock(&impl->mutex_);
+}
+
+static void pool_launch(VPxWorker *const worker) {
+  VPxWorkerImpl *const impl = worker->impl_;
+  if (impl == NULL) return;
+  pool_sync(worker);
+  pthread_mutex_lock(&impl->mutex_);
+  worker->status_ = VPX_WORKER_STATUS_WORKING;
+  impl->pending_ = 1;
+  ++impl->num_submitted_;
+  pthread_mutex_unlock(&impl->mutex_);
+  if (worker->submit(worker->submit_priv, pool_task, worker)) {
+    // Not queued: the hook is run by sync().
+    pthread_mutex_lock(&impl->mutex_);
+    --impl->num_submitted_;
+    pthread_mutex_unlock(&impl->mutex_);
+  }
+}
+
+static void pool_end(VPxWorker *const worker) {
+  VPxWorkerImpl *const impl = worker->impl_;
+  pool_sync(worker);
+  pthread_mutex_lock(&impl->mutex_);
+  while (impl->num_submitted_ > 0) {
+    pthread_cond_wait(&impl->condition_, &impl->mutex_);
+  }
+  pthread_mutex_unlock(&impl->mutex_);
+}
+
 #endif  // CONFIG_MULTITHREAD
 
 //------------------------------------------------------------------------------
@@ -122,7 +190,11 @@ static void init(VPxWorker *const worker) {
 
 static int sync(VPxWorker *const worker) {
 #if CONFIG_MULTITHREAD
-  change_state(worker, VPX_WORKER_STATUS_OK);
+  if (worker->submit != NULL) {
+    pool_sync(worker);
+  } else {
+    change_state(worker, VPX_WORKER_STATUS_OK);
+  }
 #endif
   assert(worker->status_ <= VPX_WORKER_STATUS_OK);
   return !worker->had_error;
@@ -144,6 +216,10 @@ static int reset(VPxWorker *const worker) {
       pthread_mutex_destroy(&worker->impl_->mutex_);
       goto Error;
     }
+    if (worker->submit != NULL) {
+      worker->status_ = VPX_WORKER_STATUS_OK;
+      return 1;
+    }
     pthread_mutex_lock(&worker->impl_->mutex_);
     ok = !pthread_create(&worker->impl_->thread_, NULL, thread_loop, worker);
     if (ok) worker->status_ = VPX_WORKER_STATUS_OK;
@@ -174,7 +250,11 @@ static void execute(VPxWorker *const worker) {
 
 static void launch(VPxWorker *const worker) {
 #if CONFIG_MULTITHREAD
-  change_state(worker, VPX_WORKER_STATUS_WORKING);
+  if (worker->submit != NULL) {
+    pool_launch(worker);
+  } else {
+    change_state(worker, VPX_WORKER_STATUS_WORKING);
+  }
 #else
   execute(worker);
 #endif
@@ -183,8 +263,13 @@ static void launch(VPxWorker *const worker) {
 static void end(VPxWorker *const worker) {
 #if CONFIG_MULTITHREAD
   if (worker->impl_ != NULL) {
-    change_state(worker, VPX_WORKER_STATUS_NOT_OK);
-    pthread_join(worker->impl_->thread_, NULL);
+    if (worker->submit != NULL) {
+      pool_end(worker);
+      worker->status_ = VPX_WORKER_STATUS_NOT_OK;
+    } else {
+      change_state(worker, VPX_WORKER_STATUS_NOT_OK);
+      pthread_join(worker->impl_->thread_, NULL);
+    }
     pthread_mutex_destroy(&worker->impl_->mutex_);
     pthread_cond_destroy(&worker->impl_->condition_);
     vpx_free(worker->impl_);
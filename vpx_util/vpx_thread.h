@@ -31,6 +31,10 @@ typedef enum {
 // in case of error.
 typedef int (*VPxWorkerHook)(void *, void *);
 
+// Queues task(task_arg) on an external thread pool. Returns 0 on success.
+typedef int (*VPxWorkerSubmitFn)(void *priv, void (*task)(void *),
+                                 void *task_arg);
+
 // Platform-dependent implementation details for the worker.
 typedef struct VPxWorkerImpl VPxWorkerImpl;
 
@@ -46,6 +50,13 @@ typedef struct {
   void *data1;         // first argument passed to 'hook'
   void *data2;         // second argument passed to 'hook'
   int had_error;       // true if a call to 'hook' returned false
+  // If set before reset(), the worker does not own a thread: launch() submits
+  // the hook as a task to an external pool instead. A task that has not
+  // started by the time of sync() is run by the caller of sync(), so hooks
+  // must only wait for work that has already started. end() waits for all
+  // submitted tasks to have run.
+  VPxWorkerSubmitFn submit;
+  void *submit_priv;
 } VPxWorker;
 
 // The interface for all thread-worker related functions. All these functions
@@ -77,7 +77,19 @@ static const arg_def_t outputfile =
 static const arg_def_t threadsarg =
     ARG_DEF("t", "threads", 1, "Max threads to use");
 static const arg_def_t frameparallelarg =
-    ARG_DEF(NULL, "frame-parallel", 0, "Frame parallel decode (ignored)");
+    ARG_DEF(NULL, "frame-parallel", 0,
+            "Frame parallel decode (VP9 only, implies no postproc)");
+static const arg_def_t decoderegionarg =
+    ARG_DEF(NULL, "decode-region", 1,
+            "Only decode x,y,w,h of non-reference frames (VP9 only)");
+static const arg_def_t outputsizearg =
+    ARG_DEF(NULL, "output-size", 1,
+            "Scale frames down to w,h while decoding (VP9 only)");
+static const arg_def_t keyframeonlyarg =
+    ARG_DEF(NULL, "keyframes-only", 1,
+            "Only decode key frames (2: also skip loopfilter and postproc)");
+static const arg_def_t decodestatsarg =
+    ARG_DEF(NULL, "decode-stats", 0, "Show per-stage decode times (VP9 only)");
 static const arg_def_t verbosearg =
     ARG_DEF("v", "verbose", 0, "Show version string");
 static const arg_def_t error_concealment =
@@ -119,6 +131,10 @@ static const arg_def_t *all_args[] = { &help,
                                        &outputfile,
                                        &threadsarg,
                                        &frameparallelarg,
+                                       &decoderegionarg,
+                                       &outputsizearg,
+                                       &keyframeonlyarg,
+                                       &decodestatsarg,
                                        &verbosearg,
                                        &scalearg,
                                        &fb_arg,
@@ -355,6 +371,38 @@ static int file_is_raw(struct VpxInputContext *input) {
   return is_raw;
 }
 
+static void add_decode_stats(vpx_decode_stats_t *total,
+                             const vpx_decode_stats_t *stats) {
+  int i;
+  total->frame_us += stats->frame_us;
+  total->header_us += stats->header_us;
+  total->parse_us += stats->parse_us;
+  total->recon_us += stats->recon_us;
+  total->loop_filter_us += stats->loop_filter_us;
+  total->postproc_us += stats->postproc_us;
+  total->frame_wait_us += stats->frame_wait_us;
+  for (i = 0; i < stats->num_workers; ++i) {
+    total->worker_busy_us[i] += stats->worker_busy_us[i];
+    total->worker_idle_us[i] += stats->worker_idle_us[i];
+  }
+  if (stats->num_workers > total->num_workers)
+    total->num_workers = stats->num_workers;
+}
+
+static void show_decode_stats(const vpx_decode_stats_t *stats) {
+  int i;
+  fprintf(stderr,
+          "Decode time %" PRId64 " us: headers %" PRId64 ", parse %" PRId64
+          ", recon %" PRId64 ", loop filter %" PRId64 ", postproc %" PRId64
+          ", frame waits %" PRId64 "\n",
+          stats->frame_us, stats->header_us, stats->parse_us, stats->recon_us,
+          stats->loop_filter_us, stats->postproc_us, stats->frame_wait_us);
+  for (i = 0; i < stats->num_workers; ++i) {
+    fprintf(stderr, "Worker %d: busy %" PRId64 " us, idle %" PRId64 " us\n", i,
+            stats->worker_busy_us[i], stats->worker_idle_us[i]);
+  }
+}
+
 static void show_progress(int frame_in, int frame_out, uint64_t dx_time) {
   fprintf(stderr,
           "%d decoded frames/%d showed frames in %" PRId64 " us (%.2f fps)\r",
@@ -530,6 +578,12 @@ static int main_loop(int argc, const char **argv_) {
   int keep_going = 0;
   int enable_row_mt = 0;
   int enable_lpf_opt = 0;
+  int frame_parallel = 0;
+  vpx_image_rect_t decode_region = { 0, 0, 0, 0 };
+  int output_size[2] = { 0, 0 };
+  int keyframe_only = 0;
+  int decode_stats = 0;
+  vpx_decode_stats_t total_stats;
   const VpxInterface *interface = NULL;
   const VpxInterface *fourcc_interface = NULL;
   uint64_t dx_time = 0;
@@ -629,10 +683,21 @@ static int main_loop(int argc, const char **argv_) {
     else if (arg_match(&arg, &threadsarg, argi))
       cfg.threads = arg_parse_uint(&arg);
 #if CONFIG_VP9_DECODER
-    else if (arg_match(&arg, &frameparallelarg, argi)) {
-      /* ignored for compatibility */
+    else if (arg_match(&arg, &frameparallelarg, argi))
+      frame_parallel = 1;
+    else if (arg_match(&arg, &decoderegionarg, argi)) {
+      if (sscanf(arg.val, "%u,%u,%u,%u", &decode_region.x, &decode_region.y,
+                 &decode_region.w, &decode_region.h) != 4)
+        die("Error: --decode-region expects x,y,w,h.\n");
+    } else if (arg_match(&arg, &outputsizearg, argi)) {
+      if (sscanf(arg.val, "%d,%d", &output_size[0], &output_size[1]) != 2)
+        die("Error: --output-size expects w,h.\n");
+    } else if (arg_match(&arg, &decodestatsarg, argi)) {
+      decode_stats = 1;
     }
 #endif
+    else if (arg_match(&arg, &keyframeonlyarg, argi))
+      keyframe_only = arg_parse_uint(&arg);
     else if (arg_match(&arg, &verbosearg, argi))
       quiet = 0;
     else if (arg_match(&arg, &scalearg, argi))
@@ -797,6 +862,37 @@ static int main_loop(int argc, const char **argv_) {
             vpx_codec_error(&decoder));
     goto fail;
   }
+  if (interface->fourcc == VP9_FOURCC &&
+      vpx_codec_control(&decoder, VP9D_SET_FRAME_MT, frame_parallel)) {
+    fprintf(stderr, "Failed to set decoder in frame parallel mode: %s\n",
+            vpx_codec_error(&decoder));
+    goto fail;
+  }
+  if (interface->fourcc == VP9_FOURCC &&
+      vpx_codec_control(&decoder, VP9D_SET_DECODE_REGION, &decode_region)) {
+    fprintf(stderr, "Failed to set decode region: %s\n",
+            vpx_codec_error(&decoder));
+    goto fail;
+  }
+  if (output_size[0] && output_size[1] && interface->fourcc == VP9_FOURCC &&
+      vpx_codec_control(&decoder, VP9D_SET_OUTPUT_SIZE, output_size)) {
+    fprintf(stderr, "Failed to set output size: %s\n",
+            vpx_codec_error(&decoder));
+    goto fail;
+  }
+  if (keyframe_only &&
+      vpx_codec_control(&decoder, VPXD_SET_KEYFRAME_ONLY, keyframe_only)) {
+    fprintf(stderr, "Failed to set keyframe only mode: %s\n",
+            vpx_codec_error(&decoder));
+    goto fail;
+  }
+  memset(&total_stats, 0, sizeof(total_stats));
+  if (decode_stats && interface->fourcc == VP9_FOURCC &&
+      vpx_codec_control(&decoder, VP9D_SET_COLLECT_STATS, 1)) {
+    fprintf(stderr, "Failed to enable decode stats: %s\n",
+            vpx_codec_error(&decoder));
+    goto fail;
+  }
   if (!quiet) fprintf(stderr, "%s\n", decoder.name);
 
 #if CONFIG_VP8_DECODER
@@ -900,6 +996,16 @@ static int main_loop(int argc, const char **argv_) {
     vpx_usec_timer_mark(&timer);
     dx_time += (unsigned int)vpx_usec_timer_elapsed(&timer);
 
+    if (decode_stats && interface->fourcc == VP9_FOURCC) {
+      vpx_decode_stats_t stats;
+      if (vpx_codec_control(&decoder, VP9D_GET_DECODE_STATS, &stats)) {
+        warn("Failed VP9D_GET_DECODE_STATS: %s", vpx_codec_error(&decoder));
+        if (!keep_going) goto fail;
+      } else {
+        add_decode_stats(&total_stats, &stats);
+      }
+    }
+
     if (!corrupted &&
         vpx_codec_control(&decoder, VP8D_GET_FRAME_CORRUPTED, &corrupted)) {
       warn("Failed VP8_GET_FRAME_CORRUPTED: %s", vpx_codec_error(&decoder));
@@ -1003,11 +1109,13 @@ static int main_loop(int argc, const char **argv_) {
             goto fail;
           }
           if (frame_out == 1) {
-            // Y4M file header
+            // Y4M file header. Frames scaled while decoding have the size of
+            // the first one.
             len = y4m_write_file_header(
-                y4m_buf, sizeof(y4m_buf), vpx_input_ctx.width,
-                vpx_input_ctx.height, &vpx_input_ctx.framerate, img->fmt,
-                img->bit_depth);
+                y4m_buf, sizeof(y4m_buf),
+                output_size[0] ? img->d_w : vpx_input_ctx.width,
+                output_size[0] ? img->d_h : vpx_input_ctx.height,
+                &vpx_input_ctx.framerate, img->fmt, img->bit_depth);
             if (do_md5) {
               MD5Update(&md5_ctx, (md5byte *)y4m_buf, (unsigned int)len);
             } else {
@@ -1070,6 +1178,7 @@ static int main_loop(int argc, const char **argv_) {
     show_progress(frame_in, frame_out, dx_time);
     fprintf(stderr, "\n");
   }
+  if (decode_stats) show_decode_stats(&total_stats);
 
   if (frames_corrupted) {
     fprintf(stderr, "WARNING: %d frames corrupted.\n", frames_corrupted);
@@ -116,6 +116,8 @@ static const arg_def_t pass_arg =
     ARG_DEF(NULL, "pass", 1, "Pass to execute (1/2)");
 static const arg_def_t fpf_name =
     ARG_DEF(NULL, "fpf", 1, "First pass statistics file name");
+static const arg_def_t fpmbf_name =
+    ARG_DEF(NULL, "fpmbf", 1, "First pass block statistics file name");
 static const arg_def_t limit =
     ARG_DEF(NULL, "limit", 1, "Stop encoding after n input frames");
 static const arg_def_t skip =
@@ -174,6 +176,7 @@ static const arg_def_t *main_args[] = { &help,
                                         &passes,
                                         &pass_arg,
                                         &fpf_name,
+                                        &fpmbf_name,
                                         &limit,
                                         &skip,
                                         &deadline,
@@ -534,6 +537,11 @@ static const arg_def_t disable_loopfilter =
             "1: Loopfilter off for non reference frames\n"
             "                                          "
             "2: Loopfilter off for all frames");
+
+static const arg_def_t pipelined_packing =
+    ARG_DEF(NULL, "pipelined-packing", 1,
+            "Pack tiles while the rest of the frame is encoded, without "
+            "forward probability updates (0: off (default), 1: on)");
 #endif
 
 #if CONFIG_VP9_ENCODER
@@ -566,6 +574,7 @@ static const arg_def_t *vp9_args[] = { &cpu_used_vp9,
                                        &target_level,
                                        &row_mt,
                                        &disable_loopfilter,
+                                       &pipelined_packing,
 // NOTE: The entries above have a corresponding entry in vp9_arg_ctrl_map. The
 // entries below do not have a corresponding entry in vp9_arg_ctrl_map. They
 // must be listed at the end of vp9_args.
@@ -603,6 +612,7 @@ static const int vp9_arg_ctrl_map[] = { VP8E_SET_CPUUSED,
                                         VP9E_SET_TARGET_LEVEL,
                                         VP9E_SET_ROW_MT,
                                         VP9E_SET_DISABLE_LOOPFILTER,
+                                        VP9E_SET_PIPELINED_PACKING,
                                         0 };
 #endif
 
@@ -680,6 +690,7 @@ struct stream_config {
   struct vpx_codec_enc_cfg cfg;
   const char *out_fn;
   const char *stats_fn;
+  const char *fpmb_stats_fn;
   stereo_format_t stereo_fmt;
   int arg_ctrls[ARG_CTRL_CNT_MAX][2];
   int arg_ctrl_cnt;
@@ -707,6 +718,7 @@ struct stream_state {
   uint64_t cx_time;
   size_t nbytes;
   stats_io_t stats;
+  stats_io_t fpmb_stats;
   struct vpx_image *img;
   vpx_codec_ctx_t decoder;
   int mismatch_seen;
@@ -943,6 +955,8 @@ static int parse_stream_params(struct VpxEncoderConfig *global,
       config->out_fn = arg.val;
     } else if (arg_match(&arg, &fpf_name, argi)) {
       config->stats_fn = arg.val;
+    } else if (arg_match(&arg, &fpmbf_name, argi)) {
+      config->fpmb_stats_fn = arg.val;
     } else if (arg_match(&arg, &use_webm, argi)) {
 #if CONFIG_WEBM_IO
       config->write_webm = 1;
@@ -1323,11 +1337,21 @@ static void setup_pass(struct stream_state *stream,
       fatal("Failed to open statistics store");
   }
 
+  if (stream->config.fpmb_stats_fn) {
+    if (!stats_open_file(&stream->fpmb_stats, stream->config.fpmb_stats_fn,
+                         pass))
+      fatal("Failed to open first pass block statistics store");
+  }
+
   stream->config.cfg.g_pass = global->passes == 2
                                   ? pass ? VPX_RC_LAST_PASS : VPX_RC_FIRST_PASS
                                   : VPX_RC_ONE_PASS;
   if (pass) {
     stream->config.cfg.rc_twopass_stats_in = stats_get(&stream->stats);
+    if (stream->config.fpmb_stats_fn) {
+      stream->config.cfg.rc_firstpass_mb_stats_in =
+          stats_get(&stream->fpmb_stats);
+    }
   }
 
   stream->cx_time = 0;
@@ -1539,6 +1563,12 @@ static void get_cx_data(struct stream_state *stream,
                     pkt->data.twopass_stats.sz);
         stream->nbytes += pkt->data.raw.sz;
         break;
+      case VPX_CODEC_FPMB_STATS_PKT:
+        if (stream->config.fpmb_stats_fn) {
+          stats_write(&stream->fpmb_stats, pkt->data.firstpass_mb_stats.buf,
+                      pkt->data.firstpass_mb_stats.sz);
+        }
+        break;
       case VPX_CODEC_PSNR_PKT:
 
         if (global->show_psnr) {
@@ -2035,6 +2065,10 @@ int main(int argc, const char **argv_) {
     FOREACH_STREAM(close_output_file(stream, global.codec->fourcc));
 
     FOREACH_STREAM(stats_close(&stream->stats, global.passes - 1));
+    FOREACH_STREAM({
+      if (stream->config.fpmb_stats_fn)
+        stats_close(&stream->fpmb_stats, global.passes - 1);
+    });
 
     if (global.pass) break;
   }
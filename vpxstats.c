@@ -16,9 +16,17 @@
 
 #include "./tools_common.h"
 
+#if HAVE_UNISTD_H && !defined(_WIN32)
+#define USE_POSIX_MMAP 1
+#include <sys/mman.h>
+#else
+#define USE_POSIX_MMAP 0
+#endif
+
 int stats_open_file(stats_io_t *stats, const char *fpf, int pass) {
   int res;
   stats->pass = pass;
+  stats->mapped = 0;
 
   if (pass == 0) {
     stats->file = fopen(fpf, "wb");
@@ -38,6 +46,20 @@ int stats_open_file(stats_io_t *stats, const char *fpf, int pass) {
     stats->buf.sz = stats->buf_alloc_sz = ftell(stats->file);
     rewind(stats->file);
 
+#if USE_POSIX_MMAP
+    // Map the file rather than reading it, so that the pages of the stats
+    // are only loaded as the encoder gets to them and can be dropped again.
+    if (stats->buf.sz > 0) {
+      void *const map = mmap(NULL, stats->buf.sz, PROT_READ, MAP_PRIVATE,
+                             fileno(stats->file), 0);
+      if (map != MAP_FAILED) {
+        stats->buf.buf = map;
+        stats->mapped = 1;
+        return 1;
+      }
+    }
+#endif
+
     stats->buf.buf = malloc(stats->buf_alloc_sz);
 
     if (!stats->buf.buf)
@@ -54,6 +76,7 @@ int stats_open_file(stats_io_t *stats, const char *fpf, int pass) {
 int stats_open_mem(stats_io_t *stats, int pass) {
   int res;
   stats->pass = pass;
+  stats->mapped = 0;
 
   if (!pass) {
     stats->buf.sz = 0;
@@ -69,7 +92,15 @@ int stats_open_mem(stats_io_t *stats, int pass) {
 void stats_close(stats_io_t *stats, int last_pass) {
   if (stats->file) {
     if (stats->pass == last_pass) {
+#if USE_POSIX_MMAP
+      if (stats->mapped) {
+        munmap(stats->buf.buf, stats->buf.sz);
+      } else {
+        free(stats->buf.buf);
+      }
+#else
       free(stats->buf.buf);
+#endif
     }
 
     fclose(stats->file);
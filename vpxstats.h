@@ -28,6 +28,10 @@ typedef struct {
   FILE *file;
   char *buf_ptr;
   size_t buf_alloc_sz;
+  /* Set if buf maps the stats file, which is then read by the encoder as it
+   * goes instead of being loaded into memory up front.
+   */
+  int mapped;
 } stats_io_t;
 
 int stats_open_file(stats_io_t *stats, const char *fpf, int pass);